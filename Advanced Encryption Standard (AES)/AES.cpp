@@ -7,6 +7,11 @@
 */
 
 #include "AES.h"
+#include "AESKernels.h"
+#include "GF256.h"
+#include "../Common/CpuFeatures.h"
+#include "../Common/HexCodec.h"
+#include "../Common/PerfCounters.h"
 
 
 // -------------------------------------- FINITE FIELD ARITHMETIC -------------------------------------- 
@@ -33,16 +38,7 @@ uint8_t AES::ffAdd(uint8_t a, uint8_t b)
 */
 uint8_t AES::xtime(uint8_t byte)
 {
-    uint8_t result = byte << 1; // left shift by 1
-
-    // check if the most significant bit is set
-    if(byte & 0x80)
-    {
-        // XOR with the irreducible polynomial 0x1b
-        result ^= 0x1b;
-    }
-
-    return result;
+    return GF256::xtime(byte);
 }
 
 
@@ -51,36 +47,12 @@ uint8_t AES::xtime(uint8_t byte)
 /* Function: ffMultiply
  * Parameters: A multiplicand byte a, and a multiplier byte b to be multiplied in the finite field
  * Return: A byte that represents the result of the finite field multiplication
- * Description: Multiplication by higher powers of x can be implemented by repeated application of xtime(). 
- *              By adding intermediate results, multiplication by any constant can be implemented.
- *              This function multiplies two elements of a finite field by iterating through the multiplicand,
- *              if the current iteration bit is set, the indermediate sum is XOR by the current value of the multiplier
- *              Note: There is no need to prepare the values on the 7th iteration because it is the last round.
+ * Description: Every non-zero element is a power of the generator {03}, so a * b = {03}^(log a + log b). GF256 looks both
+ *              logarithms up, adds them and looks the power up, instead of the eight shift-and-add steps of repeated xtime().
 */
 uint8_t AES::ffMultiply(uint8_t a, uint8_t b)
 {
-    uint8_t sum = 0;
-
-    for(int i = 0; i < 8; i++)
-    {
-        // check if a[i] is set
-        if(a & 0x1)
-        {
-            // XOR current sum with current multiplier
-            sum ^= b;
-        }
-
-        // prepare multiplier and multiplicand for the next round
-        if(i < 7)
-        {
-            // update multiplier using xtime()
-            b = xtime(b);
-            // right shift the bits of the multiplicand by 1; this is used prepare the next iteration bit a[i+1]
-            a >>= 1;
-        }
-    }
-
-    return sum;
+    return GF256::multiply(a, b);
 }
 
 
@@ -99,7 +71,7 @@ uint8_t AES::sBoxSub(uint8_t byte)
     int row = static_cast<int>( (byte >> 4) & 0xF );
     int col = static_cast<int>( byte & 0xF );
 
-    return this->SBox[(row * 16) + col];
+    return AESTables::SBox[(row * 16) + col];
 }
 
 
@@ -158,31 +130,30 @@ uint32_t AES::subWord(uint32_t word)
 
 
 /* Function: KeyExpansion
- * Parameters: A vector of bytes that represents the cipher key, a vector of words that represends the key schedule, an integer value for the number of words in the cipher key
+ * Parameters: The cipher key, the key schedule to fill, an integer value for the number of words in the cipher key
  * Return: None
- * Description: This function generates the key schedule to be used based on the provided cipher key.
+ * Description: This function generates the key schedule to be used based on the provided cipher key. The schedule is expanded in
+ *              place in its own SecureArray, so no copy of it is left behind.
 */
-void AES::KeyExpansion(vector<uint8_t> key, vector<uint32_t> w, int Nk)
+void AES::KeyExpansion(const SecureArray<uint8_t>& key, SecureArray<uint32_t>& w, int Nk)
 {
-    for(int i = 0; i < Nk; i++)
-    {
+    PERF_SCOPE("AES::KeyExpansion");
 
+    w = SecureArray<uint32_t>(this->Nb * (this->Nr + 1));
 
-        uint32_t word = static_cast<uint32_t>( key.at( 4 * i ) ) << 24 |
-                        static_cast<uint32_t>( key.at( (4 * i) + 1 ) ) << 16 |
-                        static_cast<uint32_t>( key.at( (4 * i) + 2 ) ) << 8 |
-                        static_cast<uint32_t>( key.at( (4 * i) + 3 ) );
-        
-        //cout << "0x " << static_cast<int>(key.at( 4 * i )) << static_cast<int>(key.at( 4 * i ) +1) << static_cast<int>(key.at( 4 * i )+2) << static_cast<int>(key.at( 4 * i )+3) << endl;
-
-        w.push_back(word);
+    for(int i = 0; i < Nk; i++)
+    {
+        w[i] = static_cast<uint32_t>( key[4 * i] ) << 24 |
+               static_cast<uint32_t>( key[(4 * i) + 1] ) << 16 |
+               static_cast<uint32_t>( key[(4 * i) + 2] ) << 8 |
+               static_cast<uint32_t>( key[(4 * i) + 3] );
     }
 
 
     uint32_t temp;
     for(int i = Nk; i < this->Nb * (this->Nr + 1); i++)
     {
-        temp = w.at(i-1);
+        temp = w[i - 1];
 
         if(i % Nk == 0)
         {
@@ -193,11 +164,17 @@ void AES::KeyExpansion(vector<uint8_t> key, vector<uint32_t> w, int Nk)
             temp = subWord(temp);
         }
 
-        w.push_back(w.at(i - Nk) ^ temp);
+        w[i] = w[i - Nk] ^ temp;
     }
 
-    this->w = w;
+    this->roundKeys = SecureArray<AESState>(this->Nr + 1);
+    for(int round = 0; round <= this->Nr; round++)
+    {
+        this->roundKeys[round] = AESState::fromWords(w.data() + (round * this->Nb));
+    }
 
+    this->dw = SecureArray<uint32_t>();
+    this->invRoundKeys = SecureArray<AESState>();
 }
 
 
@@ -233,9 +210,9 @@ void AES::printKey()
 {
     cout << "--- print key ---" << endl;
     cout << "0x ";
-    for(int i = 0; i < this->key.size(); i++)
+    for(size_t i = 0; i < this->key.size(); i++)
     {
-        cout << hex << static_cast<int>(this->key.at(i)) << " ";
+        cout << hex << static_cast<int>(this->key[i]) << " ";
     }
     cout << endl;
 }
@@ -253,9 +230,9 @@ void AES::printKeySchedule()
     // TEST
     cout << "-- Key Schedule (w) --" << endl;
     int count = 0;
-    for(int i = 0; i < this->w.size(); i+=4)
+    for(size_t i = 0; i < this->w.size(); i+=4)
     {
-        cout << count << "). 0x" << hex << setw(8) << setfill('0') << static_cast<int>( this->w.at(i) ) << static_cast<int>( this->w.at(i+1) ) << static_cast<int>( this->w.at(i+2) ) << static_cast<int>( this->w.at(i+3) ) << endl;
+        cout << count << "). 0x" << hex << setw(8) << setfill('0') << static_cast<int>( this->w[i] ) << static_cast<int>( this->w[i+1] ) << static_cast<int>( this->w[i+2] ) << static_cast<int>( this->w[i+3] ) << endl;
         count++;
     }
 }
@@ -271,11 +248,19 @@ void AES::printKeySchedule()
 AES::AES(string input, string key, bool encrypt)
 {
     this->Nb = 4;
+    this->Nk = 0;
+    this->Nr = 0;
+    this->trace = true;
     
     initState(input);
 
     initKey(key, encrypt);
 
+    if(this->Nk == 0)
+    {
+        throw invalid_argument("AES key must be 16, 24 or 32 bytes");
+    }
+
     if(encrypt)
     {
         cout << endl << "PLAINTEXT:          " << input << endl;
@@ -291,6 +276,34 @@ AES::AES(string input, string key, bool encrypt)
 
 
 
+/* Function: Constructor
+ * Parameters: A pointer to the key bytes, and the key length in bytes (16, 24 or 32)
+ * Return: an AES object
+ * Description: This constructor expands a raw binary key without printing anything. The resulting object encrypts and decrypts
+ *              caller-owned buffers through Cipher(in, out, blocks) and Decipher(in, out, blocks).
+*/
+AES::AES(const uint8_t* key, size_t keyLength)
+{
+    this->Nb = 4;
+    this->Nk = 0;
+    this->Nr = 0;
+    this->trace = false;
+
+    initKey(key, keyLength, false);
+
+    if(this->Nk == 0)
+    {
+        throw invalid_argument("AES key must be 16, 24 or 32 bytes");
+    }
+
+    initRcon(this->Nr);
+
+    KeyExpansion(this->key, this->w, this->Nk);
+}
+
+
+
+
 /* Function: initState
  * Parameters: a string representing the input bytes
  * Return: None
@@ -298,20 +311,39 @@ AES::AES(string input, string key, bool encrypt)
 */
 void AES::initState(string input)
 {
-    vector<int> bytes;
-    for(int i = 0; i < input.length(); i+=2)
+    uint8_t bytes[16];
+    if(input.length() != 32 || !hexDecode(input.data(), input.length(), bytes))
     {
-        uint8_t byte = static_cast<uint8_t>( stoi( input.substr(i, 2), 0, 16 ) );
-        bytes.push_back(byte);
+        throw invalid_argument("AES input must be 32 hex digits");
     }
 
-    for(int i = 0; i < 4; i++)
-    {
-        for(int j = 0; j < 4; j++)
-        {
-            state[j][i] = bytes.at((i*4) + j);
-        }
-    }
+    loadState(bytes);
+}
+
+
+
+
+/* Function: loadState
+ * Parameters: a pointer to 16 input bytes
+ * Return: None
+ * Description: This function loads a block of raw bytes into the state. The state keeps the bytes in input (column major) order, so this is a single move.
+*/
+void AES::loadState(const uint8_t* input)
+{
+    this->state = AESState::load(input);
+}
+
+
+
+
+/* Function: storeState
+ * Parameters: a pointer to 16 output bytes
+ * Return: None
+ * Description: This function stores the state out to raw bytes, again in a single move
+*/
+void AES::storeState(uint8_t* output)
+{
+    this->state.store(output);
 }
 
 
@@ -320,21 +352,13 @@ void AES::initState(string input)
 /* Function: printState
  * Parameters: None
  * Return: None
- * Description: This function prints the 2D state array
+ * Description: This function prints the state column by column, which is its byte order
 */
 void AES::printState()
 {
-   // cout << "--- state ---" << endl;
-    for(int i = 0; i < 4; i++)
+    for(int i = 0; i < 16; i++)
     {
-        for(int j = 0; j < 4; j++)
-        {
-            cout << hex << setw(2) << setfill('0') << static_cast<int>( state[j][i] );
-            //if(j == 3)
-            //{
-                //cout << endl;
-            //}
-        }
+        cout << hex << setw(2) << setfill('0') << static_cast<int>( this->state.data()[i] );
     }
 }
 
@@ -348,12 +372,27 @@ void AES::printState()
 */
 void AES::initKey(string key, bool encrypt)
 {
-    if(!encrypt)
+    uint8_t bytes[32];
+    if(key.length() > 64 || !hexDecode(key.data(), key.length(), bytes))
     {
-        cout << "INVERSE CIPHER (DECRYPT):" << endl;
+        throw invalid_argument("AES key must be hex digits");
     }
 
-    switch((key.length() / 2) * 8) // 128, 192, 256
+    initKey(bytes, key.length() / 2, encrypt);
+    secureZero(bytes, sizeof(bytes));
+}
+
+
+
+
+/* Function: initKey
+ * Parameters: a pointer to the key bytes, the key length in bytes, and whether to print the key size banner
+ * Return: None
+ * Description: This function selects Nk and Nr from the key length and copies the key bytes into the key vector attribute
+*/
+void AES::initKey(const uint8_t* key, size_t keyLength, bool encrypt)
+{
+    switch(keyLength * 8) // 128, 192, 256
     {
         case 128:
         {
@@ -391,11 +430,8 @@ void AES::initKey(string key, bool encrypt)
         }
     }
 
-    for(int i = 0; i < key.length(); i+=2)
-    {
-        uint8_t byte = static_cast<uint8_t>( ( stoi (key.substr(i, 2), 0, 16) ) );
-        this->key.push_back(byte);
-    }
+    this->key = SecureArray<uint8_t>(keyLength);
+    memcpy(this->key.data(), key, keyLength);
 }
 
 
@@ -408,6 +444,8 @@ void AES::initKey(string key, bool encrypt)
 */
 void AES::Cipher()
 {
+    PERF_SCOPE("AES::Cipher");
+
     cout << "CIPHER (ENCRYPT):" << endl;
     
     // we have state
@@ -417,10 +455,10 @@ void AES::Cipher()
     printState();
     cout << endl;
 
-    int index = 0;
+    int round = 0;
     cout << "round[" << setw(2) << setfill(' ') << 0 << "].k_sch     ";
-    AddRoundKey(this->state, this->w, index);
-    index += 4;
+    AddRoundKey(this->state, this->roundKeys, round);
+    round++;
 
     int i = 0;
     for(i = 0; i < Nr - 1; i++)
@@ -446,9 +484,9 @@ void AES::Cipher()
 
         
         cout << "round[" << setw(2) << setfill(' ') << dec << i+1 << "].k_sch     ";
-        AddRoundKey(this->state, this->w, index); // key schedule!!
+        AddRoundKey(this->state, this->roundKeys, round);
 
-        index += 4;
+        round++;
     }
 
     // last round
@@ -467,11 +505,11 @@ void AES::Cipher()
     cout << endl;
 
     cout << "round[" << setw(2) << setfill(' ') << dec << i+1 << "].k_sch     ";
-    AddRoundKey(this->state, this->w, index);
+    AddRoundKey(this->state, this->roundKeys, round);
 
     cout << "round[" << setw(2) << setfill(' ') << dec << i+1 << "].output    ";
     printState();
-    index += 4;
+    round++;
     cout << endl;
 }
 
@@ -479,111 +517,62 @@ void AES::Cipher()
 
 
 /* AddRoundKey
- * Parameters: A reference to the 2D state array, the Key Schedule vector, and the index of the round key to XOR
+ * Parameters: A reference to the state, the round keys, and the round whose key to XOR
  * Return: None
- * Description: This transformation adds a round key to the state using XOR
+ * Description: This transformation adds a round key to the state using XOR. The round key is held in the same byte order as the state, so the addition is a single XOR of two 128-bit values.
 */
-void AES::AddRoundKey(uint8_t (&state)[4][4], vector<uint32_t> w, int index) // pass the location of the offset of the key schedule
+void AES::AddRoundKey(AESState& state, const SecureArray<AESState>& roundKeys, int round)
 {
-    for(int i = 0; i < 4; i++)
+    const AESState& roundKey = roundKeys[round];
+
+    if(this->trace)
     {
-        // get state column word
-        uint32_t word = static_cast<uint32_t>( state[0][i] ) << 24 |
-                        static_cast<uint32_t>( state[1][i] ) << 16 |
-                        static_cast<uint32_t>( state[2][i] ) << 8 |
-                        static_cast<uint32_t>( state[3][i] );
-        
-        word ^= w.at(i+index);
-        
-        //cout << hex << setw(8) << setfill('0') << word << endl;
-        cout << hex << setw(8) << setfill('0') << w.at(i+index);
-        // put back in state
-        uint8_t s0 = static_cast<uint8_t>( (word >> 24) & 0xFF );
-        uint8_t s1 = static_cast<uint8_t>( (word >> 16) & 0xFF );
-        uint8_t s2 = static_cast<uint8_t>( (word >> 8) & 0xFF );
-        uint8_t s3 = static_cast<uint8_t>( word & 0xFF );
-
-        state[0][i] = s0;
-        state[1][i] = s1;
-        state[2][i] = s2;
-        state[3][i] = s3;
+        for(int i = 0; i < 16; i++)
+        {
+            cout << hex << setw(2) << setfill('0') << static_cast<int>( roundKey.data()[i] );
+        }
+        cout << endl;
     }
-    cout << endl;
+
+    state.addRoundKey(roundKey);
 }
 
 
 
 
 /* Function: SubBytes
- * Parameters: A reference to the 2D state array
+ * Parameters: A reference to the state
  * Return: None
  * Description: This transformation substitutes each byte in the state with its corresponding value from the S-Box
 */
-void AES::SubBytes(uint8_t (&state)[4][4])
+void AES::SubBytes(AESState& state)
 {
-    for(int i = 0; i < 4; i++)
-    {
-        uint32_t word = static_cast<uint32_t>( state[0][i] ) << 24 |
-                        static_cast<uint32_t>( state[1][i] ) << 16 |
-                        static_cast<uint32_t>( state[2][i] ) << 8 |
-                        static_cast<uint32_t>( state[3][i] );
-        
-        word = subWord(word);
-
-        uint8_t s0 = static_cast<uint8_t>( (word >> 24) & 0xFF );
-        uint8_t s1 = static_cast<uint8_t>( (word >> 16) & 0xFF );
-        uint8_t s2 = static_cast<uint8_t>( (word >> 8) & 0xFF );
-        uint8_t s3 = static_cast<uint8_t>( word & 0xFF );
-
-        state[0][i] = s0;
-        state[1][i] = s1;
-        state[2][i] = s2;
-        state[3][i] = s3;
-    }
+    state.subBytes();
 }
 
 
 
 
 /* Function: ShiftRows
- * Parameters: A reference to the 2D state array
+ * Parameters: A reference to the state
  * Return: None
- * Description: This transformation performs a circular shift on each row in the state
+ * Description: This transformation performs a circular shift on each row in the state: row r moves left by r columns. With the state in one register this is a single byte shuffle.
 */
-void AES::ShiftRows(uint8_t (&state)[4][4])
+void AES::ShiftRows(AESState& state)
 {
-    for(int i = 0; i < 4; i++)
-    {   
-        for(int j = 0; j < i; j++)
-        {
-            // get the row
-            uint32_t row = static_cast<uint32_t>( (state[i][0] << 24) ) |
-                        static_cast<uint32_t>( (state[i][1] << 16) ) |
-                        static_cast<uint32_t>( (state[i][2] << 8) ) |
-                        static_cast<uint32_t>( (state[i][3]) );
-
-            uint8_t r0 = static_cast<uint8_t>( (row >> 24) & 0xFF );
-            uint8_t r1 = static_cast<uint8_t>( (row >> 16) & 0xFF );
-            uint8_t r2 = static_cast<uint8_t>( (row >> 8) & 0xFF );
-            uint8_t r3 = static_cast<uint8_t>( row & 0xFF );
-
-            state[i][0] = r1;
-            state[i][1] = r2;
-            state[i][2] = r3;
-            state[i][3] = r0;
-        }
-    }
+    state.shiftRows();
 }
 
 
 
 
 /* Function: MixColumns
- * Parameters: A reference to the 2D state array
+ * Parameters: A reference to the state
  * Return: None
  * Description: This transformation treats each column in state as a four-term polynomial. This polynomial is multiplied (modulo another polynomial) by a fixed polynomial with coefficients
+ *              {02, 03, 01, 01}. GF256 multiplies all four columns at once with packed constant-multiplier tables.
 */
-void AES::MixColumns(uint8_t (&state)[4][4])
+void AES::MixColumns(AESState& state)
 {
     // fixed polynomial matrix a(x)
     // a[4][4] = 
@@ -594,20 +583,7 @@ void AES::MixColumns(uint8_t (&state)[4][4])
     //  {03, 01, 01, 02} 
     // };
 
-    //cout << "--- Mix Columns ---" << endl;
-
-    for(int i = 0; i < this->Nb; i++)
-    {
-        uint8_t s0 = state[0][i];
-        uint8_t s1 = state[1][i];
-        uint8_t s2 = state[2][i];
-        uint8_t s3 = state[3][i];
-
-        state[0][i] = ffMultiply(0x02, s0) ^ ffMultiply(0x03, s1) ^ s2 ^ s3;
-        state[1][i] = s0 ^ ffMultiply(0x02, s1) ^ ffMultiply(0x03, s2) ^ s3;
-        state[2][i] = s0 ^ s1 ^ ffMultiply(0x02, s2) ^ ffMultiply(0x03, s3);
-        state[3][i] = ffMultiply(0x03, s0) ^ s1 ^ s2 ^ ffMultiply(0x02, s3);
-    }
+    state.mixColumns();
 }
 
 
@@ -615,10 +591,6 @@ void AES::MixColumns(uint8_t (&state)[4][4])
 
 
 
-
-
-// -------------------------------------- INVERSE METHODS -------------------------------------- 
-
 /* Function: InvsBoxSub
  * Parameters: A byte to substitute
  * Return: The value of the byte's inverse substitution
@@ -630,7 +602,7 @@ uint8_t AES::InvsBoxSub(uint8_t byte)
     int row = static_cast<int>( (byte >> 4) & 0xF );
     int col = static_cast<int>( byte & 0xF );
 
-    return this->InvSBox[(row * 16) + col];
+    return AESTables::InvSBox[(row * 16) + col];
 }
 
 
@@ -661,77 +633,37 @@ uint32_t AES::InvsubWord(uint32_t word)
 
 
 /* Function: InvSubBytes
- * Parameters: A reference to the 2D state array
+ * Parameters: A reference to the state
  * Return: None
  * Description: This transformation substitutes each byte in the state with its corresponding value from the inverse S-Box, thus reversing the effect of a subBytes() operation
 */
-void AES::InvSubBytes(uint8_t (&state)[4][4])
+void AES::InvSubBytes(AESState& state)
 {
-    for(int i = 0; i < 4; i++)
-    {
-        uint32_t word = static_cast<uint32_t>( state[0][i] ) << 24 |
-                        static_cast<uint32_t>( state[1][i] ) << 16 |
-                        static_cast<uint32_t>( state[2][i] ) << 8 |
-                        static_cast<uint32_t>( state[3][i] );
-        
-        word = InvsubWord(word);
-
-        uint8_t s0 = static_cast<uint8_t>( (word >> 24) & 0xFF );
-        uint8_t s1 = static_cast<uint8_t>( (word >> 16) & 0xFF );
-        uint8_t s2 = static_cast<uint8_t>( (word >> 8) & 0xFF );
-        uint8_t s3 = static_cast<uint8_t>( word & 0xFF );
-
-        state[0][i] = s0;
-        state[1][i] = s1;
-        state[2][i] = s2;
-        state[3][i] = s3;
-    }
+    state.invSubBytes();
 }
 
 
 
 
 /* Function: InvShiftRows
- * Parameters: A reference to the 2D state array
+ * Parameters: A reference to the state
  * Return: None
- * Description: This transformation performs the inverse of shiftRows() on each row in the state
+ * Description: This transformation performs the inverse of shiftRows() on each row in the state: row r moves right by r columns
 */
-void AES::InvShiftRows(uint8_t (&state)[4][4])
+void AES::InvShiftRows(AESState& state)
 {
-    //cout << "-- Shift Rows --" << endl;
-    for(int i = 0; i < 4; i++)
-    {   
-        //cout << "0x " << hex << setw(8) << setfill('0') << static_cast<int>(row) << " " << endl;
-        for(int j = 0; j < i; j++)
-        {
-            // get the row
-            uint32_t row = static_cast<uint32_t>( (state[i][0] << 24) ) |
-                        static_cast<uint32_t>( (state[i][1] << 16) ) |
-                        static_cast<uint32_t>( (state[i][2] << 8) ) |
-                        static_cast<uint32_t>( (state[i][3]) );
-
-            uint8_t r0 = static_cast<uint8_t>( (row >> 24) & 0xFF );
-            uint8_t r1 = static_cast<uint8_t>( (row >> 16) & 0xFF );
-            uint8_t r2 = static_cast<uint8_t>( (row >> 8) & 0xFF );
-            uint8_t r3 = static_cast<uint8_t>( row & 0xFF );
-
-            state[i][0] = r3;
-            state[i][1] = r0;
-            state[i][2] = r1;
-            state[i][3] = r2;
-        }
-    }
+    state.invShiftRows();
 }
 
 
 
 
 /* Function: InvMixColumns
- * Parameters: A reference to a 2D state array
+ * Parameters: A reference to the state
  * Return: None
- * Description: This transformation is the inverse of mixColumns
+ * Description: This transformation is the inverse of mixColumns, computed by GF256 the same way with the coefficients {0e, 0b, 0d, 09}
 */
-void AES::InvMixColumns(uint8_t (&state)[4][4])
+void AES::InvMixColumns(AESState& state)
 {
     // fixed polynomial matrix a(x)
     // a[4][4] = 
@@ -742,18 +674,7 @@ void AES::InvMixColumns(uint8_t (&state)[4][4])
     //  {0b, 0d, 09, 0e} 
     // };
 
-    for(int i = 0; i < this->Nb; i++)
-    {
-        uint8_t s0 = state[0][i];
-        uint8_t s1 = state[1][i];
-        uint8_t s2 = state[2][i];
-        uint8_t s3 = state[3][i];
-
-        state[0][i] = ffMultiply(0x0e, s0) ^ ffMultiply(0x0b, s1) ^ ffMultiply(0x0d, s2) ^ ffMultiply(0x09, s3);
-        state[1][i] = ffMultiply(0x09, s0) ^ ffMultiply(0x0e, s1) ^ ffMultiply(0x0b, s2) ^ ffMultiply(0x0d, s3);
-        state[2][i] = ffMultiply(0x0d, s0) ^ ffMultiply(0x09, s1) ^ ffMultiply(0x0e, s2) ^ ffMultiply(0x0b, s3);
-        state[3][i] = ffMultiply(0x0b, s0) ^ ffMultiply(0x0d, s1) ^ ffMultiply(0x09, s2) ^ ffMultiply(0x0e, s3);
-    }
+    state.invMixColumns();
 }
 
 
@@ -766,6 +687,10 @@ void AES::InvMixColumns(uint8_t (&state)[4][4])
 */
 void AES::Decipher()
 {
+    PERF_SCOPE("AES::Decipher");
+
+    cout << "INVERSE CIPHER (DECRYPT):" << endl;
+
     // we have state
     // we have key schedule
     
@@ -774,10 +699,10 @@ void AES::Decipher()
     cout << endl;
  
 
-    int index = (Nr*Nb);
+    int round = Nr;
     cout << "round[" << setw(2) << setfill(' ') << 0 << "].ik_sch    ";
-    AddRoundKey(this->state, this->w, index);
-    index -= 4;
+    AddRoundKey(this->state, this->roundKeys, round);
+    round--;
 
     int i = 0;
     for(i = 0; i < Nr - 1; i++)
@@ -797,14 +722,14 @@ void AES::Decipher()
         cout << endl;
         
         cout << "round[" << setw(2) << setfill(' ') << dec << i+1 << "].ik_sch    ";
-        AddRoundKey(this->state, this->w, index);
+        AddRoundKey(this->state, this->roundKeys, round);
         
         cout << "round[" << setw(2) << setfill(' ') << dec << i+1 << "].ik_add    ";
         printState();
         InvMixColumns(this->state);
 
         cout << endl;
-        index -= 4;
+        round--;
     }
 
     // last round
@@ -823,9 +748,222 @@ void AES::Decipher()
     cout << endl;
 
     cout << "round[" << setw(2) << setfill(' ') << dec << i+1 << "].ik_sch    ";
-    AddRoundKey(this->state, this->w, index);
+    AddRoundKey(this->state, this->roundKeys, round);
 
     cout << "round[" << setw(2) << setfill(' ') << dec << i+1 << "].ioutput   ";
     printState();
     cout << endl;
+}
+
+
+
+
+/* Function: InvKeyExpansion
+ * Parameters: None
+ * Return: None
+ * Description: This function builds the decryption key schedule dw used by the equivalent inverse cipher (FIPS-197 5.3.5).
+ *              dw is a copy of w with InvMixColumns applied to the round keys of rounds 1 .. Nr-1. It is only built the first time
+ *              EqDecipher() runs, so objects that only encrypt never pay for it.
+*/
+void AES::InvKeyExpansion()
+{
+    PERF_SCOPE("AES::InvKeyExpansion");
+
+    if(!this->dw.empty())
+    {
+        return;
+    }
+
+    // the round keys are already States, so InvMixColumns applies to them directly
+    this->invRoundKeys = SecureArray<AESState>(this->Nr + 1);
+    for(int round = 0; round <= this->Nr; round++)
+    {
+        this->invRoundKeys[round] = this->roundKeys[round];
+        if(round > 0 && round < this->Nr)
+        {
+            InvMixColumns(this->invRoundKeys[round]);
+        }
+    }
+
+    this->dw = SecureArray<uint32_t>(this->Nb * (this->Nr + 1));
+    for(int round = 0; round <= this->Nr; round++)
+    {
+        const AESState& roundKey = this->invRoundKeys[round];
+        for(int i = 0; i < 4; i++)
+        {
+            this->dw[this->Nb * round + i] = static_cast<uint32_t>( roundKey(0, i) ) << 24 |
+                                             static_cast<uint32_t>( roundKey(1, i) ) << 16 |
+                                             static_cast<uint32_t>( roundKey(2, i) ) << 8 |
+                                             static_cast<uint32_t>( roundKey(3, i) );
+        }
+    }
+}
+
+
+
+
+/* Function: EqDecipher
+ * Parameters: None
+ * Return: None
+ * Description: This function performs the AES equivalent inverse cipher on the input state as described in FIPS-197 5.3.5.
+ *              The transformations run in the same order as the cipher (InvSubBytes, InvShiftRows, InvMixColumns, AddRoundKey),
+ *              which is the structure table driven and AESDEC based implementations use, at the cost of the modified key schedule dw.
+*/
+void AES::EqDecipher()
+{
+    PERF_SCOPE("AES::EqDecipher");
+
+    cout << "EQUIVALENT INVERSE CIPHER (DECRYPT):" << endl;
+
+    InvKeyExpansion();
+
+    cout << "round[ 0].iinput    ";
+    printState();
+    cout << endl;
+
+    int round = Nr;
+    cout << "round[" << setw(2) << setfill(' ') << 0 << "].ik_sch    ";
+    AddRoundKey(this->state, this->invRoundKeys, round);
+    round--;
+
+    int i = 0;
+    for(i = 0; i < Nr - 1; i++)
+    {
+        cout << "round[" << setw(2) << setfill(' ') << dec << i+1 << "].istart    ";
+        printState();
+        cout << endl;
+
+        InvSubBytes(this->state);
+        cout << "round[" << setw(2) << setfill(' ') << dec << i+1 << "].is_box    ";
+        printState();
+        cout << endl;
+
+        InvShiftRows(this->state);
+        cout << "round[" << setw(2) << setfill(' ') << dec << i+1 << "].is_row    ";
+        printState();
+        cout << endl;
+
+        InvMixColumns(this->state);
+        cout << "round[" << setw(2) << setfill(' ') << dec << i+1 << "].im_col    ";
+        printState();
+        cout << endl;
+
+        cout << "round[" << setw(2) << setfill(' ') << dec << i+1 << "].ik_sch    ";
+        AddRoundKey(this->state, this->invRoundKeys, round);
+
+        round--;
+    }
+
+    // last round
+    cout << "round[" << setw(2) << setfill(' ') << dec << i+1 << "].istart    ";
+    printState();
+    cout << endl;
+
+    InvSubBytes(this->state);
+    cout << "round[" << setw(2) << setfill(' ') << dec << i+1 << "].is_box    ";
+    printState();
+    cout << endl;
+
+    InvShiftRows(this->state);
+    cout << "round[" << setw(2) << setfill(' ') << dec << i+1 << "].is_row    ";
+    printState();
+    cout << endl;
+
+    cout << "round[" << setw(2) << setfill(' ') << dec << i+1 << "].ik_sch    ";
+    AddRoundKey(this->state, this->invRoundKeys, round);
+
+    cout << "round[" << setw(2) << setfill(' ') << dec << i+1 << "].ioutput   ";
+    printState();
+    cout << endl;
+}
+
+
+
+
+static_assert(sizeof(AESState) == 16, "the SSSE3 kernels read roundKeys as consecutive 16 byte States");
+
+
+/* Function: Cipher
+ * Parameters: A pointer to the input blocks, a pointer to the output blocks, and the number of 16 byte blocks
+ * Return: None
+ * Description: This function encrypts raw bytes from a caller-owned buffer into a caller-owned buffer (ECB, one block at a time).
+ *              The output may be the same buffer as the input. Nothing is printed, whatever the trace setting. The state is a
+ *              local that is wiped on return, so threads may share one object and no block is left behind in it.
+ *              With SSSE3 the whole loop runs in the SSSE3 kernel, chosen once per call; this translation unit is built
+ *              without -mssse3, so every AESState::shiftRows() below would be a kernel call of its own.
+*/
+void AES::Cipher(const uint8_t* input, uint8_t* output, size_t blocks) const
+{
+    PERF_BATCH_SCOPE("AES::Cipher(blocks)", blocks);
+
+    if(cpuFeatures().ssse3 && aesCipherSSSE3(this->roundKeys.data()->data(), this->Nr, input, output, blocks) == blocks)
+    {
+        return;
+    }
+
+    AESState state;
+    for(size_t block = 0; block < blocks; block++)
+    {
+        state = AESState::load(input + (16 * block));
+
+        state.addRoundKey(this->roundKeys[0]);
+
+        for(int round = 1; round < Nr; round++)
+        {
+            state.subBytes();
+            state.shiftRows();
+            state.mixColumns();
+            state.addRoundKey(this->roundKeys[round]);
+        }
+
+        state.subBytes();
+        state.shiftRows();
+        state.addRoundKey(this->roundKeys[Nr]);
+
+        state.store(output + (16 * block));
+    }
+    secureZero(&state, sizeof(state));
+}
+
+
+
+
+/* Function: Decipher
+ * Parameters: A pointer to the input blocks, a pointer to the output blocks, and the number of 16 byte blocks
+ * Return: None
+ * Description: This function decrypts raw bytes from a caller-owned buffer into a caller-owned buffer with the inverse cipher.
+ *              The output may be the same buffer as the input. Like the block Cipher() it prints nothing and works in a local
+ *              state that is wiped on return. SSSE3 is chosen once per call, as in Cipher().
+*/
+void AES::Decipher(const uint8_t* input, uint8_t* output, size_t blocks) const
+{
+    PERF_BATCH_SCOPE("AES::Decipher(blocks)", blocks);
+
+    if(cpuFeatures().ssse3 && aesInvCipherSSSE3(this->roundKeys.data()->data(), this->Nr, input, output, blocks) == blocks)
+    {
+        return;
+    }
+
+    AESState state;
+    for(size_t block = 0; block < blocks; block++)
+    {
+        state = AESState::load(input + (16 * block));
+
+        state.addRoundKey(this->roundKeys[Nr]);
+
+        for(int round = Nr - 1; round > 0; round--)
+        {
+            state.invShiftRows();
+            state.invSubBytes();
+            state.addRoundKey(this->roundKeys[round]);
+            state.invMixColumns();
+        }
+
+        state.invShiftRows();
+        state.invSubBytes();
+        state.addRoundKey(this->roundKeys[0]);
+
+        state.store(output + (16 * block));
+    }
+    secureZero(&state, sizeof(state));
 }
\ No newline at end of file
@@ -0,0 +1,301 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains AESBatch method definitions.
+*/
+
+#include "AESBatch.h"
+#include "AESCMAC.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "../Common/Parallel.h"
+#include "../Common/PerfCounters.h"
+#include "../Common/SecureMemory.h"
+
+
+// Counter blocks and keystream for up to ScratchBlocks blocks; records are packed into it together so the multi-block kernels
+// see full batches even for 50 byte records
+static const size_t ScratchBlocks = 64;
+
+// records handed to a worker at a time
+static const size_t GroupRecords = 64;
+
+struct Scratch
+{
+    alignas(64) uint8_t counters[16 * ScratchBlocks];
+    alignas(64) uint8_t keystream[16 * ScratchBlocks];
+    uint8_t aadLengths[8 * GroupRecords];
+    AESMACInput inputs[GroupRecords];
+    uint8_t tags[AESBatch::TagSize * GroupRecords];
+};
+
+// one per thread, set up with the thread itself rather than on the heap
+static thread_local Scratch scratch;
+
+
+
+
+static size_t blocksOf(size_t length)
+{
+    return (length + 15) / 16;
+}
+
+
+// counter blocks first .. first + count - 1 of a record
+static void fillCounters(uint8_t* counters, const uint8_t* nonce, uint32_t first, size_t count)
+{
+    for(size_t b = 0; b < count; b++)
+    {
+        uint32_t counter = first + static_cast<uint32_t>( b );
+        memcpy(counters + 16 * b, nonce, 12);
+        counters[16 * b + 12] = static_cast<uint8_t>( counter >> 24 );
+        counters[16 * b + 13] = static_cast<uint8_t>( counter >> 16 );
+        counters[16 * b + 14] = static_cast<uint8_t>( counter >> 8 );
+        counters[16 * b + 15] = static_cast<uint8_t>( counter );
+    }
+}
+
+
+static void xorBytes(uint8_t* out, const uint8_t* in, const uint8_t* keystream, size_t length)
+{
+    for(size_t i = 0; i < length; i++)
+    {
+        out[i] = in[i] ^ keystream[i];
+    }
+}
+
+
+
+
+/* Function: Constructor
+ * Parameters: The encryption key, the MAC key, and their common length in bytes
+ * Return: an AESBatch object
+ * Description: Expands both keys once; AESCMAC derives its subkeys. Key lengths other than 16, 24 or 32 bytes throw
+ *              invalid_argument.
+*/
+AESBatch::AESBatch(const uint8_t* encryptionKey, const uint8_t* macKey, size_t keyLength) : cipher(encryptionKey, keyLength), mac(macKey, keyLength)
+{
+}
+
+
+
+
+/* Function: arenaSize
+ * Parameters: The records and their count
+ * Return: The arena bytes seal() writes for them
+ * Description: Each record takes its length plus a tag. open() writes only the plaintexts, so this is also enough for it.
+*/
+size_t AESBatch::arenaSize(const AESRecord* records, size_t count)
+{
+    size_t total = 0;
+    for(size_t i = 0; i < count; i++)
+    {
+        total += records[i].length + TagSize;
+    }
+    return total;
+}
+
+
+
+
+/* Function: layout
+ * Parameters: The records, their count, the arena and its capacity, the outputs, whether tags are written
+ * Return: The arena bytes the batch uses
+ * Description: Checks every record and places its output in the arena, so the records can then be processed in any order by
+ *              any thread. Nothing is written to the arena here, and a bad record or short arena throws before any output is.
+*/
+size_t AESBatch::layout(const AESRecord* records, size_t count, uint8_t* arena, size_t capacity, AESRecordOutput* outputs, bool tags) const
+{
+    // the 32-bit block counter starts at 1
+    const uint64_t MaxLength = 16 * static_cast<uint64_t>( UINT32_MAX - 1 );
+
+    size_t total = 0;
+    for(size_t i = 0; i < count; i++)
+    {
+        const AESRecord& record = records[i];
+        if(record.nonce == nullptr || (record.data == nullptr && record.length > 0) || (record.aad == nullptr && record.aadLength > 0) ||
+           (!tags && record.tag == nullptr) || record.length > MaxLength)
+        {
+            throw invalid_argument("AESBatch: malformed record " + to_string(i));
+        }
+
+        outputs[i].data = arena + total;
+        outputs[i].length = record.length;
+        total += record.length;
+
+        outputs[i].tag = tags ? arena + total : nullptr;
+        total += tags ? TagSize : 0;
+    }
+
+    if(total > capacity)
+    {
+        throw length_error("AESBatch: arena of " + to_string(capacity) + " bytes, " + to_string(total) + " needed");
+    }
+
+    return total;
+}
+
+
+
+
+/* Function: processGroup
+ * Parameters: The records, their count, their outputs, and null to seal or the authenticity flags to open
+ * Return: The number of authentic records (all of them when sealing)
+ * Description: Counter blocks of as many consecutive records as fit in the thread's scratch are encrypted in one call, and
+ *              each record is XORed with its part of the keystream. A record longer than the scratch goes through on its own
+ *              in scratch sized pieces. The CMACs of the group then run over the ciphertexts (the output when sealing, the input
+ *              when opening) with their chains interleaved by aesCbcMacMany. The scratch is wiped before returning.
+*/
+size_t AESBatch::processGroup(const AESRecord* records, size_t count, AESRecordOutput* outputs, bool* authentic) const
+{
+    Scratch& s = scratch;
+    size_t passed = 0;
+
+    for(size_t first = 0; first < count; )
+    {
+        size_t last = first;
+        size_t blocks = 0;
+
+        while(last < count && blocks + blocksOf(records[last].length) <= ScratchBlocks)
+        {
+            fillCounters(s.counters + 16 * blocks, records[last].nonce, 1, blocksOf(records[last].length));
+            blocks += blocksOf(records[last].length);
+            last++;
+        }
+
+        if(last == first)
+        {
+            // longer than the scratch
+            const AESRecord& record = records[first];
+            for(size_t offset = 0; offset < record.length; offset += sizeof(s.keystream))
+            {
+                size_t chunk = min(sizeof(s.keystream), record.length - offset);
+                fillCounters(s.counters, record.nonce, static_cast<uint32_t>( 1 + offset / 16 ), blocksOf(chunk));
+                this->cipher.encryptBlocks(s.counters, s.keystream, blocksOf(chunk));
+                xorBytes(outputs[first].data + offset, record.data + offset, s.keystream, chunk);
+            }
+            last = first + 1;
+        }
+        else
+        {
+            this->cipher.encryptBlocks(s.counters, s.keystream, blocks);
+
+            const uint8_t* keystream = s.keystream;
+            for(size_t i = first; i < last; i++)
+            {
+                xorBytes(outputs[i].data, records[i].data, keystream, records[i].length);
+                keystream += 16 * blocksOf(records[i].length);
+            }
+        }
+
+        first = last;
+    }
+
+    // the CMACs of the whole group, their chains interleaved
+    for(size_t i = 0; i < count; i++)
+    {
+        const AESRecord& record = records[i];
+
+        uint8_t* lengthBytes = s.aadLengths + 8 * i;
+        uint64_t aadLength = record.aadLength;
+        for(int b = 0; b < 8; b++)
+        {
+            lengthBytes[b] = static_cast<uint8_t>( aadLength >> (56 - 8 * b) );
+        }
+
+        const uint8_t* ciphertext = authentic ? record.data : outputs[i].data;
+        s.inputs[i] = AESMACInput{{{record.nonce, NonceSize, false}, {lengthBytes, 8, false}, {record.aad, record.aadLength, false},
+                                   {ciphertext, record.length, false}}, 4};
+    }
+
+    this->mac.tagMany(s.inputs, count, s.tags);
+
+    for(size_t i = 0; i < count; i++)
+    {
+        if(!authentic)
+        {
+            memcpy(outputs[i].tag, s.tags + TagSize * i, TagSize);
+            passed++;
+            continue;
+        }
+
+        // compare every byte so the time taken does not depend on where the tags differ
+        uint8_t difference = 0;
+        for(size_t b = 0; b < TagSize; b++)
+        {
+            difference |= s.tags[TagSize * i + b] ^ records[i].tag[b];
+        }
+
+        authentic[i] = difference == 0;
+        if(authentic[i])
+        {
+            passed++;
+        }
+        else
+        {
+            memset(outputs[i].data, 0, records[i].length);
+        }
+    }
+
+    // the scratch outlives the call in every worker thread: no keystream, counter block or expected tag stays in it
+    secureZero(s.counters, sizeof(s.counters));
+    secureZero(s.keystream, sizeof(s.keystream));
+    secureZero(s.tags, sizeof(s.tags));
+    return passed;
+}
+
+
+
+
+/* Function: seal
+ * Parameters: The records, their count, the arena and its capacity, the outputs, the number of threads
+ * Return: The arena bytes used
+ * Description: Lays the records out in the arena, then encrypts and tags them in groups of GroupRecords
+*/
+size_t AESBatch::seal(const AESRecord* records, size_t count, uint8_t* arena, size_t capacity, AESRecordOutput* outputs, unsigned threads) const
+{
+    PERF_BATCH_SCOPE("AESBatch::seal", count);
+
+    size_t used = this->layout(records, count, arena, capacity, outputs, true);
+
+    size_t groups = (count + GroupRecords - 1) / GroupRecords;
+    parallelFor(groups, threads, [&](size_t g)
+    {
+        size_t first = GroupRecords * g;
+        this->processGroup(records + first, min(GroupRecords, count - first), outputs + first, nullptr);
+    });
+
+    return used;
+}
+
+
+
+
+/* Function: open
+ * Parameters: The records, their count, the arena and its capacity, the outputs, the authenticity flags, the number of threads
+ * Return: The number of authentic records
+ * Description: Lays the plaintexts out in the arena, then checks and decrypts the records in groups of GroupRecords
+*/
+size_t AESBatch::open(const AESRecord* records, size_t count, uint8_t* arena, size_t capacity, AESRecordOutput* outputs, bool* authentic, unsigned threads) const
+{
+    PERF_BATCH_SCOPE("AESBatch::open", count);
+
+    this->layout(records, count, arena, capacity, outputs, false);
+
+    size_t groups = (count + GroupRecords - 1) / GroupRecords;
+    atomic<size_t> passed(0);
+    parallelFor(groups, threads, [&](size_t g)
+    {
+        size_t first = GroupRecords * g;
+        passed += this->processGroup(records + first, min(GroupRecords, count - first), outputs + first, authentic + first);
+    });
+
+    return passed;
+}
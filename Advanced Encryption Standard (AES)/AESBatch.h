@@ -0,0 +1,73 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains AESBatch, the batch interface for sealing many small records (message bus payloads of a few
+ *                  hundred bytes) in one call. Each record is encrypted in counter mode and authenticated with AES-CMAC over its
+ *                  nonce, associated data and ciphertext, under a separate MAC key (encrypt-then-MAC). Ciphertexts and tags are
+ *                  written back to back into one caller-provided arena, and counter blocks and keystream are built in per-thread
+ *                  scratch, so a batch makes no heap allocations.
+ *
+ *                  Record layout in the arena, in record order:    ciphertext (length bytes) | tag (16 bytes)
+ *                  Counter block of record block j:                nonce (12 bytes) | big-endian j + 1 (4 bytes)
+ *                  CMAC input:                                     nonce | big-endian aadLength (8 bytes) | aad | ciphertext
+*/
+
+#ifndef AES_BATCH_H
+#define AES_BATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "AESEngine.h"
+#include "AESCMAC.h"
+
+using namespace std;
+
+// One entry of the scatter list. For open(), data is the ciphertext and tag the tag received with it; seal() ignores tag.
+struct AESRecord
+{
+    const uint8_t* data;
+    size_t length;
+    const uint8_t* aad; // authenticated but not encrypted; may be null when aadLength is 0
+    size_t aadLength;
+    const uint8_t* nonce; // AESBatch::NonceSize bytes, never repeated under one key pair
+    const uint8_t* tag;
+};
+
+// Where a record's output landed in the arena; tag is null for open()
+struct AESRecordOutput
+{
+    uint8_t* data;
+    size_t length;
+    uint8_t* tag;
+};
+
+class AESBatch
+{
+    public:
+        static const size_t NonceSize = 12;
+        static const size_t TagSize = 16;
+
+        AESBatch(const uint8_t*, const uint8_t*, size_t); // encryption key, MAC key, common key length of 16, 24 or 32 bytes
+
+        static size_t arenaSize(const AESRecord*, size_t); // arena bytes needed to seal the records
+
+        // Encrypts and tags count records into the arena; returns the arena bytes used. Throws length_error, before writing
+        // anything, when the arena is too small. Threads above 1 split the records across worker threads.
+        size_t seal(const AESRecord*, size_t, uint8_t*, size_t, AESRecordOutput*, unsigned threads = 1) const;
+
+        // Checks the tags and decrypts count records into the arena; returns the number of authentic records. authentic[i] is
+        // set per record and the plaintext of a record that fails is zeroed rather than released.
+        size_t open(const AESRecord*, size_t, uint8_t*, size_t, AESRecordOutput*, bool*, unsigned threads = 1) const;
+
+    private:
+        AESEngine cipher;
+        AESCMAC mac;
+
+        size_t layout(const AESRecord*, size_t, uint8_t*, size_t, AESRecordOutput*, bool) const;
+        size_t processGroup(const AESRecord*, size_t, AESRecordOutput*, bool*) const;
+};
+
+#endif
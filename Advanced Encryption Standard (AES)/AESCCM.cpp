@@ -0,0 +1,269 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains AESCCM method definitions.
+*/
+
+#include "AESCCM.h"
+#include "AESCMAC.h"
+#include "AESModes.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "../Common/PerfCounters.h"
+
+
+// records formatted at a time
+static const size_t ChunkRecords = 64;
+
+
+/* Function: Constructor
+ * Parameters: The key, its length in bytes, the nonce size and the tag size
+ * Return: an AESCCM object
+ * Description: Sizes outside the ones SP 800-38C allows throw invalid_argument
+*/
+AESCCM::AESCCM(const uint8_t* key, size_t keyLength, size_t nonceSize, size_t tagSize) : engine(key, keyLength), nonceBytes(nonceSize), tagBytes(tagSize)
+{
+    if(nonceSize < 7 || nonceSize > 13)
+    {
+        throw invalid_argument("CCM nonces must be 7 to 13 bytes");
+    }
+    if(tagSize < 4 || tagSize > 16 || tagSize % 2 != 0)
+    {
+        throw invalid_argument("CCM tags must be 4, 6, 8, 10, 12, 14 or 16 bytes");
+    }
+}
+
+
+
+
+/* Function: check
+ * Parameters: The records and their count
+ * Return: None
+ * Description: Throws before anything is written if a record is malformed or its length does not fit the q byte length field
+*/
+void AESCCM::check(const AESRecord* records, size_t count) const
+{
+    size_t q = 15 - this->nonceBytes;
+    for(size_t i = 0; i < count; i++)
+    {
+        const AESRecord& record = records[i];
+        if(record.nonce == nullptr || (record.data == nullptr && record.length > 0) || (record.aad == nullptr && record.aadLength > 0) ||
+           (q < 8 && static_cast<uint64_t>( record.length ) >> (8 * q) != 0))
+        {
+            throw invalid_argument("AESCCM: malformed record " + to_string(i));
+        }
+    }
+}
+
+
+/* Function: macs
+ * Parameters: The records, their count, the plaintext of each, the outputs (16 bytes each)
+ * Return: None
+ * Description: Formats every record as SP 800-38C A.2 does and runs the CBC-MACs together:
+ *                B0          flags (Adata, (t - 2) / 2, q - 1) | nonce | payload length in q bytes
+ *                header      associated data length: 2 bytes below 2^16 - 2^8, else ff fe and 4 bytes, else ff ff and 8 bytes
+ *                aad         zero padded to a whole block, together with its header
+ *                payload     zero padded to a whole block
+*/
+void AESCCM::macs(const AESRecord* records, size_t count, const uint8_t* const* payloads, uint8_t* out) const
+{
+    uint8_t B0[16 * ChunkRecords];
+    uint8_t headers[10 * ChunkRecords];
+    AESMACInput inputs[ChunkRecords];
+
+    size_t q = 15 - this->nonceBytes;
+    for(size_t i = 0; i < count; i++)
+    {
+        const AESRecord& record = records[i];
+
+        uint8_t* b = B0 + 16 * i;
+        b[0] = static_cast<uint8_t>( (record.aadLength > 0 ? 0x40 : 0) | ((this->tagBytes - 2) / 2) << 3 | (q - 1) );
+        memcpy(b + 1, record.nonce, this->nonceBytes);
+        uint64_t length = record.length;
+        for(size_t j = 0; j < q; j++)
+        {
+            b[15 - j] = j < 8 ? static_cast<uint8_t>( length >> (8 * j) ) : 0;
+        }
+
+        uint8_t* header = headers + 10 * i;
+        uint64_t aadLength = record.aadLength;
+        size_t headerLength = 0;
+        if(aadLength == 0)
+        {
+        }
+        else if(aadLength < 0xFF00)
+        {
+            header[0] = static_cast<uint8_t>( aadLength >> 8 );
+            header[1] = static_cast<uint8_t>( aadLength );
+            headerLength = 2;
+        }
+        else
+        {
+            size_t size = aadLength >> 32 == 0 ? 4 : 8;
+            header[0] = 0xFF;
+            header[1] = size == 4 ? 0xFE : 0xFF;
+            for(size_t j = 0; j < size; j++)
+            {
+                header[2 + j] = static_cast<uint8_t>( aadLength >> (8 * (size - 1 - j)) );
+            }
+            headerLength = 2 + size;
+        }
+
+        inputs[i] = AESMACInput{{{b, 16, false}, {header, headerLength, false}, {record.aad, record.aadLength, true}, {payloads[i], record.length, true}}, 4};
+    }
+
+    aesCbcMacMany(this->engine, inputs, count, nullptr, nullptr, out);
+}
+
+
+/* Function: crypt
+ * Parameters: The records, their count, the outputs, the tag masks S0 (16 bytes each)
+ * Return: None
+ * Description: Counter block i of a record is flags (q - 1) | nonce | i in q bytes. Block 0 is encrypted for every record in
+ *              one call to mask the tags; the payload takes the counter blocks from 1 up.
+*/
+void AESCCM::crypt(const AESRecord* records, size_t count, const AESRecordOutput* outputs, uint8_t* S0) const
+{
+    size_t q = 15 - this->nonceBytes;
+    for(size_t i = 0; i < count; i++)
+    {
+        uint8_t* counter = S0 + 16 * i;
+        memset(counter, 0, 16);
+        counter[0] = static_cast<uint8_t>( q - 1 );
+        memcpy(counter + 1, records[i].nonce, this->nonceBytes);
+
+        counter[15] = 1;
+        aesCtrCrypt(this->engine, counter, records[i].data, outputs[i].data, records[i].length, 1);
+        counter[15] = 0;
+    }
+
+    this->engine.encryptBlocks(S0, S0, count);
+}
+
+
+
+
+/* Function: sealMany
+ * Parameters: The records, their count, the outputs
+ * Return: None
+ * Description: The MACs are taken over the plaintexts before they are encrypted, so the output may overwrite the input
+*/
+void AESCCM::sealMany(const AESRecord* records, size_t count, const AESRecordOutput* outputs) const
+{
+    PERF_BATCH_SCOPE("AESCCM::sealMany", count);
+
+    check(records, count);
+
+    for(size_t first = 0; first < count; first += ChunkRecords)
+    {
+        size_t n = min(ChunkRecords, count - first);
+        const uint8_t* payloads[ChunkRecords];
+        for(size_t i = 0; i < n; i++)
+        {
+            payloads[i] = records[first + i].data;
+        }
+
+        uint8_t T[16 * ChunkRecords];
+        uint8_t S0[16 * ChunkRecords];
+        macs(records + first, n, payloads, T);
+        crypt(records + first, n, outputs + first, S0);
+
+        for(size_t i = 0; i < n; i++)
+        {
+            for(size_t b = 0; b < this->tagBytes; b++)
+            {
+                outputs[first + i].tag[b] = T[16 * i + b] ^ S0[16 * i + b];
+            }
+        }
+    }
+}
+
+
+/* Function: openMany
+ * Parameters: The records, their count, the outputs, the authenticity flags
+ * Return: The number of authentic records
+ * Description: The records are decrypted first and the MACs taken over the decrypted payloads. The tags are compared in
+ *              constant time and the plaintext of a record that fails is zeroed rather than released.
+*/
+size_t AESCCM::openMany(const AESRecord* records, size_t count, const AESRecordOutput* outputs, bool* authentic) const
+{
+    PERF_BATCH_SCOPE("AESCCM::openMany", count);
+
+    check(records, count);
+    for(size_t i = 0; i < count; i++)
+    {
+        if(records[i].tag == nullptr)
+        {
+            throw invalid_argument("AESCCM: record " + to_string(i) + " has no tag");
+        }
+    }
+
+    size_t passed = 0;
+    for(size_t first = 0; first < count; first += ChunkRecords)
+    {
+        size_t n = min(ChunkRecords, count - first);
+        uint8_t T[16 * ChunkRecords];
+        uint8_t S0[16 * ChunkRecords];
+        crypt(records + first, n, outputs + first, S0);
+
+        const uint8_t* payloads[ChunkRecords];
+        for(size_t i = 0; i < n; i++)
+        {
+            payloads[i] = outputs[first + i].data;
+        }
+        macs(records + first, n, payloads, T);
+
+        for(size_t i = 0; i < n; i++)
+        {
+            uint8_t difference = 0;
+            for(size_t b = 0; b < this->tagBytes; b++)
+            {
+                difference |= T[16 * i + b] ^ S0[16 * i + b] ^ records[first + i].tag[b];
+            }
+
+            authentic[first + i] = difference == 0;
+            if(authentic[first + i])
+            {
+                passed++;
+            }
+            else
+            {
+                memset(outputs[first + i].data, 0, records[first + i].length);
+            }
+        }
+    }
+
+    return passed;
+}
+
+
+
+
+void AESCCM::seal(const uint8_t* nonce, const uint8_t* aad, size_t aadLength, const uint8_t* in, size_t length, uint8_t* out, uint8_t* tag) const
+{
+    AESRecord record = {in, length, aad, aadLength, nonce, nullptr};
+    AESRecordOutput output = {out, length, tag};
+    sealMany(&record, 1, &output);
+}
+
+
+bool AESCCM::open(const uint8_t* nonce, const uint8_t* aad, size_t aadLength, const uint8_t* in, size_t length, const uint8_t* tag, uint8_t* out) const
+{
+    AESRecord record = {in, length, aad, aadLength, nonce, tag};
+    AESRecordOutput output = {out, length, nullptr};
+    bool authentic = false;
+    openMany(&record, 1, &output, &authentic);
+    return authentic;
+}
+
+
+void AESCCM::clear()
+{
+    this->engine.clear();
+}
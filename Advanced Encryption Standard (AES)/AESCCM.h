@@ -0,0 +1,54 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains AES-CCM (NIST SP 800-38C, RFC 3610), counter mode encryption with a CBC-MAC over the
+ *                  formatted nonce, associated data and plaintext. The nonce and tag sizes are fixed per object: a nonce of 7 to
+ *                  13 bytes leaves a q = 15 - nonce size byte length field, and tags are 4 to 16 bytes in steps of 2.
+ *
+ *                  sealMany and openMany take the scatter lists AESBatch uses and run the CBC-MACs of the records through
+ *                  aesCbcMacMany, so their chains share the cipher pipeline instead of running one after the other. The output
+ *                  buffers are the caller's; only data and tag of each AESRecordOutput are used.
+*/
+
+#ifndef AES_CCM_H
+#define AES_CCM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "AESBatch.h"
+#include "AESEngine.h"
+
+using namespace std;
+
+class AESCCM
+{
+    public:
+        AESCCM(const uint8_t*, size_t, size_t nonceSize = 12, size_t tagSize = 16); // key, key length of 16, 24 or 32 bytes
+
+        size_t nonceSize() const { return this->nonceBytes; }
+        size_t tagSize() const { return this->tagBytes; }
+
+        // in and out may be the same buffer
+        void seal(const uint8_t* nonce, const uint8_t* aad, size_t aadLength, const uint8_t* in, size_t length, uint8_t* out, uint8_t* tag) const;
+        bool open(const uint8_t* nonce, const uint8_t* aad, size_t aadLength, const uint8_t* in, size_t length, const uint8_t* tag, uint8_t* out) const;
+
+        // count records at once; openMany returns the number of authentic records and zeroes the plaintext of the others
+        void sealMany(const AESRecord*, size_t, const AESRecordOutput*) const;
+        size_t openMany(const AESRecord*, size_t, const AESRecordOutput*, bool*) const;
+
+        void clear(); // wipe the key schedule
+
+    private:
+        AESEngine engine;
+        size_t nonceBytes;
+        size_t tagBytes;
+
+        void check(const AESRecord*, size_t) const;
+        void macs(const AESRecord*, size_t, const uint8_t* const*, uint8_t*) const;
+        void crypt(const AESRecord*, size_t, const AESRecordOutput*, uint8_t*) const;
+};
+
+#endif
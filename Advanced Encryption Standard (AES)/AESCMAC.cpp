@@ -0,0 +1,271 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the interleaved CBC-MAC and the AESCMAC method definitions.
+*/
+
+#include "AESCMAC.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "../Common/PerfCounters.h"
+#include "../Common/SecureMemory.h"
+
+
+// messages whose inputs tagMany lays out at a time
+static const size_t InputChunk = 64;
+
+
+static inline void xorBlock(uint8_t* X, const uint8_t* block)
+{
+    for(int i = 0; i < 16; i++)
+    {
+        X[i] ^= block[i];
+    }
+}
+
+
+// the doubling in GF(2^128) that derives the CMAC subkeys
+static void doubleBlock(const uint8_t* in, uint8_t* out)
+{
+    uint8_t carry = in[0] >> 7;
+    for(int i = 0; i < 15; i++)
+    {
+        out[i] = static_cast<uint8_t>( (in[i] << 1) | (in[i + 1] >> 7) );
+    }
+    out[15] = static_cast<uint8_t>( (in[15] << 1) ^ (carry * 0x87) );
+}
+
+
+
+
+// -------------------------------------- INTERLEAVED CBC-MAC --------------------------------------
+
+// The read position of one message in its lane
+struct MACLane
+{
+    const AESMACInput* input;
+    size_t message; // index of the input, and of its output
+    int piece;
+    size_t offset; // into the piece
+    size_t blocks; // still to be absorbed
+    bool complete; // whether the last block is a full one (CMAC)
+};
+
+
+static MACLane startLane(const AESMACInput* inputs, size_t message, bool cmac)
+{
+    const AESMACInput& input = inputs[message];
+
+    // the formatted length, with the padding after each piece that asks for it
+    size_t length = 0;
+    for(int p = 0; p < input.count; p++)
+    {
+        length += input.pieces[p].length;
+        if(input.pieces[p].pad)
+        {
+            length = (length + 15) / 16 * 16;
+        }
+    }
+
+    MACLane lane = {&input, message, 0, 0, (length + 15) / 16, length > 0 && length % 16 == 0};
+    if(cmac)
+    {
+        lane.blocks = max<size_t>(lane.blocks, 1); // the empty message is one padded block
+    }
+    else if(length == 0 || length % 16 != 0)
+    {
+        throw invalid_argument("CBC-MAC input must be a non-zero number of whole blocks");
+    }
+    return lane;
+}
+
+
+// Copies the next block of the message into block and returns the bytes that came from the message or its padding pieces
+static size_t nextBlock(MACLane& lane, uint8_t* block)
+{
+    size_t filled = 0;
+    while(filled < 16 && lane.piece < lane.input->count)
+    {
+        const AESMACPiece& piece = lane.input->pieces[lane.piece];
+        size_t take = min(16 - filled, piece.length - lane.offset);
+        if(take > 0)
+        {
+            memcpy(block + filled, piece.data + lane.offset, take);
+        }
+        filled += take;
+        lane.offset += take;
+
+        if(lane.offset == piece.length)
+        {
+            if(piece.pad && filled % 16 != 0)
+            {
+                memset(block + filled, 0, 16 - filled);
+                filled = 16;
+            }
+            lane.piece++;
+            lane.offset = 0;
+        }
+    }
+    return filled;
+}
+
+
+
+
+/* Function: aesCbcMacMany
+ * Parameters: The engine, the inputs, their count, the CMAC subkeys or null, the outputs
+ * Return: None
+ * Description: Lane l holds the chain value X[l] of one message. Each step XORs the next block of every active message into its
+ *              chain value and encrypts all chain values in one call. Finished messages write their chain value out and the
+ *              last active lane moves into their place, so the chain values stay contiguous, then the next waiting messages
+ *              take the free lanes.
+*/
+void aesCbcMacMany(const AESEngine& engine, const AESMACInput* inputs, size_t count, const uint8_t* K1, const uint8_t* K2, uint8_t* macs)
+{
+    PERF_BATCH_SCOPE("aesCbcMacMany", count);
+
+    const bool cmac = K1 != nullptr;
+    alignas(64) uint8_t X[16 * CBCMACLanes];
+    MACLane lanes[CBCMACLanes];
+    size_t active = 0;
+    size_t next = 0;
+
+    while(active > 0 || next < count)
+    {
+        while(active < CBCMACLanes && next < count)
+        {
+            lanes[active] = startLane(inputs, next++, cmac);
+            memset(X + 16 * active, 0, 16);
+            active++;
+        }
+
+        for(size_t l = 0; l < active; l++)
+        {
+            MACLane& lane = lanes[l];
+
+            // a whole block inside the current piece, and not the last one, is XORed in where it lies
+            if(lane.blocks > 1 && lane.piece < lane.input->count && lane.input->pieces[lane.piece].length - lane.offset > 16)
+            {
+                xorBlock(X + 16 * l, lane.input->pieces[lane.piece].data + lane.offset);
+                lane.offset += 16;
+                lane.blocks--;
+                continue;
+            }
+
+            uint8_t block[16];
+            size_t filled = nextBlock(lane, block);
+            lane.blocks--;
+
+            if(cmac && lane.blocks == 0)
+            {
+                if(lane.complete)
+                {
+                    xorBlock(block, K1);
+                }
+                else
+                {
+                    // pad with a '1' bit and zeros
+                    block[filled] = 0x80;
+                    memset(block + filled + 1, 0, 15 - filled);
+                    xorBlock(block, K2);
+                }
+            }
+            xorBlock(X + 16 * l, block);
+        }
+
+        engine.encryptBlocks(X, X, active);
+
+        for(size_t l = 0; l < active; )
+        {
+            if(lanes[l].blocks > 0)
+            {
+                l++;
+                continue;
+            }
+
+            memcpy(macs + 16 * lanes[l].message, X + 16 * l, 16);
+            active--;
+            lanes[l] = lanes[active];
+            memcpy(X + 16 * l, X + 16 * active, 16);
+        }
+    }
+
+    secureZero(X, sizeof(X));
+}
+
+
+
+
+// -------------------------------------- AES-CMAC --------------------------------------
+
+/* Function: Constructor
+ * Parameters: The key and its length in bytes
+ * Return: an AESCMAC object
+ * Description: Expands the key and derives the subkeys K1 = 2L and K2 = 4L from L = AES(key, 0). Key lengths other than 16, 24
+ *              or 32 bytes throw invalid_argument.
+*/
+AESCMAC::AESCMAC(const uint8_t* key, size_t keyLength) : engine(key, keyLength)
+{
+    uint8_t L[16] = {};
+    this->engine.encryptBlock(L, L);
+    doubleBlock(L, this->K1);
+    doubleBlock(this->K1, this->K2);
+    secureZero(L, sizeof(L));
+}
+
+
+void AESCMAC::tag(const uint8_t* message, size_t length, uint8_t* tag) const
+{
+    AESMACInput input = {{{message, length, false}}, 1};
+    aesCbcMacMany(this->engine, &input, 1, this->K1, this->K2, tag);
+}
+
+
+bool AESCMAC::verify(const uint8_t* message, size_t length, const uint8_t* tag) const
+{
+    uint8_t expected[TagSize];
+    this->tag(message, length, expected);
+
+    // compare every byte so the time taken does not depend on where the tags differ
+    uint8_t difference = 0;
+    for(size_t b = 0; b < TagSize; b++)
+    {
+        difference |= expected[b] ^ tag[b];
+    }
+    return difference == 0;
+}
+
+
+void AESCMAC::tagMany(const uint8_t* const* messages, const size_t* lengths, size_t count, uint8_t* tags) const
+{
+    AESMACInput inputs[InputChunk];
+
+    for(size_t first = 0; first < count; first += InputChunk)
+    {
+        size_t n = min(InputChunk, count - first);
+        for(size_t i = 0; i < n; i++)
+        {
+            inputs[i] = AESMACInput{{{messages[first + i], lengths[first + i], false}}, 1};
+        }
+        aesCbcMacMany(this->engine, inputs, n, this->K1, this->K2, tags + TagSize * first);
+    }
+}
+
+
+void AESCMAC::tagMany(const AESMACInput* inputs, size_t count, uint8_t* tags) const
+{
+    aesCbcMacMany(this->engine, inputs, count, this->K1, this->K2, tags);
+}
+
+
+void AESCMAC::clear()
+{
+    this->engine.clear();
+    secureZero(this->K1, sizeof(this->K1));
+    secureZero(this->K2, sizeof(this->K2));
+}
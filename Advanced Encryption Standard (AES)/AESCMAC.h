@@ -0,0 +1,71 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains AES-CMAC (NIST SP 800-38B, RFC 4493) and the interleaved CBC-MAC it and AES-CCM are built
+ *                  on. A CBC-MAC is one serial chain of block encryptions per message, which on its own keeps a single block in
+ *                  the cipher pipeline. aesCbcMacMany advances the chains of up to CBCMACLanes messages together instead: every
+ *                  step XORs the next block of each message into its chain value and encrypts all of them with one
+ *                  AESEngine::encryptBlocks call, so the AES-NI and VAES kernels have a block of every message in flight. A
+ *                  message that ends frees its lane for the next one, so messages of mixed lengths keep the lanes full.
+ *
+ *                  A message is the concatenation of up to AESMACInput::MaxPieces byte ranges, so framed inputs (a nonce, a length
+ *                  field, the associated data, the ciphertext) are MACed in place without being copied together.
+*/
+
+#ifndef AES_CMAC_H
+#define AES_CMAC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "AESEngine.h"
+
+using namespace std;
+
+// chains advanced per encryptBlocks call, enough for the 16 block VAES iteration
+static const size_t CBCMACLanes = 16;
+
+struct AESMACPiece
+{
+    const uint8_t* data; // may be null when length is 0
+    size_t length;
+    bool pad; // zero fill to the next block boundary after this piece, as CCM formats its fields
+};
+
+struct AESMACInput
+{
+    static const int MaxPieces = 4;
+    AESMACPiece pieces[MaxPieces];
+    int count;
+};
+
+// The final chain value of every input into macs (16 bytes each). With K1 and K2 the last block is completed as CMAC does it:
+// XORed with K1 when it is a full block, else padded with 10* and XORed with K2. Without them the input must be whole blocks.
+void aesCbcMacMany(const AESEngine&, const AESMACInput* inputs, size_t count, const uint8_t* K1, const uint8_t* K2, uint8_t* macs);
+
+class AESCMAC
+{
+    public:
+        static const size_t TagSize = 16;
+
+        AESCMAC(const uint8_t*, size_t); // key of 16, 24 or 32 bytes
+        ~AESCMAC() { clear(); } // the subkeys are outside the engine's SecureArray
+
+        void tag(const uint8_t* message, size_t length, uint8_t* tag) const;
+        bool verify(const uint8_t* message, size_t length, const uint8_t* tag) const; // compares in constant time
+
+        // tags of count independent messages, their chains interleaved
+        void tagMany(const uint8_t* const* messages, const size_t* lengths, size_t count, uint8_t* tags) const;
+        void tagMany(const AESMACInput* inputs, size_t count, uint8_t* tags) const;
+
+        void clear(); // wipe the key schedule and subkeys
+
+    private:
+        AESEngine engine;
+        uint8_t K1[16]; // subkeys K1 = 2L and K2 = 4L, L = AES(key, 0)
+        uint8_t K2[16];
+};
+
+#endif
@@ -0,0 +1,277 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains AESEngine method definitions.
+*/
+
+#include "AESEngine.h"
+#include "AESKernels.h"
+
+#include <stdexcept>
+
+#include "../Common/CpuFeatures.h"
+#include "../Common/PerfCounters.h"
+
+
+/* Function: Constructor
+ * Parameters: None, or a pointer to the key bytes and the key length in bytes
+ * Return: an AESEngine object
+ * Description: The key length selects the AESFixed specialization. Lengths other than 16, 24 or 32 bytes throw invalid_argument.
+*/
+AESEngine::AESEngine() : keyed(false)
+{
+}
+
+
+AESEngine::AESEngine(const uint8_t* key, size_t keyLength) : keyed(false)
+{
+    setKey(key, keyLength);
+}
+
+
+
+
+// a key of the size already held is expanded over the old schedule, in its allocation; otherwise the old engine is wiped
+template<typename Fixed>
+static void expandInto(variant<monostate, AES128, AES192, AES256>& impl, const uint8_t* key)
+{
+    if(Fixed* aes = get_if<Fixed>(&impl))
+    {
+        aes->KeyExpansion(key);
+    }
+    else
+    {
+        impl.emplace<Fixed>(key);
+    }
+}
+
+
+/* Function: setKey
+ * Parameters: A pointer to the key bytes, the key length in bytes
+ * Return: None
+ * Description: This function expands the key into the fixed size engine matching its length
+*/
+void AESEngine::setKey(const uint8_t* key, size_t keyLength)
+{
+    PERF_SCOPE("AESEngine::KeyExpansion");
+
+    switch(keyLength * 8) // 128, 192, 256
+    {
+        case 128:
+        {
+            expandInto<AES128>(this->impl, key);
+            break;
+        }
+        case 192:
+        {
+            expandInto<AES192>(this->impl, key);
+            break;
+        }
+        case 256:
+        {
+            expandInto<AES256>(this->impl, key);
+            break;
+        }
+        default:
+        {
+            throw invalid_argument("AES key must be 16, 24 or 32 bytes");
+        }
+    }
+    this->keyed = true;
+}
+
+
+
+
+/* Function: clear
+ * Parameters: None
+ * Return: None
+ * Description: Zeroes the expanded key in place so no copy of the schedule is left in memory. The storage stays with the engine,
+ *              so the next setKey() of the same size expands into it without allocating.
+*/
+void AESEngine::clear()
+{
+    visit([](auto& aes)
+    {
+        if constexpr (!is_same_v<decay_t<decltype(aes)>, monostate>)
+        {
+            aes.clear();
+        }
+    }, this->impl);
+
+    this->keyed = false;
+}
+
+
+
+
+int AESEngine::keyBits() const
+{
+    if(!this->keyed)
+    {
+        return 0;
+    }
+
+    switch(this->impl.index())
+    {
+        case 1: return 128;
+        case 2: return 192;
+        case 3: return 256;
+        default: return 0;
+    }
+}
+
+
+
+
+int AESEngine::rounds() const
+{
+    int bits = keyBits();
+    return bits ? (bits / 32) + 6 : 0;
+}
+
+
+size_t AESEngine::footprint() const
+{
+    return visit([](const auto& aes) -> size_t
+    {
+        if constexpr (is_same_v<decay_t<decltype(aes)>, monostate>)
+        {
+            return 0;
+        }
+        else
+        {
+            return aes.footprint();
+        }
+    }, this->impl);
+}
+
+
+
+
+/* Function: encryptPortable / decryptPortable
+ * Parameters: A fixed key size engine, the input blocks, the output blocks, the number of blocks
+ * Return: None
+ * Description: The table based block loop used when no AES instructions are available. It is cloned for AVX2 where the compiler
+ *              supports function multiversioning.
+*/
+template<typename Fixed>
+CRYPTO_MULTIVERSION
+static void encryptPortable(const Fixed& aes, const uint8_t* in, uint8_t* out, size_t blocks)
+{
+    for(size_t i = 0; i < blocks; i++)
+    {
+        aes.encryptBlock(in + 16 * i, out + 16 * i);
+    }
+}
+
+
+template<typename Fixed>
+CRYPTO_MULTIVERSION
+static void decryptPortable(const Fixed& aes, const uint8_t* in, uint8_t* out, size_t blocks)
+{
+    for(size_t i = 0; i < blocks; i++)
+    {
+        aes.decryptBlock(in + 16 * i, out + 16 * i);
+    }
+}
+
+
+
+
+/* Function: encryptBlocks / decryptBlocks
+ * Parameters: A pointer to the input blocks, a pointer to the output blocks (may alias the input), the number of 16 byte blocks
+ * Return: None
+ * Description: The key size is dispatched once per call. The widest kernel the CPU supports takes as many blocks as it can
+ *              (VAES on ZMM registers, then AES-NI) and the portable code finishes whatever is left.
+*/
+void AESEngine::encryptBlocks(const uint8_t* in, uint8_t* out, size_t blocks) const
+{
+    PERF_BATCH_SCOPE("AESEngine::encryptBlocks", blocks);
+
+    visit([&](const auto& aes)
+    {
+        using Fixed = decay_t<decltype(aes)>;
+
+        if constexpr (!is_same_v<Fixed, monostate>)
+        {
+            if(!this->keyed)
+            {
+                throw logic_error("AESEngine used before a key was set");
+            }
+
+            const CpuFeatures& cpu = cpuFeatures();
+            const uint32_t* w = aes.schedule();
+            size_t done = 0;
+
+            if(cpu.vaes && cpu.avx512f)
+            {
+                done = vaesEncryptBlocks(w, Fixed::Nr, in, out, blocks);
+            }
+            if(cpu.aesni && cpu.ssse3)
+            {
+                done += aesniEncryptBlocks(w, Fixed::Nr, in + 16 * done, out + 16 * done, blocks - done);
+            }
+            encryptPortable(aes, in + 16 * done, out + 16 * done, blocks - done);
+        }
+        else
+        {
+            throw logic_error("AESEngine used before a key was set");
+        }
+    }, this->impl);
+}
+
+
+void AESEngine::decryptBlocks(const uint8_t* in, uint8_t* out, size_t blocks) const
+{
+    PERF_BATCH_SCOPE("AESEngine::decryptBlocks", blocks);
+
+    visit([&](const auto& aes)
+    {
+        using Fixed = decay_t<decltype(aes)>;
+
+        if constexpr (!is_same_v<Fixed, monostate>)
+        {
+            if(!this->keyed)
+            {
+                throw logic_error("AESEngine used before a key was set");
+            }
+
+            const CpuFeatures& cpu = cpuFeatures();
+            size_t done = 0;
+
+            if((cpu.vaes && cpu.avx512f) || (cpu.aesni && cpu.ssse3))
+            {
+                const uint32_t* dw = aes.inverseSchedule();
+
+                if(cpu.vaes && cpu.avx512f)
+                {
+                    done = vaesDecryptBlocks(dw, Fixed::Nr, in, out, blocks);
+                }
+                if(cpu.aesni && cpu.ssse3)
+                {
+                    done += aesniDecryptBlocks(dw, Fixed::Nr, in + 16 * done, out + 16 * done, blocks - done);
+                }
+            }
+            decryptPortable(aes, in + 16 * done, out + 16 * done, blocks - done);
+        }
+        else
+        {
+            throw logic_error("AESEngine used before a key was set");
+        }
+    }, this->impl);
+}
+
+
+void AESEngine::encryptBlock(const uint8_t* in, uint8_t* out) const
+{
+    encryptBlocks(in, out, 1);
+}
+
+
+void AESEngine::decryptBlock(const uint8_t* in, uint8_t* out) const
+{
+    decryptBlocks(in, out, 1);
+}
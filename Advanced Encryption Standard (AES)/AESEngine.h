@@ -0,0 +1,43 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the AESEngine class. AESEngine selects AESFixed<128>, AESFixed<192> or AESFixed<256> at runtime from
+ *                  the length of the key, which keeps the runtime key size selection of the AES class while running the fixed size code.
+*/
+
+#ifndef AES_ENGINE_H
+#define AES_ENGINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <variant>
+
+#include "AESFixed.h"
+
+using namespace std;
+
+class AESEngine
+{
+    public:
+        AESEngine(); // An engine without a key; setKey must be called before use
+        AESEngine(const uint8_t*, size_t); // Constructor from a 16, 24 or 32 byte key
+
+        void setKey(const uint8_t*, size_t);
+        void clear(); // wipe the key schedules in place, keeping their storage for the next key, and return to the state without a key
+        int keyBits() const; // 128, 192, 256 or 0 when no key is set
+        int rounds() const; // Nr
+        size_t footprint() const; // bytes allocated for the key schedules, kept across clear(); 0 before the first key
+
+        void encryptBlock(const uint8_t*, uint8_t*) const;
+        void decryptBlock(const uint8_t*, uint8_t*) const;
+        void encryptBlocks(const uint8_t*, uint8_t*, size_t) const; // ECB over n consecutive 16 byte blocks
+        void decryptBlocks(const uint8_t*, uint8_t*, size_t) const;
+
+    private:
+        variant<monostate, AES128, AES192, AES256> impl;
+        bool keyed; // false before the first key and after clear(); impl may still hold the wiped schedules
+};
+
+#endif
@@ -0,0 +1,407 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the AESFixed class template. AESFixed<128>, AESFixed<192> and AESFixed<256> fix the key size at
+ *                  compile time so that Nk, Nr and the size of the key schedule are constants and every round loop is unrolled. Both
+ *                  key schedules live in one SecureArray, each starting on a cache line, so an AESFixed can be moved but not copied
+ *                  and its keys are wiped when it goes. The AES class keeps the runtime-selected, tracing implementation.
+*/
+
+#ifndef AES_FIXED_H
+#define AES_FIXED_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <thread>
+#include <utility>
+
+#include "AESTables.h"
+#include "GF256.h"
+#include "../Common/SecureMemory.h"
+
+using namespace std;
+
+
+/* Function: unroll
+ * Parameters: A callable that accepts an integral_constant index
+ * Return: None
+ * Description: This function calls f(0) .. f(N-1) through a fold expression so that the compiler sees N straight-line calls with
+ *              compile-time indices instead of a loop.
+*/
+template<typename F, size_t... I>
+inline void unrollImpl(F&& f, index_sequence<I...>)
+{
+    (f(integral_constant<int, static_cast<int>(I)>{}), ...);
+}
+
+template<int N, typename F>
+inline void unroll(F&& f)
+{
+    unrollImpl(f, make_index_sequence<N>{});
+}
+
+
+template<int KeyBits>
+class AESFixed
+{
+    static_assert(KeyBits == 128 || KeyBits == 192 || KeyBits == 256, "AES key size must be 128, 192 or 256 bits");
+
+    public:
+        // Symbols
+        static constexpr int Nb = 4; // Number of columns (32-bit words) comprising the State
+        static constexpr int Nk = KeyBits / 32; // Number of 32-bit words comprising the Cipher Key
+        static constexpr int Nr = Nk + 6; // Number of rounds
+        static constexpr int KeyBytes = 4 * Nk;
+        static constexpr int ScheduleWords = Nb * (Nr + 1);
+
+        AESFixed() : keys(2 * PaddedWords), inverseState(InverseNone) {}
+        explicit AESFixed(const uint8_t* key) : AESFixed() { KeyExpansion(key); }
+        AESFixed(const AESFixed&) = delete;
+        AESFixed& operator=(const AESFixed&) = delete;
+        AESFixed(AESFixed&&) noexcept;
+        AESFixed& operator=(AESFixed&&) noexcept;
+
+        void KeyExpansion(const uint8_t* key);
+        void clear(); // wipe both key schedules
+        size_t footprint() const { return this->keys.footprint(); } // bytes allocated for the schedules
+        void encryptBlock(const uint8_t* in, uint8_t* out) const;
+        void decryptBlock(const uint8_t* in, uint8_t* out) const;
+
+        const uint32_t* schedule() const { return this->keys.data(); } // w, ScheduleWords words
+        const uint32_t* inverseSchedule() const { InvKeyExpansion(); return this->keys.data() + PaddedWords; } // dw
+
+    private:
+        // the key schedule w, then the decryption key schedule dw from the next cache line on; mutable for the lazy dw
+        static constexpr int PaddedWords = (ScheduleWords + 15) / 16 * 16;
+        mutable SecureArray<uint32_t> keys;
+
+        // dw is for the equivalent inverse cipher. It is built by the first decryptBlock() after KeyExpansion(), so encrypt-only
+        // keys never pay for it. inverseState makes the first build safe when several threads share one key.
+        enum { InverseNone, InverseBuilding, InverseReady };
+        mutable atomic<int> inverseState;
+
+        void InvKeyExpansion() const;
+        static uint32_t InvMixColumnWord(uint32_t);
+
+        static uint8_t xtime(uint8_t);
+        static uint32_t subWord(uint32_t);
+        static uint32_t rotWord(uint32_t);
+
+        // The state is held as 16 bytes in input order, so byte (r, c) of the State is s[r + 4c]
+        static void AddRoundKey(uint8_t (&)[16], const uint32_t*);
+        static void SubShiftRows(uint8_t (&)[16]);
+        static void MixColumns(uint8_t (&)[16]);
+        static void InvSubShiftRows(uint8_t (&)[16]);
+        static void InvMixColumns(uint8_t (&)[16]);
+};
+
+using AES128 = AESFixed<128>;
+using AES192 = AESFixed<192>;
+using AES256 = AESFixed<256>;
+
+
+
+
+// -------------------------------------- KEY EXPANSION --------------------------------------
+
+template<int KeyBits>
+inline uint8_t AESFixed<KeyBits>::xtime(uint8_t byte)
+{
+    return GF256::xtime(byte);
+}
+
+
+template<int KeyBits>
+inline uint32_t AESFixed<KeyBits>::rotWord(uint32_t word)
+{
+    return (word << 8) | (word >> 24);
+}
+
+
+template<int KeyBits>
+inline uint32_t AESFixed<KeyBits>::subWord(uint32_t word)
+{
+    return static_cast<uint32_t>( AESTables::SBox[(word >> 24) & 0xFF] ) << 24 |
+           static_cast<uint32_t>( AESTables::SBox[(word >> 16) & 0xFF] ) << 16 |
+           static_cast<uint32_t>( AESTables::SBox[(word >> 8) & 0xFF] ) << 8 |
+           static_cast<uint32_t>( AESTables::SBox[word & 0xFF] );
+}
+
+
+/* Function: KeyExpansion
+ * Parameters: A pointer to KeyBytes bytes of cipher key
+ * Return: None
+ * Description: This function generates the key schedule. Since Nk is a constant the branches on i % Nk are resolved at compile time.
+*/
+template<int KeyBits>
+inline void AESFixed<KeyBits>::KeyExpansion(const uint8_t* key)
+{
+    if(this->keys.empty())
+    {
+        this->keys = SecureArray<uint32_t>(2 * PaddedWords); // moved from
+    }
+    uint32_t* w = this->keys.data();
+
+    unroll<Nk>([&](auto i)
+    {
+        w[i] = static_cast<uint32_t>( key[4 * i] ) << 24 |
+               static_cast<uint32_t>( key[4 * i + 1] ) << 16 |
+               static_cast<uint32_t>( key[4 * i + 2] ) << 8 |
+               static_cast<uint32_t>( key[4 * i + 3] );
+    });
+
+    unroll<ScheduleWords - Nk>([&](auto j)
+    {
+        constexpr int i = j + Nk;
+        uint32_t temp = w[i - 1];
+
+        if constexpr (i % Nk == 0)
+        {
+            temp = subWord(rotWord(temp)) ^ AESTables::Rcon[(i / Nk) - 1];
+        }
+        else if constexpr (Nk > 6 && i % Nk == 4)
+        {
+            temp = subWord(temp);
+        }
+
+        w[i] = w[i - Nk] ^ temp;
+    });
+
+    // a new key invalidates the decryption key schedule
+    this->inverseState.store(InverseNone, memory_order_relaxed);
+}
+
+
+
+
+template<int KeyBits>
+inline void AESFixed<KeyBits>::clear()
+{
+    this->keys.wipe();
+    this->inverseState.store(InverseNone, memory_order_relaxed);
+}
+
+
+// the schedules change hands with their allocation; the object moved from is left without one
+template<int KeyBits>
+inline AESFixed<KeyBits>::AESFixed(AESFixed&& other) noexcept
+    : keys(move(other.keys)), inverseState(other.inverseState.exchange(InverseNone, memory_order_acq_rel))
+{
+}
+
+
+template<int KeyBits>
+inline AESFixed<KeyBits>& AESFixed<KeyBits>::operator=(AESFixed&& other) noexcept
+{
+    if(this != &other)
+    {
+        this->keys = move(other.keys);
+        this->inverseState.store(other.inverseState.exchange(InverseNone, memory_order_acq_rel), memory_order_relaxed);
+    }
+    return *this;
+}
+
+
+template<int KeyBits>
+inline uint32_t AESFixed<KeyBits>::InvMixColumnWord(uint32_t word)
+{
+    uint8_t column[16] = { static_cast<uint8_t>( word >> 24 ), static_cast<uint8_t>( word >> 16 ),
+                           static_cast<uint8_t>( word >> 8 ), static_cast<uint8_t>( word ) };
+    InvMixColumns(column);
+
+    return static_cast<uint32_t>( column[0] ) << 24 |
+           static_cast<uint32_t>( column[1] ) << 16 |
+           static_cast<uint32_t>( column[2] ) << 8 |
+           static_cast<uint32_t>( column[3] );
+}
+
+
+/* Function: InvKeyExpansion
+ * Parameters: None
+ * Return: None
+ * Description: This function builds the decryption key schedule dw (FIPS-197 5.3.5) the first time it is needed. dw is w with
+ *              InvMixColumns applied to the round keys of rounds 1 .. Nr-1. The thread that wins the compare-exchange builds it and
+ *              any other thread that arrives meanwhile waits until it is published.
+*/
+template<int KeyBits>
+inline void AESFixed<KeyBits>::InvKeyExpansion() const
+{
+    if(this->inverseState.load(memory_order_acquire) == InverseReady)
+    {
+        return;
+    }
+
+    int expected = InverseNone;
+    if(this->inverseState.compare_exchange_strong(expected, InverseBuilding, memory_order_acquire))
+    {
+        const uint32_t* w = this->keys.data();
+        uint32_t* dw = this->keys.data() + PaddedWords;
+        for(int i = 0; i < ScheduleWords; i++)
+        {
+            dw[i] = i >= Nb && i < Nr * Nb ? InvMixColumnWord(w[i]) : w[i];
+        }
+        this->inverseState.store(InverseReady, memory_order_release);
+        return;
+    }
+
+    while(this->inverseState.load(memory_order_acquire) != InverseReady)
+    {
+        this_thread::yield();
+    }
+}
+
+
+
+
+// -------------------------------------- ROUND TRANSFORMATIONS --------------------------------------
+
+template<int KeyBits>
+inline void AESFixed<KeyBits>::AddRoundKey(uint8_t (&s)[16], const uint32_t* k)
+{
+    unroll<4>([&](auto c)
+    {
+        s[4 * c] ^= static_cast<uint8_t>( k[c] >> 24 );
+        s[4 * c + 1] ^= static_cast<uint8_t>( k[c] >> 16 );
+        s[4 * c + 2] ^= static_cast<uint8_t>( k[c] >> 8 );
+        s[4 * c + 3] ^= static_cast<uint8_t>( k[c] );
+    });
+}
+
+
+// SubBytes and ShiftRows commute, so both are applied in a single pass: row r of column c comes from column (c + r) mod 4
+template<int KeyBits>
+inline void AESFixed<KeyBits>::SubShiftRows(uint8_t (&s)[16])
+{
+    uint8_t t[16];
+
+    unroll<16>([&](auto i)
+    {
+        constexpr int r = i % 4;
+        constexpr int c = i / 4;
+        t[i] = AESTables::SBox[s[r + 4 * ((c + r) % 4)]];
+    });
+
+    unroll<16>([&](auto i) { s[i] = t[i]; });
+}
+
+
+template<int KeyBits>
+inline void AESFixed<KeyBits>::MixColumns(uint8_t (&s)[16])
+{
+    unroll<4>([&](auto c)
+    {
+        uint8_t s0 = s[4 * c];
+        uint8_t s1 = s[4 * c + 1];
+        uint8_t s2 = s[4 * c + 2];
+        uint8_t s3 = s[4 * c + 3];
+        uint8_t all = s0 ^ s1 ^ s2 ^ s3;
+
+        // {02}a ^ {03}b ^ c ^ d == a ^ {02}(a ^ b) ^ (a ^ b ^ c ^ d)
+        s[4 * c] = s0 ^ all ^ xtime(s0 ^ s1);
+        s[4 * c + 1] = s1 ^ all ^ xtime(s1 ^ s2);
+        s[4 * c + 2] = s2 ^ all ^ xtime(s2 ^ s3);
+        s[4 * c + 3] = s3 ^ all ^ xtime(s3 ^ s0);
+    });
+}
+
+
+// InvShiftRows moves row r of column c to column (c + r) mod 4
+template<int KeyBits>
+inline void AESFixed<KeyBits>::InvSubShiftRows(uint8_t (&s)[16])
+{
+    uint8_t t[16];
+
+    unroll<16>([&](auto i)
+    {
+        constexpr int r = i % 4;
+        constexpr int c = i / 4;
+        t[i] = AESTables::InvSBox[s[r + 4 * ((c + 4 - r) % 4)]];
+    });
+
+    unroll<16>([&](auto i) { s[i] = t[i]; });
+}
+
+
+template<int KeyBits>
+inline void AESFixed<KeyBits>::InvMixColumns(uint8_t (&s)[16])
+{
+    unroll<4>([&](auto c)
+    {
+        // {0e}, {0b}, {0d}, {09} decompose into the MixColumns matrix times {05}x^2 + {04}
+        uint8_t u = xtime(xtime(s[4 * c] ^ s[4 * c + 2]));
+        uint8_t v = xtime(xtime(s[4 * c + 1] ^ s[4 * c + 3]));
+
+        s[4 * c] ^= u;
+        s[4 * c + 1] ^= v;
+        s[4 * c + 2] ^= u;
+        s[4 * c + 3] ^= v;
+    });
+
+    MixColumns(s);
+}
+
+
+
+
+// -------------------------------------- CIPHER --------------------------------------
+
+/* Function: encryptBlock
+ * Parameters: A pointer to a 16 byte input block, a pointer to a 16 byte output block (may be the same as the input)
+ * Return: None
+ * Description: This function performs the AES cipher. The round loop is unrolled and every round key offset is a constant.
+*/
+template<int KeyBits>
+inline void AESFixed<KeyBits>::encryptBlock(const uint8_t* in, uint8_t* out) const
+{
+    const uint32_t* w = this->keys.data();
+    uint8_t s[16];
+    unroll<16>([&](auto i) { s[i] = in[i]; });
+
+    AddRoundKey(s, &w[0]);
+
+    unroll<Nr - 1>([&](auto round)
+    {
+        SubShiftRows(s);
+        MixColumns(s);
+        AddRoundKey(s, &w[(round + 1) * Nb]);
+    });
+
+    SubShiftRows(s);
+    AddRoundKey(s, &w[Nr * Nb]);
+
+    unroll<16>([&](auto i) { out[i] = s[i]; });
+}
+
+
+/* Function: decryptBlock
+ * Parameters: A pointer to a 16 byte input block, a pointer to a 16 byte output block (may be the same as the input)
+ * Return: None
+ * Description: This function performs the equivalent inverse cipher (FIPS-197 5.3.5). It runs the inverse transformations in
+ *              the same order as the cipher, using the decryption key schedule dw.
+*/
+template<int KeyBits>
+inline void AESFixed<KeyBits>::decryptBlock(const uint8_t* in, uint8_t* out) const
+{
+    const uint32_t* dw = inverseSchedule();
+    uint8_t s[16];
+    unroll<16>([&](auto i) { s[i] = in[i]; });
+
+    AddRoundKey(s, &dw[Nr * Nb]);
+
+    unroll<Nr - 1>([&](auto round)
+    {
+        InvSubShiftRows(s);
+        InvMixColumns(s);
+        AddRoundKey(s, &dw[(Nr - 1 - round) * Nb]);
+    });
+
+    InvSubShiftRows(s);
+    AddRoundKey(s, &dw[0]);
+
+    unroll<16>([&](auto i) { out[i] = s[i]; });
+}
+
+#endif
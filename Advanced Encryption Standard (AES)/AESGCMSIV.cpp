@@ -0,0 +1,260 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains AESGCMSIV method definitions.
+*/
+
+#include "AESGCMSIV.h"
+#include "Polyval.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "../Common/PerfCounters.h"
+#include "../Common/SecureMemory.h"
+
+
+// counter blocks put through the engine per call
+static const size_t ChunkBlocks = 64;
+
+// bytes open decrypts before hashing them, small enough to still be in the L1 cache
+static const size_t OpenChunkBytes = 4096;
+
+
+// the engine that takes each message's derived encryption key. One per thread, rekeyed in place and wiped after every
+// message, so sealing and opening allocate no schedule storage after the first message on a thread.
+static AESEngine& derivedEngine()
+{
+    thread_local AESEngine engine;
+    return engine;
+}
+
+
+static void checkLengths(size_t aadLength, size_t length)
+{
+    if(static_cast<uint64_t>( aadLength ) > AESGCMSIV::MaxLength || static_cast<uint64_t>( length ) > AESGCMSIV::MaxLength)
+    {
+        throw invalid_argument("AES-GCM-SIV plaintext and associated data are limited to 2^36 bytes");
+    }
+}
+
+
+/* Function: crypt
+ * Parameters: The message encryption engine, the counter block, the input, the output, the length in bytes
+ * Return: None
+ * Description: Counter mode as RFC 8452 defines it: the first 32 bits of the counter block are a little-endian integer that is
+ *              incremented modulo 2^32, and the other 96 bits stay fixed. The counter block is left at the next unused value,
+ *              so a message can be processed in pieces of whole blocks.
+*/
+static void crypt(const AESEngine& engine, uint8_t* counter, const uint8_t* in, uint8_t* out, size_t length)
+{
+    alignas(16) uint8_t counters[16 * ChunkBlocks];
+    alignas(16) uint8_t keystream[16 * ChunkBlocks];
+
+    uint32_t count = static_cast<uint32_t>( counter[0] ) | static_cast<uint32_t>( counter[1] ) << 8 |
+                     static_cast<uint32_t>( counter[2] ) << 16 | static_cast<uint32_t>( counter[3] ) << 24;
+
+    for(size_t offset = 0; offset < length; )
+    {
+        size_t bytes = min(sizeof(keystream), length - offset);
+        size_t blocks = (bytes + 15) / 16;
+        for(size_t b = 0; b < blocks; b++, count++)
+        {
+            uint8_t* block = counters + 16 * b;
+            block[0] = static_cast<uint8_t>( count );
+            block[1] = static_cast<uint8_t>( count >> 8 );
+            block[2] = static_cast<uint8_t>( count >> 16 );
+            block[3] = static_cast<uint8_t>( count >> 24 );
+            memcpy(block + 4, counter + 4, 12);
+        }
+
+        engine.encryptBlocks(counters, keystream, blocks);
+        for(size_t i = 0; i < bytes; i++)
+        {
+            out[offset + i] = in[offset + i] ^ keystream[i];
+        }
+        offset += bytes;
+    }
+
+    counter[0] = static_cast<uint8_t>( count );
+    counter[1] = static_cast<uint8_t>( count >> 8 );
+    counter[2] = static_cast<uint8_t>( count >> 16 );
+    counter[3] = static_cast<uint8_t>( count >> 24 );
+    secureZero(keystream, sizeof(keystream));
+}
+
+
+/* Function: computeTag
+ * Parameters: The message encryption engine, the POLYVAL over the padded associated data and plaintext, their lengths, the
+ *             nonce, the output
+ * Return: None
+ * Description: Absorbs the length block (both bit lengths as little-endian 64-bit integers), XORs the nonce into the first 12
+ *              bytes of S, clears its top bit and encrypts it
+*/
+static void computeTag(const AESEngine& engine, Polyval& polyval, size_t aadLength, size_t length, const uint8_t* nonce, uint8_t* tag)
+{
+    uint8_t lengths[16];
+    uint64_t aadBits = static_cast<uint64_t>( aadLength ) * 8;
+    uint64_t bits = static_cast<uint64_t>( length ) * 8;
+    for(int i = 0; i < 8; i++)
+    {
+        lengths[i] = static_cast<uint8_t>( aadBits >> (8 * i) );
+        lengths[8 + i] = static_cast<uint8_t>( bits >> (8 * i) );
+    }
+    polyval.update(lengths, 16);
+
+    uint8_t S[16];
+    polyval.digest(S);
+    for(size_t i = 0; i < AESGCMSIV::NonceSize; i++)
+    {
+        S[i] ^= nonce[i];
+    }
+    S[15] &= 0x7F;
+    engine.encryptBlock(S, tag);
+    secureZero(S, sizeof(S));
+}
+
+
+
+
+/* Function: Constructor
+ * Parameters: The key-generating key and its length in bytes
+ * Return: an AESGCMSIV object
+ * Description: RFC 8452 defines AEAD_AES_128_GCM_SIV and AEAD_AES_256_GCM_SIV; other key lengths throw invalid_argument
+*/
+AESGCMSIV::AESGCMSIV(const uint8_t* key, size_t keyLength)
+{
+    if(keyLength != 16 && keyLength != 32)
+    {
+        throw invalid_argument("AES-GCM-SIV keys must be 16 or 32 bytes");
+    }
+    this->keyGenerating.setKey(key, keyLength);
+}
+
+
+/* Function: deriveKeys
+ * Parameters: The nonce, the 16 byte POLYVAL key out, the engine that takes the message encryption key
+ * Return: None
+ * Description: Block i is the little-endian 32-bit i followed by the nonce. All of them (4, or 6 for 256-bit keys) are
+ *              encrypted under the key-generating key in one call, and the first 8 bytes of each are concatenated: blocks
+ *              0 and 1 give the POLYVAL key, the others the encryption key, of the same length as the key-generating key.
+*/
+void AESGCMSIV::deriveKeys(const uint8_t* nonce, uint8_t* authentication, AESEngine& encryption) const
+{
+    size_t keyBytes = static_cast<size_t>( this->keyGenerating.keyBits() ) / 8;
+    size_t count = 2 + keyBytes / 8;
+
+    alignas(16) uint8_t blocks[16 * 6] = {};
+    for(size_t i = 0; i < count; i++)
+    {
+        blocks[16 * i] = static_cast<uint8_t>( i );
+        memcpy(blocks + 16 * i + 4, nonce, NonceSize);
+    }
+    this->keyGenerating.encryptBlocks(blocks, blocks, count);
+
+    uint8_t key[32];
+    memcpy(authentication, blocks, 8);
+    memcpy(authentication + 8, blocks + 16, 8);
+    for(size_t i = 2; i < count; i++)
+    {
+        memcpy(key + 8 * (i - 2), blocks + 16 * i, 8);
+    }
+    encryption.setKey(key, keyBytes);
+
+    secureZero(key, sizeof(key));
+    secureZero(blocks, sizeof(blocks));
+}
+
+
+
+
+/* Function: seal
+ * Parameters: The nonce, the associated data and its length, the plaintext, its length, the ciphertext out, the tag out
+ * Return: None
+ * Description: First pass: POLYVAL over the associated data and the plaintext gives the tag. Second pass: counter mode from the
+ *              tag with its top bit set. The plaintext is read twice in place, so out may be in.
+*/
+void AESGCMSIV::seal(const uint8_t* nonce, const uint8_t* aad, size_t aadLength, const uint8_t* in, size_t length, uint8_t* out, uint8_t* tag) const
+{
+    PERF_SCOPE("AESGCMSIV::seal");
+    checkLengths(aadLength, length);
+
+    uint8_t authentication[16];
+    AESEngine& encryption = derivedEngine();
+    deriveKeys(nonce, authentication, encryption);
+
+    uint8_t T[TagSize];
+    {
+        Polyval polyval(authentication);
+        polyval.update(aad, aadLength);
+        polyval.update(in, length);
+        computeTag(encryption, polyval, aadLength, length, nonce, T);
+    }
+
+    uint8_t counter[16];
+    memcpy(counter, T, 16);
+    counter[15] |= 0x80;
+    crypt(encryption, counter, in, out, length);
+    memcpy(tag, T, TagSize);
+
+    secureZero(authentication, sizeof(authentication));
+    encryption.clear();
+}
+
+
+/* Function: open
+ * Parameters: The nonce, the associated data and its length, the ciphertext, its length, the tag, the plaintext out
+ * Return: Whether the tag is authentic
+ * Description: Decrypts OpenChunkBytes at a time and absorbs each decrypted chunk into POLYVAL right away. The tags are compared
+ *              in constant time, and on a mismatch the plaintext written so far is zeroed rather than released.
+*/
+bool AESGCMSIV::open(const uint8_t* nonce, const uint8_t* aad, size_t aadLength, const uint8_t* in, size_t length, const uint8_t* tag, uint8_t* out) const
+{
+    PERF_SCOPE("AESGCMSIV::open");
+    checkLengths(aadLength, length);
+
+    uint8_t authentication[16];
+    AESEngine& encryption = derivedEngine();
+    deriveKeys(nonce, authentication, encryption);
+
+    uint8_t counter[16];
+    memcpy(counter, tag, 16);
+    counter[15] |= 0x80;
+
+    uint8_t expected[TagSize];
+    {
+        Polyval polyval(authentication);
+        polyval.update(aad, aadLength);
+        for(size_t offset = 0; offset < length; offset += OpenChunkBytes)
+        {
+            size_t bytes = min(OpenChunkBytes, length - offset);
+            crypt(encryption, counter, in + offset, out + offset, bytes);
+            polyval.update(out + offset, bytes);
+        }
+        computeTag(encryption, polyval, aadLength, length, nonce, expected);
+    }
+
+    secureZero(authentication, sizeof(authentication));
+    encryption.clear();
+
+    uint8_t difference = 0;
+    for(size_t b = 0; b < TagSize; b++)
+    {
+        difference |= expected[b] ^ tag[b];
+    }
+    if(difference != 0)
+    {
+        secureZero(out, length);
+        return false;
+    }
+    return true;
+}
+
+
+void AESGCMSIV::clear()
+{
+    this->keyGenerating.clear();
+}
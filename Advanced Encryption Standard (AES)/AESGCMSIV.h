@@ -0,0 +1,48 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains AES-GCM-SIV (RFC 8452), the authenticated encryption mode that stays secure when a nonce
+ *                  is repeated: a repeated nonce only reveals whether two messages with the same associated data were equal.
+ *
+ *                  The key given to the constructor is the key-generating key; its schedule is expanded once. Every message
+ *                  derives its own POLYVAL key and AES encryption key from the nonce with one encryptBlocks call under that
+ *                  schedule. The tag is the encrypted POLYVAL of the associated data, the plaintext and their lengths, and it is
+ *                  also the initial counter block, so sealing takes two passes over the plaintext: POLYVAL, then counter mode.
+ *                  Neither pass copies it. Opening decrypts a chunk at a time and hashes each chunk while it is still in the L1
+ *                  cache, so it takes one pass over memory.
+*/
+
+#ifndef AES_GCM_SIV_H
+#define AES_GCM_SIV_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "AESEngine.h"
+
+using namespace std;
+
+class AESGCMSIV
+{
+    public:
+        static const size_t NonceSize = 12;
+        static const size_t TagSize = 16;
+        static const uint64_t MaxLength = uint64_t(1) << 36; // bytes of plaintext, and of associated data
+
+        AESGCMSIV(const uint8_t*, size_t); // key-generating key of 16 or 32 bytes
+
+        // in and out may be the same buffer; open zeroes out when the tag does not match
+        void seal(const uint8_t* nonce, const uint8_t* aad, size_t aadLength, const uint8_t* in, size_t length, uint8_t* out, uint8_t* tag) const;
+        bool open(const uint8_t* nonce, const uint8_t* aad, size_t aadLength, const uint8_t* in, size_t length, const uint8_t* tag, uint8_t* out) const;
+
+        void clear(); // wipe the key schedule
+
+    private:
+        AESEngine keyGenerating;
+
+        void deriveKeys(const uint8_t* nonce, uint8_t* authentication, AESEngine& encryption) const;
+};
+
+#endif
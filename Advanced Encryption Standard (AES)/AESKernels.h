@@ -0,0 +1,44 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file declares the per-ISA AES block, State, GF(2^8) and POLYVAL kernels. Each kernel lives in its own translation unit that the build
+ *                  compiles with the matching -m flags; without them the kernel is a stub that processes nothing. The kernels take
+ *                  the key schedule in the word layout used by AESFixed (w for encryption, the equivalent inverse schedule dw for
+ *                  decryption) and return the number of 16 byte blocks they processed, so the caller finishes any remainder.
+*/
+
+#ifndef AES_KERNELS_H
+#define AES_KERNELS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// AES-NI: 8 blocks in flight to cover the AESENC latency, then single blocks. Processes every block.
+size_t aesniEncryptBlocks(const uint32_t* w, int Nr, const uint8_t* in, uint8_t* out, size_t blocks);
+size_t aesniDecryptBlocks(const uint32_t* dw, int Nr, const uint8_t* in, uint8_t* out, size_t blocks);
+
+// VAES with AVX-512: four blocks per ZMM register, 16 blocks per iteration. Processes a multiple of 4 blocks.
+size_t vaesEncryptBlocks(const uint32_t* w, int Nr, const uint8_t* in, uint8_t* out, size_t blocks);
+size_t vaesDecryptBlocks(const uint32_t* dw, int Nr, const uint8_t* in, uint8_t* out, size_t blocks);
+
+// SSSE3 GF(2^8) arithmetic for GF256: 16 bytes per PSHUFB nibble lookup. The multiply returns the number of bytes it processed (a
+// multiple of 16) and MixColumns the number of 16 byte States (all of them).
+size_t gfMultiplySSSE3(uint8_t constant, const uint8_t* in, uint8_t* out, size_t length);
+size_t gfMixColumnsSSSE3(uint8_t* states, size_t count, bool inverse);
+
+// SSSE3 AESState byte permutation (ShiftRows, InvShiftRows): one PSHUFB per 16 byte State. Processes every State.
+size_t aesPermuteSSSE3(uint8_t* states, size_t count, const uint8_t* order);
+
+// SSSE3 round loops of the AES class block interface, the State in one register. They take the round keys as Nr + 1 States in
+// input order (AES::roundKeys), not the word schedule, and decrypt with the inverse cipher. Process every block.
+size_t aesCipherSSSE3(const uint8_t* roundKeys, int Nr, const uint8_t* in, uint8_t* out, size_t blocks);
+size_t aesInvCipherSSSE3(const uint8_t* roundKeys, int Nr, const uint8_t* in, uint8_t* out, size_t blocks);
+
+// PCLMULQDQ POLYVAL for Polyval: the first count powers H^1, H^2, ... of H (returns count), and the update of S over whole
+// blocks, eight per reduction with H^1 ... H^8 (processes every block).
+size_t polyvalPowersCLMUL(const uint8_t* H, uint8_t* powers, size_t count);
+size_t polyvalCLMUL(const uint8_t* powers, uint8_t* S, const uint8_t* in, size_t blocks);
+
+#endif
@@ -0,0 +1,511 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains AESKeyCache method definitions.
+*/
+
+#include "AESKeyCache.h"
+
+#include <stdexcept>
+
+#include "../Common/PerfCounters.h"
+
+
+// index cells hold an entry number plus one, or one of these
+static const uint32_t Empty = 0;
+static const uint32_t Tombstone = UINT32_MAX;
+
+// set in an entry's pin count while a writer owns the entry; readers that see it back off
+static const uint32_t Evicting = 1u << 31;
+
+
+struct alignas(64) AESKeyCache::Entry
+{
+    atomic<uint32_t> pins;
+    atomic<bool> referenced; // CLOCK bit, set by hits
+    atomic<bool> live; // holds the key named by keyId and is reachable from the index
+    atomic<uint64_t> keyId;
+    AESEngine engine;
+
+    Entry() : pins(0), referenced(false), live(false), keyId(0)
+    {
+    }
+};
+
+
+struct alignas(64) AESKeyCache::Shard
+{
+    mutex lock; // taken by writers only
+    unique_ptr<Entry[]> entries;
+    unique_ptr<atomic<uint32_t>[]> index;
+    size_t indexMask;
+
+    // under lock
+    size_t occupied; // index cells that are not Empty
+    size_t size; // live entries
+    size_t hand; // CLOCK hand
+
+    atomic<uint64_t> hits;
+    atomic<uint64_t> misses;
+    atomic<uint64_t> evictions;
+};
+
+
+// finalizer of splitmix64; the low bits pick the shard and the high bits the index cell
+static uint64_t mixKeyId(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+
+
+
+/* Function: Constructor
+ * Parameters: The number of keys to hold, the number of shards
+ * Return: an AESKeyCache object
+ * Description: The capacity is spread evenly over the shards (rounding up), and each shard's index has at least twice as many
+ *              cells as entries so probe runs stay short. Everything is allocated here.
+*/
+AESKeyCache::AESKeyCache(size_t capacity, size_t shards)
+{
+    if(capacity == 0 || shards == 0)
+    {
+        throw invalid_argument("AESKeyCache needs a capacity and at least one shard");
+    }
+
+    this->shardCount = min(shards, capacity);
+    this->shardCapacity = (capacity + this->shardCount - 1) / this->shardCount;
+    this->shards.reset(new Shard[this->shardCount]);
+
+    size_t cells = 1;
+    while(cells < 2 * this->shardCapacity)
+    {
+        cells <<= 1;
+    }
+
+    for(size_t s = 0; s < this->shardCount; s++)
+    {
+        Shard& shard = this->shards[s];
+        shard.entries.reset(new Entry[this->shardCapacity]);
+        shard.index.reset(new atomic<uint32_t>[cells]);
+        for(size_t c = 0; c < cells; c++)
+        {
+            shard.index[c].store(Empty, memory_order_relaxed);
+        }
+        shard.indexMask = cells - 1;
+        shard.occupied = 0;
+        shard.size = 0;
+        shard.hand = 0;
+        shard.hits.store(0, memory_order_relaxed);
+        shard.misses.store(0, memory_order_relaxed);
+        shard.evictions.store(0, memory_order_relaxed);
+    }
+}
+
+
+AESKeyCache::~AESKeyCache()
+{
+    for(size_t s = 0; s < this->shardCount; s++)
+    {
+        for(size_t e = 0; e < this->shardCapacity; e++)
+        {
+            this->shards[s].entries[e].engine.clear();
+        }
+    }
+}
+
+
+
+
+AESKeyCache::Shard& AESKeyCache::shardOf(uint64_t hash) const
+{
+    return this->shards[hash % this->shardCount];
+}
+
+
+size_t AESKeyCache::capacity() const
+{
+    return this->shardCount * this->shardCapacity;
+}
+
+
+/* Function: memoryFootprint
+ * Parameters: None
+ * Return: The bytes held by the cache
+ * Description: The shards, entry pools and indexes allocated by the constructor, plus the schedule storage of every entry that has
+ *              held a key: a 64 byte aligned block per entry, or the whole pages it was given when key memory locking is on.
+*/
+size_t AESKeyCache::memoryFootprint() const
+{
+    size_t cells = this->shards[0].indexMask + 1;
+    size_t bytes = sizeof(*this) + this->shardCount * (sizeof(Shard) + this->shardCapacity * sizeof(Entry) + cells * sizeof(atomic<uint32_t>));
+
+    for(size_t s = 0; s < this->shardCount; s++)
+    {
+        Shard& shard = this->shards[s];
+        lock_guard<mutex> guard(shard.lock); // install() rekeys under it
+        for(size_t e = 0; e < this->shardCapacity; e++)
+        {
+            bytes += shard.entries[e].engine.footprint();
+        }
+    }
+    return bytes;
+}
+
+
+AESKeyCacheStats AESKeyCache::stats() const
+{
+    AESKeyCacheStats total = {0, 0, 0, 0};
+    for(size_t s = 0; s < this->shardCount; s++)
+    {
+        Shard& shard = this->shards[s];
+        total.hits += shard.hits.load(memory_order_relaxed);
+        total.misses += shard.misses.load(memory_order_relaxed);
+        total.evictions += shard.evictions.load(memory_order_relaxed);
+
+        lock_guard<mutex> guard(shard.lock);
+        total.size += shard.size;
+    }
+    return total;
+}
+
+
+
+
+/* Function: find
+ * Parameters: The key ID
+ * Return: A handle on the key's engine, or an empty handle when the key is not cached
+ * Description: Probes the shard's index without taking its lock. Index cells can change while they are read, so a cell only
+ *              leads to a candidate entry; pin() makes the final check. A find that races with an insert into the same shard may
+ *              miss a key that is present.
+*/
+AESKeyCache::Handle AESKeyCache::find(uint64_t keyId) const
+{
+    uint64_t hash = mixKeyId(keyId);
+    Shard& shard = shardOf(hash);
+    size_t mask = shard.indexMask;
+    size_t position = (hash >> 32) & mask;
+
+    for(size_t probe = 0; probe <= mask; probe++, position = (position + 1) & mask)
+    {
+        uint32_t cell = shard.index[position].load(memory_order_acquire);
+        if(cell == Empty)
+        {
+            break;
+        }
+        if(cell == Tombstone)
+        {
+            continue;
+        }
+
+        Entry& entry = shard.entries[cell - 1];
+        if(entry.keyId.load(memory_order_relaxed) != keyId)
+        {
+            continue;
+        }
+
+        if(pin(entry, keyId))
+        {
+            // write the bit only when it changes, so hot keys do not keep bouncing the line between cores
+            if(!entry.referenced.load(memory_order_relaxed))
+            {
+                entry.referenced.store(true, memory_order_relaxed);
+            }
+            shard.hits.fetch_add(1, memory_order_relaxed);
+            return Handle(&entry);
+        }
+        break;
+    }
+
+    shard.misses.fetch_add(1, memory_order_relaxed);
+    return Handle();
+}
+
+
+
+
+/* Function: pin
+ * Parameters: An entry, the key ID expected in it
+ * Return: Whether the entry was pinned
+ * Description: Raising the pin count first stops any writer from taking the entry, so once the checks pass the entry can not
+ *              change under the reader. A writer that already owns the entry shows up as the Evicting bit.
+*/
+bool AESKeyCache::pin(Entry& entry, uint64_t keyId)
+{
+    uint32_t previous = entry.pins.fetch_add(1, memory_order_acquire);
+    if((previous & Evicting) == 0 && entry.live.load(memory_order_acquire) && entry.keyId.load(memory_order_relaxed) == keyId)
+    {
+        return true;
+    }
+
+    entry.pins.fetch_sub(1, memory_order_release);
+    return false;
+}
+
+
+
+
+/* Function: unpin
+ * Parameters: A pinned entry
+ * Return: None
+ * Description: Drops a pin. The last handle on an entry that was erased or replaced meanwhile wipes its schedules, owning the
+ *              entry through the Evicting bit just as a writer would.
+*/
+void AESKeyCache::unpin(Entry* entry)
+{
+    if(entry->pins.fetch_sub(1, memory_order_acq_rel) != 1 || entry->live.load(memory_order_acquire))
+    {
+        return;
+    }
+
+    uint32_t unpinned = 0;
+    if(entry->pins.compare_exchange_strong(unpinned, Evicting, memory_order_acquire))
+    {
+        if(!entry->live.load(memory_order_relaxed))
+        {
+            entry->engine.clear();
+        }
+        entry->pins.fetch_sub(Evicting, memory_order_release);
+    }
+}
+
+
+
+
+// The index helpers below run with the shard lock held
+
+// position of the index cell of the live entry holding keyId, or SIZE_MAX
+size_t AESKeyCache::locate(const Shard& shard, uint64_t hash, uint64_t keyId)
+{
+    size_t mask = shard.indexMask;
+    size_t position = (hash >> 32) & mask;
+    for(size_t probe = 0; probe <= mask; probe++, position = (position + 1) & mask)
+    {
+        uint32_t cell = shard.index[position].load(memory_order_relaxed);
+        if(cell == Empty)
+        {
+            break;
+        }
+
+        if(cell == Tombstone)
+        {
+            continue;
+        }
+
+        const Entry& entry = shard.entries[cell - 1];
+        if(entry.live.load(memory_order_relaxed) && entry.keyId.load(memory_order_relaxed) == keyId)
+        {
+            return position;
+        }
+    }
+    return SIZE_MAX;
+}
+
+
+// point the first free cell from the hash's home cell at entry number
+void AESKeyCache::place(Shard& shard, uint64_t hash, size_t number)
+{
+    size_t mask = shard.indexMask;
+    size_t position = (hash >> 32) & mask;
+    while(true)
+    {
+        uint32_t cell = shard.index[position].load(memory_order_relaxed);
+        if(cell == Empty || cell == Tombstone)
+        {
+            shard.occupied += cell == Empty ? 1 : 0;
+            shard.index[position].store(static_cast<uint32_t>( number + 1 ), memory_order_release);
+            return;
+        }
+        position = (position + 1) & mask;
+    }
+}
+
+
+// unlink the entry at an index cell and wipe it now, or, if a handle still holds it, when unpin() releases the last one
+void AESKeyCache::retire(Shard& shard, size_t position)
+{
+    Entry& entry = shard.entries[shard.index[position].load(memory_order_relaxed) - 1];
+    shard.index[position].store(Tombstone, memory_order_release);
+    entry.live.store(false, memory_order_release);
+    entry.referenced.store(false, memory_order_relaxed);
+    shard.size--;
+
+    uint32_t unpinned = 0;
+    if(entry.pins.compare_exchange_strong(unpinned, Evicting, memory_order_acquire))
+    {
+        entry.engine.clear();
+        entry.pins.fetch_sub(Evicting, memory_order_release);
+    }
+}
+
+
+
+
+/* Function: install
+ * Parameters: The key ID, the key and its length, whether an older key under the same ID is replaced
+ * Return: A handle on the installed (or, without replace, already cached) key
+ * Description: With the shard locked, any older entry for the key ID is retired and an entry is claimed for the new key:
+ *              an unused one while the shard has room, otherwise the first unpinned entry the clock hand reaches with its
+ *              referenced bit clear. The claimed entry is wiped, keyed, and published by clearing its Evicting bit, which
+ *              readers acquire when they pin it.
+*/
+AESKeyCache::Handle AESKeyCache::install(uint64_t keyId, const uint8_t* key, size_t keyLength, bool replace)
+{
+    if(keyLength != 16 && keyLength != 24 && keyLength != 32)
+    {
+        throw invalid_argument("AES key must be 16, 24 or 32 bytes");
+    }
+
+    PERF_SCOPE("AESKeyCache::install");
+
+    uint64_t hash = mixKeyId(keyId);
+    Shard& shard = shardOf(hash);
+    size_t mask = shard.indexMask;
+    lock_guard<mutex> guard(shard.lock);
+
+    size_t existing = locate(shard, hash, keyId);
+    if(existing != SIZE_MAX)
+    {
+        if(!replace)
+        {
+            // another thread loaded it first
+            Entry& entry = shard.entries[shard.index[existing].load(memory_order_relaxed) - 1];
+            entry.pins.fetch_add(1, memory_order_acquire);
+            return Handle(&entry);
+        }
+        retire(shard, existing);
+    }
+
+    // claim an entry
+    Entry* victim = nullptr;
+    for(size_t e = 0; e < this->shardCapacity && shard.size < this->shardCapacity && victim == nullptr; e++)
+    {
+        Entry& entry = shard.entries[e];
+        uint32_t unpinned = 0;
+        if(!entry.live.load(memory_order_relaxed) && entry.pins.compare_exchange_strong(unpinned, Evicting, memory_order_acquire))
+        {
+            victim = &entry;
+        }
+    }
+    for(size_t step = 0; step < 3 * this->shardCapacity && victim == nullptr; step++)
+    {
+        Entry& entry = shard.entries[shard.hand];
+        shard.hand = (shard.hand + 1) % this->shardCapacity;
+
+        if(entry.pins.load(memory_order_relaxed) != 0 || entry.referenced.exchange(false, memory_order_relaxed))
+        {
+            continue;
+        }
+        uint32_t unpinned = 0;
+        if(entry.pins.compare_exchange_strong(unpinned, Evicting, memory_order_acquire))
+        {
+            victim = &entry;
+        }
+    }
+    if(victim == nullptr)
+    {
+        throw runtime_error("AESKeyCache: every entry of the shard is pinned");
+    }
+
+    if(victim->live.load(memory_order_relaxed))
+    {
+        uint64_t victimId = victim->keyId.load(memory_order_relaxed);
+        shard.index[locate(shard, mixKeyId(victimId), victimId)].store(Tombstone, memory_order_release);
+        victim->live.store(false, memory_order_relaxed);
+        shard.size--;
+        shard.evictions.fetch_add(1, memory_order_relaxed);
+    }
+
+    victim->engine.clear();
+    victim->engine.setKey(key, keyLength);
+    victim->keyId.store(keyId, memory_order_relaxed);
+    victim->referenced.store(false, memory_order_relaxed); // the hand has just passed it, so it already has a full turn
+    victim->live.store(true, memory_order_release);
+    shard.size++;
+
+    // keep a quarter of the cells Empty so misses end quickly; rebuilding drops the tombstones
+    if(shard.occupied + 1 > 3 * (mask + 1) / 4)
+    {
+        for(size_t c = 0; c <= mask; c++)
+        {
+            shard.index[c].store(Empty, memory_order_release);
+        }
+        shard.occupied = 0;
+        for(size_t e = 0; e < this->shardCapacity; e++)
+        {
+            if(&shard.entries[e] != victim && shard.entries[e].live.load(memory_order_relaxed))
+            {
+                place(shard, mixKeyId(shard.entries[e].keyId.load(memory_order_relaxed)), e);
+            }
+        }
+    }
+    place(shard, hash, static_cast<size_t>( victim - shard.entries.get() ));
+
+    // publish, keeping one pin for the returned handle
+    victim->pins.fetch_sub(Evicting - 1, memory_order_release);
+    return Handle(victim);
+}
+
+
+AESKeyCache::Handle AESKeyCache::insert(uint64_t keyId, const uint8_t* key, size_t keyLength)
+{
+    return install(keyId, key, keyLength, true);
+}
+
+
+
+
+/* Function: erase
+ * Parameters: The key ID
+ * Return: None
+ * Description: Removes the key from the index and wipes its schedules, at once or when the last handle on it is released
+*/
+void AESKeyCache::erase(uint64_t keyId)
+{
+    uint64_t hash = mixKeyId(keyId);
+    Shard& shard = shardOf(hash);
+    lock_guard<mutex> guard(shard.lock);
+
+    size_t position = locate(shard, hash, keyId);
+    if(position != SIZE_MAX)
+    {
+        retire(shard, position);
+    }
+}
+
+
+
+
+void AESKeyCache::Handle::reset()
+{
+    if(this->entry != nullptr)
+    {
+        unpin(this->entry);
+        this->entry = nullptr;
+    }
+}
+
+
+AESKeyCache::Handle& AESKeyCache::Handle::operator=(Handle&& other)
+{
+    if(this != &other)
+    {
+        reset();
+        this->entry = other.entry;
+        other.entry = nullptr;
+    }
+    return *this;
+}
+
+
+const AESEngine& AESKeyCache::Handle::engine() const
+{
+    return this->entry->engine;
+}
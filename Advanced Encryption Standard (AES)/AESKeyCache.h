@@ -0,0 +1,123 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains AESKeyCache, a bounded cache of expanded key schedules keyed by a 64-bit key ID, for servers
+ *                  that switch between thousands of tenant keys per request. The entries are split across shards by a hash of the
+ *                  key ID. Each shard has a fixed pool of entries and an open addressing index, both allocated up front. The
+ *                  schedule storage of an entry is allocated by the first key it holds and kept through evictions, only replaced
+ *                  when a key of another size moves in, so the footprint is bounded by the capacity times the largest schedule
+ *                  (a page per entry with key memory locking on) and stops growing once every entry has been used.
+ *
+ *                  A hit takes no lock. The reader probes the index, pins the entry by raising its pin count, and then checks that
+ *                  the entry still holds the key ID it asked for. Inserts and evictions take the shard's mutex. Eviction follows
+ *                  LRU by the CLOCK approximation. A hit sets the entry's referenced bit, and the clock hand clears that bit and
+ *                  passes over the entry once before it can be evicted. An entry is only replaced once its pin count is zero, and
+ *                  its schedules are wiped before it is reused.
+*/
+
+#ifndef AES_KEY_CACHE_H
+#define AES_KEY_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "AESEngine.h"
+#include "../Common/SecureMemory.h"
+
+using namespace std;
+
+struct AESKeyCacheStats
+{
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t size; // keys held
+};
+
+class AESKeyCache
+{
+    struct Entry;
+    struct Shard;
+
+    public:
+        // A pinned entry; the engine stays valid and keyed until the handle is destroyed or reset
+        class Handle
+        {
+            public:
+                Handle() : entry(nullptr) {}
+                Handle(Handle&& other) : entry(other.entry) { other.entry = nullptr; }
+                Handle& operator=(Handle&&);
+                Handle(const Handle&) = delete;
+                Handle& operator=(const Handle&) = delete;
+                ~Handle() { reset(); }
+
+                void reset();
+                explicit operator bool() const { return entry != nullptr; }
+                const AESEngine& engine() const;
+                const AESEngine* operator->() const { return &engine(); }
+
+            private:
+                friend class AESKeyCache;
+                explicit Handle(Entry* entry) : entry(entry) {}
+                Entry* entry;
+        };
+
+        AESKeyCache(size_t capacity, size_t shards = 16);
+        ~AESKeyCache(); // wipes every schedule
+        AESKeyCache(const AESKeyCache&) = delete;
+        AESKeyCache& operator=(const AESKeyCache&) = delete;
+
+        Handle find(uint64_t) const; // lock-free; an empty handle on a miss
+        Handle insert(uint64_t, const uint8_t*, size_t); // expand a 16, 24 or 32 byte key under the key ID, replacing any older key
+        void erase(uint64_t);
+
+        // find, or on a miss call load(keyId, key) to fetch up to 32 key bytes into key and return their count, then insert
+        template<typename Loader>
+        Handle get(uint64_t keyId, Loader&& load)
+        {
+            Handle handle = find(keyId);
+            if(handle)
+            {
+                return handle;
+            }
+
+            uint8_t key[32];
+            size_t length = load(keyId, key);
+            try
+            {
+                handle = install(keyId, key, length, false);
+            }
+            catch(...)
+            {
+                secureZero(key, sizeof(key));
+                throw;
+            }
+            secureZero(key, sizeof(key));
+            return handle;
+        }
+
+        size_t capacity() const;
+        size_t memoryFootprint() const; // bytes held by the entry pools, the indexes and the schedules
+        AESKeyCacheStats stats() const;
+
+    private:
+        unique_ptr<Shard[]> shards;
+        size_t shardCount;
+        size_t shardCapacity; // entries per shard
+
+        Shard& shardOf(uint64_t hash) const;
+        Handle install(uint64_t, const uint8_t*, size_t, bool);
+
+        static bool pin(Entry&, uint64_t);
+        static void unpin(Entry*);
+        static size_t locate(const Shard&, uint64_t, uint64_t);
+        static void place(Shard&, uint64_t, size_t);
+        static void retire(Shard&, size_t);
+};
+
+#endif
@@ -0,0 +1,217 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the counter mode and XTS definitions.
+*/
+
+#include "AESModes.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "../Common/Parallel.h"
+#include "../Common/PerfCounters.h"
+#include "../Common/SecureMemory.h"
+
+
+// blocks put through the engine per call; enough to keep every pipelined kernel full
+static const size_t ChunkBlocks = 64;
+
+// bytes of counter mode input per parallel item
+static const size_t CtrPieceBytes = 64 * 1024;
+
+// bytes of XTS sectors per parallel item, at least one sector
+static const size_t XtsPieceBytes = 64 * 1024;
+
+
+// counter block plus a block count, as a 128-bit big-endian integer
+static void addCounter(const uint8_t* counter, uint64_t blocks, uint8_t* out)
+{
+    uint64_t carry = blocks;
+    for(int i = 15; i >= 0; i--)
+    {
+        uint64_t sum = counter[i] + (carry & 0xFF);
+        out[i] = static_cast<uint8_t>( sum );
+        carry = (carry >> 8) + (sum >> 8);
+    }
+}
+
+
+static void incrementCounter(uint8_t* counter)
+{
+    for(int i = 15; i >= 0 && ++counter[i] == 0; i--)
+    {
+    }
+}
+
+
+
+
+/* Function: aesCtrCrypt
+ * Parameters: The engine, the initial counter block, the input, the output, the length in bytes, the number of threads
+ * Return: None
+ * Description: Each 64 KiB piece derives its first counter block from the initial one, so pieces run in any order. Within a
+ *              piece, ChunkBlocks counter blocks are encrypted per call and XORed into the output. The keystream is as good as
+ *              the plaintext to anyone holding the output, so each piece wipes it, with its counters, before returning.
+*/
+void aesCtrCrypt(const AESEngine& engine, const uint8_t* counter, const uint8_t* in, uint8_t* out, size_t length, unsigned threads)
+{
+    PERF_SCOPE("aesCtrCrypt");
+
+    size_t pieces = (length + CtrPieceBytes - 1) / CtrPieceBytes;
+    parallelFor(pieces, threads, [&](size_t p)
+    {
+        size_t offset = CtrPieceBytes * p;
+        size_t end = min(length, offset + CtrPieceBytes);
+
+        uint8_t counters[16 * ChunkBlocks];
+        uint8_t keystream[16 * ChunkBlocks];
+        uint8_t next[16];
+        addCounter(counter, offset / 16, next);
+
+        while(offset < end)
+        {
+            size_t bytes = min(sizeof(keystream), end - offset);
+            size_t blocks = (bytes + 15) / 16;
+            for(size_t b = 0; b < blocks; b++)
+            {
+                memcpy(counters + 16 * b, next, 16);
+                incrementCounter(next);
+            }
+
+            engine.encryptBlocks(counters, keystream, blocks);
+            for(size_t i = 0; i < bytes; i++)
+            {
+                out[offset + i] = in[offset + i] ^ keystream[i];
+            }
+            offset += bytes;
+        }
+
+        secureZero(counters, sizeof(counters));
+        secureZero(keystream, sizeof(keystream));
+        secureZero(next, sizeof(next));
+    });
+}
+
+
+
+
+/* Function: Constructor
+ * Parameters: The data key, the tweak key, their common length in bytes
+ * Return: an AESXTS object
+ * Description: XTS-AES is defined for 128 and 256-bit keys. SP 800-38E requires the two keys to differ.
+*/
+AESXTS::AESXTS(const uint8_t* dataKey, const uint8_t* tweakKey, size_t keyLength)
+{
+    if(keyLength != 16 && keyLength != 32)
+    {
+        throw invalid_argument("XTS-AES keys must be 16 or 32 bytes");
+    }
+    if(memcmp(dataKey, tweakKey, keyLength) == 0)
+    {
+        throw invalid_argument("XTS-AES data and tweak keys must differ");
+    }
+
+    this->data.setKey(dataKey, keyLength);
+    this->tweak.setKey(tweakKey, keyLength);
+}
+
+
+void AESXTS::encryptSectors(const uint8_t* in, uint8_t* out, size_t sectorSize, uint64_t firstSector, size_t sectors, unsigned threads) const
+{
+    PERF_BATCH_SCOPE("AESXTS::encryptSectors", sectors);
+    crypt(in, out, sectorSize, firstSector, sectors, threads, true);
+}
+
+
+void AESXTS::decryptSectors(const uint8_t* in, uint8_t* out, size_t sectorSize, uint64_t firstSector, size_t sectors, unsigned threads) const
+{
+    PERF_BATCH_SCOPE("AESXTS::decryptSectors", sectors);
+    crypt(in, out, sectorSize, firstSector, sectors, threads, false);
+}
+
+
+/* Function: crypt
+ * Parameters: The input, the output, the sector size, the first sector number, the sector count, the number of threads, the
+ *             direction
+ * Return: None
+ * Description: Sectors are independent, so groups of them are spread over the pool. For each sector the tweak T = AES(tweakKey,
+ *              sector number) is multiplied by alpha (x in GF(2^128), little-endian) from block to block. A chunk of blocks is
+ *              XORed with its tweaks, put through the data key in one call, and XORed with the same tweaks again. The tweaks and
+ *              the buffer are wiped before a piece returns, as the CTR keystream is.
+*/
+void AESXTS::crypt(const uint8_t* in, uint8_t* out, size_t sectorSize, uint64_t firstSector, size_t sectors, unsigned threads, bool encrypt) const
+{
+    if(sectorSize == 0 || sectorSize % 16 != 0)
+    {
+        throw invalid_argument("XTS sector size must be a non-zero multiple of 16 bytes");
+    }
+
+    size_t perPiece = max<size_t>(1, XtsPieceBytes / sectorSize);
+    size_t pieces = (sectors + perPiece - 1) / perPiece;
+
+    parallelFor(pieces, threads, [&](size_t p)
+    {
+        uint8_t tweaks[16 * ChunkBlocks];
+        uint8_t buffer[16 * ChunkBlocks];
+
+        size_t last = min(sectors, perPiece * (p + 1));
+        for(size_t s = perPiece * p; s < last; s++)
+        {
+            uint8_t T[16] = {};
+            uint64_t sector = firstSector + s;
+            for(int i = 0; i < 8; i++)
+            {
+                T[i] = static_cast<uint8_t>( sector >> (8 * i) );
+            }
+            this->tweak.encryptBlock(T, T);
+
+            const uint8_t* source = in + sectorSize * s;
+            uint8_t* target = out + sectorSize * s;
+
+            for(size_t offset = 0; offset < sectorSize; offset += sizeof(buffer))
+            {
+                size_t bytes = min(sizeof(buffer), sectorSize - offset);
+
+                for(size_t b = 0; b < bytes / 16; b++)
+                {
+                    memcpy(tweaks + 16 * b, T, 16);
+
+                    // T = T * alpha
+                    uint8_t carry = T[15] >> 7;
+                    for(int i = 15; i > 0; i--)
+                    {
+                        T[i] = static_cast<uint8_t>( (T[i] << 1) | (T[i - 1] >> 7) );
+                    }
+                    T[0] = static_cast<uint8_t>( (T[0] << 1) ^ (carry * 0x87) );
+                }
+
+                for(size_t i = 0; i < bytes; i++)
+                {
+                    buffer[i] = source[offset + i] ^ tweaks[i];
+                }
+
+                if(encrypt)
+                {
+                    this->data.encryptBlocks(buffer, buffer, bytes / 16);
+                }
+                else
+                {
+                    this->data.decryptBlocks(buffer, buffer, bytes / 16);
+                }
+
+                for(size_t i = 0; i < bytes; i++)
+                {
+                    target[offset + i] = buffer[i] ^ tweaks[i];
+                }
+            }
+            secureZero(T, sizeof(T));
+        }
+
+        secureZero(tweaks, sizeof(tweaks));
+        secureZero(buffer, sizeof(buffer));
+    });
+}
@@ -0,0 +1,45 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the bulk confidentiality modes built on AESEngine. Both split their input into independent
+ *                  pieces and run them on the shared ThreadPool:
+ *
+ *                    - aesCtrCrypt: counter mode (NIST SP 800-38A) with the whole 16 byte counter block incremented as one
+ *                      big-endian integer. The input is cut into 64 KiB pieces, each starting at its own counter value.
+ *                    - AESXTS: XTS-AES (IEEE 1619, NIST SP 800-38E) over whole sectors. The tweak of a sector is its number as
+ *                      a little-endian 128-bit integer. Sector sizes must be a multiple of 16 bytes; ciphertext stealing for
+ *                      partial blocks is not supported.
+*/
+
+#ifndef AES_MODES_H
+#define AES_MODES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "AESEngine.h"
+
+using namespace std;
+
+// Encrypts or decrypts length bytes starting from the 16 byte initial counter block; in and out may be the same buffer
+void aesCtrCrypt(const AESEngine&, const uint8_t* counter, const uint8_t* in, uint8_t* out, size_t length, unsigned threads = 0);
+
+class AESXTS
+{
+    public:
+        AESXTS(const uint8_t*, const uint8_t*, size_t); // data key, tweak key (must differ), common length of 16 or 32 bytes
+
+        // sectors consecutive sectors of sectorSize bytes, the first one numbered firstSector; in and out may be the same buffer
+        void encryptSectors(const uint8_t*, uint8_t*, size_t sectorSize, uint64_t firstSector, size_t sectors, unsigned threads = 0) const;
+        void decryptSectors(const uint8_t*, uint8_t*, size_t sectorSize, uint64_t firstSector, size_t sectors, unsigned threads = 0) const;
+
+    private:
+        AESEngine data;
+        AESEngine tweak;
+
+        void crypt(const uint8_t*, uint8_t*, size_t, uint64_t, size_t, unsigned, bool) const;
+};
+
+#endif
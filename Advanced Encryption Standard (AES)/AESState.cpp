@@ -0,0 +1,76 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the AESState operations that are not inline: the S-Box substitutions, the column mixing
+ *                  and the run time choice of the ShiftRows kernel.
+*/
+
+#include "AESState.h"
+#include "AESKernels.h"
+#include "AESTables.h"
+#include "GF256.h"
+#include "../Common/CpuFeatures.h"
+
+
+/* Function: subBytes / invSubBytes
+ * Parameters: None
+ * Return: None
+ * Description: Each byte is replaced by its S-Box (or inverse S-Box) entry
+*/
+void AESState::subBytes()
+{
+    for(int i = 0; i < 16; i++)
+    {
+        this->bytes[i] = AESTables::SBox[this->bytes[i]];
+    }
+}
+
+
+void AESState::invSubBytes()
+{
+    for(int i = 0; i < 16; i++)
+    {
+        this->bytes[i] = AESTables::InvSBox[this->bytes[i]];
+    }
+}
+
+
+/* Function: mixColumns / invMixColumns
+ * Parameters: None
+ * Return: None
+ * Description: The State is already in the input order GF256 takes, so all four columns are mixed in place in one call
+*/
+void AESState::mixColumns()
+{
+    GF256::mixColumns(this->bytes);
+}
+
+
+void AESState::invMixColumns()
+{
+    GF256::invMixColumns(this->bytes);
+}
+
+
+/* Function: permute
+ * Parameters: The source index of every output byte
+ * Return: None
+ * Description: The ShiftRows fallback for translation units built without SSSE3: the PSHUFB kernel when the CPU has it,
+ *              otherwise a byte by byte copy
+*/
+void AESState::permute(const uint8_t* order)
+{
+    if(cpuFeatures().ssse3 && aesPermuteSSSE3(this->bytes, 1, order) == 1)
+    {
+        return;
+    }
+
+    uint8_t source[16];
+    memcpy(source, this->bytes, 16);
+    for(int i = 0; i < 16; i++)
+    {
+        this->bytes[i] = source[order[i]];
+    }
+}
@@ -0,0 +1,133 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains AESState, the State of the AES class as one 128-bit value. The 16 bytes are kept in input
+ *                  order, byte (r, c) at r + 4c, so a block is loaded and stored with a single unaligned move and no transpose,
+ *                  and a round key in the same order is added with a single PXOR.
+ *
+ *                  On x86 the bytes share a union with an __m128i, so the compiler keeps the State in an XMM register between
+ *                  the inline operations. ShiftRows and InvShiftRows are one PSHUFB each: inline when the translation unit is
+ *                  built with SSSE3, otherwise through the SSSE3 kernel chosen at run time. MixColumns and InvMixColumns use the
+ *                  GF256 packed multiply. Every operation has a portable fallback on the bytes. Code that runs whole blocks, like
+ *                  the AES class block interface, should choose a kernel built with SSSE3 once (AESKernels.h) rather than pay
+ *                  the run time choice in every round.
+*/
+
+#ifndef AES_STATE_H
+#define AES_STATE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+class alignas(16) AESState
+{
+    public:
+        static AESState load(const uint8_t* in);
+        static AESState fromWords(const uint32_t* w); // four key schedule words, byte 0 of each column in the high byte
+        void store(uint8_t* out) const;
+
+        uint8_t& operator()(int row, int column) { return this->bytes[row + 4 * column]; }
+        uint8_t operator()(int row, int column) const { return this->bytes[row + 4 * column]; }
+        const uint8_t* data() const { return this->bytes; }
+
+        void addRoundKey(const AESState&);
+        void subBytes();
+        void invSubBytes();
+        void shiftRows();
+        void invShiftRows();
+        void mixColumns();
+        void invMixColumns();
+
+        // the source byte of every output byte, as PSHUFB takes it: row r of column c comes from column c + r, or c - r
+        alignas(16) static constexpr uint8_t ShiftRowsOrder[16] = {0, 5, 10, 15, 4, 9, 14, 3, 8, 13, 2, 7, 12, 1, 6, 11};
+        alignas(16) static constexpr uint8_t InvShiftRowsOrder[16] = {0, 13, 10, 7, 4, 1, 14, 11, 8, 5, 2, 15, 12, 9, 6, 3};
+
+    private:
+        union
+        {
+            uint8_t bytes[16];
+#if defined(__SSE2__)
+            __m128i vector;
+#endif
+        };
+
+        void permute(const uint8_t*);
+};
+
+
+inline AESState AESState::load(const uint8_t* in)
+{
+    AESState state;
+#if defined(__SSE2__)
+    state.vector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+#else
+    memcpy(state.bytes, in, 16);
+#endif
+    return state;
+}
+
+
+inline AESState AESState::fromWords(const uint32_t* w)
+{
+    AESState state;
+    for(int c = 0; c < 4; c++)
+    {
+        for(int r = 0; r < 4; r++)
+        {
+            state.bytes[r + 4 * c] = static_cast<uint8_t>( w[c] >> (24 - 8 * r) );
+        }
+    }
+    return state;
+}
+
+
+inline void AESState::store(uint8_t* out) const
+{
+#if defined(__SSE2__)
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), this->vector);
+#else
+    memcpy(out, this->bytes, 16);
+#endif
+}
+
+
+inline void AESState::addRoundKey(const AESState& roundKey)
+{
+#if defined(__SSE2__)
+    this->vector = _mm_xor_si128(this->vector, roundKey.vector);
+#else
+    for(int i = 0; i < 16; i++)
+    {
+        this->bytes[i] ^= roundKey.bytes[i];
+    }
+#endif
+}
+
+
+inline void AESState::shiftRows()
+{
+#if defined(__SSSE3__)
+    this->vector = _mm_shuffle_epi8(this->vector, _mm_load_si128(reinterpret_cast<const __m128i*>(ShiftRowsOrder)));
+#else
+    permute(ShiftRowsOrder);
+#endif
+}
+
+
+inline void AESState::invShiftRows()
+{
+#if defined(__SSSE3__)
+    this->vector = _mm_shuffle_epi8(this->vector, _mm_load_si128(reinterpret_cast<const __m128i*>(InvShiftRowsOrder)));
+#else
+    permute(InvShiftRowsOrder);
+#endif
+}
+
+#endif
@@ -0,0 +1,116 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the SSSE3 AESState kernels: the byte permutation, and the whole round loops of the AES
+ *                  class block interface, so that AES::Cipher and AES::Decipher choose them once per call instead of once per
+ *                  round. It is compiled with -mssse3.
+*/
+
+#include "AESKernels.h"
+
+#ifdef __SSSE3__
+
+#include "AESTables.h"
+#include "GF256_ssse3.h"
+
+
+size_t aesPermuteSSSE3(uint8_t* states, size_t count, const uint8_t* order)
+{
+    const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(order));
+
+    for(size_t i = 0; i < count; i++)
+    {
+        __m128i* p = reinterpret_cast<__m128i*>(states + 16 * i);
+        _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), shuffle));
+    }
+    return count;
+}
+
+
+
+
+// the S-Box has no PSHUFB form: SubBytes takes the State out a column at a time, looks its bytes up and puts it back, all in
+// general registers so that nothing of the State is left in memory
+static inline __m128i substitute(__m128i s, const uint8_t* box)
+{
+    uint32_t column[4];
+    for(int c = 0; c < 4; c++)
+    {
+        uint32_t x = static_cast<uint32_t>( _mm_cvtsi128_si32(s) );
+        column[c] = static_cast<uint32_t>( box[x & 0xFF] ) | static_cast<uint32_t>( box[(x >> 8) & 0xFF] ) << 8 |
+                    static_cast<uint32_t>( box[(x >> 16) & 0xFF] ) << 16 | static_cast<uint32_t>( box[x >> 24] ) << 24;
+        s = _mm_srli_si128(s, 4);
+    }
+    return _mm_setr_epi32(static_cast<int>( column[0] ), static_cast<int>( column[1] ), static_cast<int>( column[2] ), static_cast<int>( column[3] ));
+}
+
+
+static inline __m128i roundKey(const uint8_t* roundKeys, int round)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(roundKeys + 16 * round));
+}
+
+
+/* Function: aesCipherSSSE3
+ * Parameters: The round keys as Nr + 1 States in input order, Nr, the input, the output, the number of blocks
+ * Return: The number of blocks processed
+ * Description: FIPS-197 Cipher() with the State in an XMM register: AddRoundKey is one PXOR, ShiftRows one PSHUFB and
+ *              MixColumns the packed multiply of GF256_ssse3.h. Only SubBytes leaves the register, for the general ones.
+*/
+size_t aesCipherSSSE3(const uint8_t* roundKeys, int Nr, const uint8_t* in, uint8_t* out, size_t blocks)
+{
+    const __m128i shiftRows = _mm_setr_epi8(0, 5, 10, 15, 4, 9, 14, 3, 8, 13, 2, 7, 12, 1, 6, 11);
+
+    for(size_t block = 0; block < blocks; block++)
+    {
+        __m128i s = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * block)), roundKey(roundKeys, 0));
+
+        for(int round = 1; round < Nr; round++)
+        {
+            s = _mm_shuffle_epi8(substitute(s, AESTables::SBox), shiftRows);
+            s = _mm_xor_si128(mixColumnsSSSE3(s), roundKey(roundKeys, round));
+        }
+
+        s = _mm_shuffle_epi8(substitute(s, AESTables::SBox), shiftRows);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * block), _mm_xor_si128(s, roundKey(roundKeys, Nr)));
+    }
+
+    return blocks;
+}
+
+
+/* Function: aesInvCipherSSSE3
+ * Parameters: The round keys as Nr + 1 States in input order, Nr, the input, the output, the number of blocks
+ * Return: The number of blocks processed
+ * Description: FIPS-197 InvCipher() in the same form as aesCipherSSSE3, with the encryption round keys in reverse order
+*/
+size_t aesInvCipherSSSE3(const uint8_t* roundKeys, int Nr, const uint8_t* in, uint8_t* out, size_t blocks)
+{
+    const __m128i invShiftRows = _mm_setr_epi8(0, 13, 10, 7, 4, 1, 14, 11, 8, 5, 2, 15, 12, 9, 6, 3);
+
+    for(size_t block = 0; block < blocks; block++)
+    {
+        __m128i s = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * block)), roundKey(roundKeys, Nr));
+
+        for(int round = Nr - 1; round > 0; round--)
+        {
+            s = substitute(_mm_shuffle_epi8(s, invShiftRows), AESTables::InvSBox);
+            s = invMixColumnsSSSE3(_mm_xor_si128(s, roundKey(roundKeys, round)));
+        }
+
+        s = substitute(_mm_shuffle_epi8(s, invShiftRows), AESTables::InvSBox);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * block), _mm_xor_si128(s, roundKey(roundKeys, 0)));
+    }
+
+    return blocks;
+}
+
+#else
+
+size_t aesPermuteSSSE3(uint8_t*, size_t, const uint8_t*) { return 0; }
+size_t aesCipherSSSE3(const uint8_t*, int, const uint8_t*, uint8_t*, size_t) { return 0; }
+size_t aesInvCipherSSSE3(const uint8_t*, int, const uint8_t*, uint8_t*, size_t) { return 0; }
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the AES-NI block kernels. It is compiled with -maes -mssse3.
+*/
+
+#include "AESKernels.h"
+
+#if defined(__AES__) && defined(__SSSE3__)
+
+#include <immintrin.h>
+
+
+/* Function: loadRoundKey
+ * Parameters: A pointer to the four key schedule words of one round
+ * Return: The round key in the byte order AESENC expects
+ * Description: Key schedule words hold byte 0 of a column in their most significant byte, so each 32-bit lane is byte swapped
+*/
+static inline __m128i loadRoundKey(const uint32_t* w)
+{
+    const __m128i bswap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w)), bswap);
+}
+
+
+size_t aesniEncryptBlocks(const uint32_t* w, int Nr, const uint8_t* in, uint8_t* out, size_t blocks)
+{
+    __m128i k[15];
+    for(int round = 0; round <= Nr; round++)
+    {
+        k[round] = loadRoundKey(w + 4 * round);
+    }
+
+    const __m128i* src = reinterpret_cast<const __m128i*>(in);
+    __m128i* dst = reinterpret_cast<__m128i*>(out);
+
+    size_t i = 0;
+    for(; i + 8 <= blocks; i += 8)
+    {
+        __m128i b[8];
+        for(int j = 0; j < 8; j++)
+        {
+            b[j] = _mm_xor_si128(_mm_loadu_si128(src + i + j), k[0]);
+        }
+        for(int round = 1; round < Nr; round++)
+        {
+            for(int j = 0; j < 8; j++)
+            {
+                b[j] = _mm_aesenc_si128(b[j], k[round]);
+            }
+        }
+        for(int j = 0; j < 8; j++)
+        {
+            _mm_storeu_si128(dst + i + j, _mm_aesenclast_si128(b[j], k[Nr]));
+        }
+    }
+
+    for(; i < blocks; i++)
+    {
+        __m128i b = _mm_xor_si128(_mm_loadu_si128(src + i), k[0]);
+        for(int round = 1; round < Nr; round++)
+        {
+            b = _mm_aesenc_si128(b, k[round]);
+        }
+        _mm_storeu_si128(dst + i, _mm_aesenclast_si128(b, k[Nr]));
+    }
+
+    return blocks;
+}
+
+
+// AESDEC is one round of the equivalent inverse cipher, so dw is used as is, from the last round key down to the first
+size_t aesniDecryptBlocks(const uint32_t* dw, int Nr, const uint8_t* in, uint8_t* out, size_t blocks)
+{
+    __m128i k[15];
+    for(int round = 0; round <= Nr; round++)
+    {
+        k[round] = loadRoundKey(dw + 4 * round);
+    }
+
+    const __m128i* src = reinterpret_cast<const __m128i*>(in);
+    __m128i* dst = reinterpret_cast<__m128i*>(out);
+
+    size_t i = 0;
+    for(; i + 8 <= blocks; i += 8)
+    {
+        __m128i b[8];
+        for(int j = 0; j < 8; j++)
+        {
+            b[j] = _mm_xor_si128(_mm_loadu_si128(src + i + j), k[Nr]);
+        }
+        for(int round = Nr - 1; round > 0; round--)
+        {
+            for(int j = 0; j < 8; j++)
+            {
+                b[j] = _mm_aesdec_si128(b[j], k[round]);
+            }
+        }
+        for(int j = 0; j < 8; j++)
+        {
+            _mm_storeu_si128(dst + i + j, _mm_aesdeclast_si128(b[j], k[0]));
+        }
+    }
+
+    for(; i < blocks; i++)
+    {
+        __m128i b = _mm_xor_si128(_mm_loadu_si128(src + i), k[Nr]);
+        for(int round = Nr - 1; round > 0; round--)
+        {
+            b = _mm_aesdec_si128(b, k[round]);
+        }
+        _mm_storeu_si128(dst + i, _mm_aesdeclast_si128(b, k[0]));
+    }
+
+    return blocks;
+}
+
+#else
+
+size_t aesniEncryptBlocks(const uint32_t*, int, const uint8_t*, uint8_t*, size_t)
+{
+    return 0;
+}
+
+
+size_t aesniDecryptBlocks(const uint32_t*, int, const uint8_t*, uint8_t*, size_t)
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the VAES block kernels on 512-bit registers. It is compiled with -mvaes -mavx512f.
+*/
+
+#include "AESKernels.h"
+
+#if defined(__VAES__) && defined(__AVX512F__)
+
+#include <immintrin.h>
+
+
+// The same byte swap as the AES-NI kernel, then the 128-bit round key is copied to all four lanes
+static inline __m512i loadRoundKey(const uint32_t* w)
+{
+    const __m128i bswap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    __m128i key = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w)), bswap);
+    return _mm512_broadcast_i32x4(key);
+}
+
+
+size_t vaesEncryptBlocks(const uint32_t* w, int Nr, const uint8_t* in, uint8_t* out, size_t blocks)
+{
+    __m512i k[15];
+    for(int round = 0; round <= Nr; round++)
+    {
+        k[round] = loadRoundKey(w + 4 * round);
+    }
+
+    size_t i = 0;
+    for(; i + 16 <= blocks; i += 16)
+    {
+        __m512i b[4];
+        for(int j = 0; j < 4; j++)
+        {
+            b[j] = _mm512_xor_si512(_mm512_loadu_si512(in + 16 * (i + 4 * j)), k[0]);
+        }
+        for(int round = 1; round < Nr; round++)
+        {
+            for(int j = 0; j < 4; j++)
+            {
+                b[j] = _mm512_aesenc_epi128(b[j], k[round]);
+            }
+        }
+        for(int j = 0; j < 4; j++)
+        {
+            _mm512_storeu_si512(out + 16 * (i + 4 * j), _mm512_aesenclast_epi128(b[j], k[Nr]));
+        }
+    }
+
+    for(; i + 4 <= blocks; i += 4)
+    {
+        __m512i b = _mm512_xor_si512(_mm512_loadu_si512(in + 16 * i), k[0]);
+        for(int round = 1; round < Nr; round++)
+        {
+            b = _mm512_aesenc_epi128(b, k[round]);
+        }
+        _mm512_storeu_si512(out + 16 * i, _mm512_aesenclast_epi128(b, k[Nr]));
+    }
+
+    return i;
+}
+
+
+size_t vaesDecryptBlocks(const uint32_t* dw, int Nr, const uint8_t* in, uint8_t* out, size_t blocks)
+{
+    __m512i k[15];
+    for(int round = 0; round <= Nr; round++)
+    {
+        k[round] = loadRoundKey(dw + 4 * round);
+    }
+
+    size_t i = 0;
+    for(; i + 16 <= blocks; i += 16)
+    {
+        __m512i b[4];
+        for(int j = 0; j < 4; j++)
+        {
+            b[j] = _mm512_xor_si512(_mm512_loadu_si512(in + 16 * (i + 4 * j)), k[Nr]);
+        }
+        for(int round = Nr - 1; round > 0; round--)
+        {
+            for(int j = 0; j < 4; j++)
+            {
+                b[j] = _mm512_aesdec_epi128(b[j], k[round]);
+            }
+        }
+        for(int j = 0; j < 4; j++)
+        {
+            _mm512_storeu_si512(out + 16 * (i + 4 * j), _mm512_aesdeclast_epi128(b[j], k[0]));
+        }
+    }
+
+    for(; i + 4 <= blocks; i += 4)
+    {
+        __m512i b = _mm512_xor_si512(_mm512_loadu_si512(in + 16 * i), k[Nr]);
+        for(int round = Nr - 1; round > 0; round--)
+        {
+            b = _mm512_aesdec_epi128(b, k[round]);
+        }
+        _mm512_storeu_si512(out + 16 * i, _mm512_aesdeclast_epi128(b, k[0]));
+    }
+
+    return i;
+}
+
+#else
+
+size_t vaesEncryptBlocks(const uint32_t*, int, const uint8_t*, uint8_t*, size_t)
+{
+    return 0;
+}
+
+
+size_t vaesDecryptBlocks(const uint32_t*, int, const uint8_t*, uint8_t*, size_t)
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the GF256 tables and the dispatch between the SSSE3 kernels and the table code.
+*/
+
+#include "GF256.h"
+#include "AESKernels.h"
+#include "../Common/CpuFeatures.h"
+
+
+// -------------------------------------- TABLES --------------------------------------
+
+// the tables are generated at compile time from xtime, so they are constant initialized and need no startup code
+
+static constexpr array<uint8_t, 510> makeExp()
+{
+    array<uint8_t, 510> exp = {};
+    uint8_t power = 1;
+    for(int i = 0; i < 255; i++)
+    {
+        exp[i] = power;
+        exp[i + 255] = power;
+        power = static_cast<uint8_t>( power ^ GF256::xtime(power) ); // {03} * power
+    }
+    return exp;
+}
+
+
+static constexpr array<uint8_t, 256> makeLog()
+{
+    array<uint8_t, 256> log = {};
+    array<uint8_t, 510> exp = makeExp();
+    for(int i = 0; i < 255; i++)
+    {
+        log[exp[i]] = static_cast<uint8_t>( i );
+    }
+    return log;
+}
+
+
+// shift-and-add multiplication by a constant, the same loop as AES::ffMultiply used before these tables
+static constexpr array<uint8_t, 256> makeTimes(uint8_t constant)
+{
+    array<uint8_t, 256> times = {};
+    for(int a = 0; a < 256; a++)
+    {
+        uint8_t sum = 0;
+        uint8_t b = static_cast<uint8_t>( a );
+        for(int bit = 0; bit < 8; bit++)
+        {
+            if(constant >> bit & 1)
+            {
+                sum ^= b;
+            }
+            b = GF256::xtime(b);
+        }
+        times[a] = sum;
+    }
+    return times;
+}
+
+
+const array<uint8_t, 510> GF256::Exp = makeExp();
+const array<uint8_t, 256> GF256::Log = makeLog();
+
+const array<uint8_t, 256> GF256::Times02 = makeTimes(0x02);
+const array<uint8_t, 256> GF256::Times03 = makeTimes(0x03);
+const array<uint8_t, 256> GF256::Times09 = makeTimes(0x09);
+const array<uint8_t, 256> GF256::Times0B = makeTimes(0x0b);
+const array<uint8_t, 256> GF256::Times0D = makeTimes(0x0d);
+const array<uint8_t, 256> GF256::Times0E = makeTimes(0x0e);
+
+
+
+
+// -------------------------------------- PACKED OPERATIONS --------------------------------------
+
+/* Function: multiply
+ * Parameters: The constant, the input bytes, the output bytes, the number of bytes
+ * Return: None
+ * Description: The SSSE3 kernel takes whole 16 byte vectors; the log/exp tables finish the tail
+*/
+void GF256::multiply(uint8_t constant, const uint8_t* in, uint8_t* out, size_t length)
+{
+    size_t done = cpuFeatures().ssse3 ? gfMultiplySSSE3(constant, in, out, length) : 0;
+
+    for(size_t i = done; i < length; i++)
+    {
+        out[i] = multiply(constant, in[i]);
+    }
+}
+
+
+/* Function: mixColumns / invMixColumns
+ * Parameters: The States, 16 bytes each in input order, and their number
+ * Return: None
+ * Description: Without SSSE3 every column is multiplied by the matrix with one constant table lookup per coefficient
+*/
+void GF256::mixColumns(uint8_t* states, size_t count)
+{
+    if(cpuFeatures().ssse3 && gfMixColumnsSSSE3(states, count, false) == count)
+    {
+        return;
+    }
+
+    for(size_t c = 0; c < 4 * count; c++)
+    {
+        uint8_t* s = states + 4 * c;
+        uint8_t s0 = s[0];
+        uint8_t s1 = s[1];
+        uint8_t s2 = s[2];
+        uint8_t s3 = s[3];
+
+        s[0] = Times02[s0] ^ Times03[s1] ^ s2 ^ s3;
+        s[1] = s0 ^ Times02[s1] ^ Times03[s2] ^ s3;
+        s[2] = s0 ^ s1 ^ Times02[s2] ^ Times03[s3];
+        s[3] = Times03[s0] ^ s1 ^ s2 ^ Times02[s3];
+    }
+}
+
+
+void GF256::invMixColumns(uint8_t* states, size_t count)
+{
+    if(cpuFeatures().ssse3 && gfMixColumnsSSSE3(states, count, true) == count)
+    {
+        return;
+    }
+
+    for(size_t c = 0; c < 4 * count; c++)
+    {
+        uint8_t* s = states + 4 * c;
+        uint8_t s0 = s[0];
+        uint8_t s1 = s[1];
+        uint8_t s2 = s[2];
+        uint8_t s3 = s[3];
+
+        s[0] = Times0E[s0] ^ Times0B[s1] ^ Times0D[s2] ^ Times09[s3];
+        s[1] = Times09[s0] ^ Times0E[s1] ^ Times0B[s2] ^ Times0D[s3];
+        s[2] = Times0D[s0] ^ Times09[s1] ^ Times0E[s2] ^ Times0B[s3];
+        s[3] = Times0B[s0] ^ Times0D[s1] ^ Times09[s2] ^ Times0E[s3];
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains GF256, the arithmetic of the AES field GF(2^8) = GF(2)[x] / (x^8 + x^4 + x^3 + x + 1)
+ *                  shared by the AES implementations. It offers three ways to multiply:
+ *
+ *                    - log/exp tables over the generator {03}: a general product is two log lookups, an add and an exp lookup
+ *                    - constant-multiplier tables: one lookup per product for the MixColumns and InvMixColumns coefficients
+ *                    - packed multiplication: PSHUFB looks the low and high nibble of 16 bytes up in two 16 entry tables of the
+ *                      constant, so a whole State is multiplied by one constant in a few instructions (SSSE3, with a table
+ *                      fallback)
+ *
+ *                  mixColumns and invMixColumns are built on the packed multiply. They take States as 16 bytes in input order
+ *                  (byte (r, c) at s[r + 4c]), the layout of AESState and AESFixed.
+ *
+ *                  All of the tables are indexed by the data, so like the S-Box lookups they are not constant time. AESFixed,
+ *                  which the engines fall back on, keeps its branch-free xtime arithmetic.
+*/
+
+#ifndef GF256_H
+#define GF256_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <array>
+
+using namespace std;
+
+class GF256
+{
+    public:
+        static const array<uint8_t, 510> Exp; // Exp[i] = {03}^i, stored twice so that Exp[Log[a] + Log[b]] needs no reduction
+        static const array<uint8_t, 256> Log; // Log[Exp[i]] = i; Log[0] is unused
+
+        // Constant-multiplier tables: TimesNN[a] = {NN} * a
+        static const array<uint8_t, 256> Times02;
+        static const array<uint8_t, 256> Times03;
+        static const array<uint8_t, 256> Times09;
+        static const array<uint8_t, 256> Times0B;
+        static const array<uint8_t, 256> Times0D;
+        static const array<uint8_t, 256> Times0E;
+
+        // Multiplication by x, the building block of the constant tables
+        static constexpr uint8_t xtime(uint8_t a) { return static_cast<uint8_t>( (a << 1) ^ ((a >> 7) * 0x1b) ); }
+
+        static uint8_t add(uint8_t a, uint8_t b) { return a ^ b; }
+        static uint8_t multiply(uint8_t a, uint8_t b);
+        static uint8_t inverse(uint8_t a); // the multiplicative inverse, with 0 mapped to 0 as in the S-Box
+
+        // out[i] = constant * in[i] for length bytes; in and out may be the same buffer
+        static void multiply(uint8_t constant, const uint8_t* in, uint8_t* out, size_t length);
+
+        // count consecutive 16 byte States in input order, byte (r, c) at r + 4c
+        static void mixColumns(uint8_t* states, size_t count = 1);
+        static void invMixColumns(uint8_t* states, size_t count = 1);
+};
+
+
+inline uint8_t GF256::multiply(uint8_t a, uint8_t b)
+{
+    if(a == 0 || b == 0)
+    {
+        return 0;
+    }
+    return Exp[Log[a] + Log[b]];
+}
+
+
+inline uint8_t GF256::inverse(uint8_t a)
+{
+    if(a == 0)
+    {
+        return 0;
+    }
+    return Exp[255 - Log[a]];
+}
+
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the SSSE3 GF(2^8) kernels. It is compiled with -mssse3.
+*/
+
+#include "AESKernels.h"
+
+#ifdef __SSSE3__
+
+#include "GF256_ssse3.h"
+
+
+size_t gfMultiplySSSE3(uint8_t constant, const uint8_t* in, uint8_t* out, size_t length)
+{
+    Nibbles product = {};
+    for(int i = 0; i < 16; i++)
+    {
+        product.low[i] = GF256::multiply(constant, static_cast<uint8_t>( i ));
+        product.high[i] = GF256::multiply(constant, static_cast<uint8_t>( i << 4 ));
+    }
+    const NibbleTables t = load(product);
+
+    size_t i = 0;
+    for(; i + 16 <= length; i += 16)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), multiplySSSE3(x, t));
+    }
+    return i;
+}
+
+
+/* Function: gfMixColumnsSSSE3
+ * Parameters: The States, their number, whether to apply InvMixColumns
+ * Return: The number of States processed
+ * Description: Each State is loaded, mixed in a register by the GF256_ssse3.h helpers and stored back
+*/
+size_t gfMixColumnsSSSE3(uint8_t* states, size_t count, bool inverse)
+{
+    for(size_t i = 0; i < count; i++)
+    {
+        __m128i* p = reinterpret_cast<__m128i*>(states + 16 * i);
+        __m128i s = _mm_loadu_si128(p);
+        _mm_storeu_si128(p, inverse ? invMixColumnsSSSE3(s) : mixColumnsSSSE3(s));
+    }
+
+    return count;
+}
+
+#else
+
+size_t gfMultiplySSSE3(uint8_t, const uint8_t*, uint8_t*, size_t) { return 0; }
+size_t gfMixColumnsSSSE3(uint8_t*, size_t, bool) { return 0; }
+
+#endif
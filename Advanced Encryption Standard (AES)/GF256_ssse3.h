@@ -0,0 +1,114 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the inline SSSE3 GF(2^8) arithmetic shared by the SSSE3 kernels: the packed multiply by a
+ *                  constant and MixColumns and InvMixColumns of one State in an XMM register. Only translation units compiled
+ *                  with -mssse3 may include it.
+*/
+
+#ifndef GF256_SSSE3_H
+#define GF256_SSSE3_H
+
+#include "GF256.h"
+
+#include <immintrin.h>
+
+
+// Products of a constant with the 16 low nibbles and the 16 high nibbles; c * a = low[a & 15] ^ high[a >> 4]
+struct alignas(16) Nibbles
+{
+    uint8_t low[16];
+    uint8_t high[16];
+};
+
+
+static constexpr Nibbles makeNibbles(uint8_t constant)
+{
+    Nibbles t = {};
+    for(int i = 0; i < 16; i++)
+    {
+        uint8_t low = static_cast<uint8_t>( i );
+        uint8_t high = static_cast<uint8_t>( i << 4 );
+        for(int bit = 0; bit < 8; bit++)
+        {
+            if(constant >> bit & 1)
+            {
+                t.low[i] ^= low;
+                t.high[i] ^= high;
+            }
+            low = GF256::xtime(low);
+            high = GF256::xtime(high);
+        }
+    }
+    return t;
+}
+
+
+static constexpr Nibbles Nibbles02 = makeNibbles(0x02);
+static constexpr Nibbles Nibbles03 = makeNibbles(0x03);
+static constexpr Nibbles Nibbles09 = makeNibbles(0x09);
+static constexpr Nibbles Nibbles0B = makeNibbles(0x0b);
+static constexpr Nibbles Nibbles0D = makeNibbles(0x0d);
+static constexpr Nibbles Nibbles0E = makeNibbles(0x0e);
+
+
+struct NibbleTables
+{
+    __m128i low;
+    __m128i high;
+};
+
+
+static inline NibbleTables load(const Nibbles& t)
+{
+    return {_mm_load_si128(reinterpret_cast<const __m128i*>(t.low)), _mm_load_si128(reinterpret_cast<const __m128i*>(t.high))};
+}
+
+
+/* Function: multiplySSSE3
+ * Parameters: 16 field elements, the nibble tables of a constant
+ * Return: The 16 products
+ * Description: Multiplication by a constant is linear over GF(2), so the product of a byte is the XOR of the products of its two
+ *              nibbles, each of which PSHUFB looks up in one instruction
+*/
+static inline __m128i multiplySSSE3(__m128i x, const NibbleTables& t)
+{
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    __m128i low = _mm_shuffle_epi8(t.low, _mm_and_si128(x, nibble));
+    __m128i high = _mm_shuffle_epi8(t.high, _mm_and_si128(_mm_srli_epi16(x, 4), nibble));
+    return _mm_xor_si128(low, high);
+}
+
+
+/* Function: mixColumnsSSSE3 / invMixColumnsSSSE3
+ * Parameters: A State in input order
+ * Return: The State with its columns mixed
+ * Description: Row r of the output column is sum over k of m[k] * s[(r + k) mod 4], where m is {02, 03, 01, 01} or
+ *              {0e, 0b, 0d, 09}. Rotating every column by k rows is one shuffle within each 4 byte group, and each of the four
+ *              terms is then one packed multiply. The constants are loaded here; in a loop the compiler keeps them in registers.
+*/
+static inline __m128i mixColumnsSSSE3(__m128i s)
+{
+    const __m128i rotate1 = _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);
+    const __m128i rotate2 = _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+    const __m128i rotate3 = _mm_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+
+    __m128i out = _mm_xor_si128(multiplySSSE3(s, load(Nibbles02)), multiplySSSE3(_mm_shuffle_epi8(s, rotate1), load(Nibbles03)));
+    return _mm_xor_si128(out, _mm_xor_si128(_mm_shuffle_epi8(s, rotate2), _mm_shuffle_epi8(s, rotate3)));
+}
+
+
+static inline __m128i invMixColumnsSSSE3(__m128i s)
+{
+    const __m128i rotate1 = _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);
+    const __m128i rotate2 = _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+    const __m128i rotate3 = _mm_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+
+    __m128i out = _mm_xor_si128(multiplySSSE3(s, load(Nibbles0E)), multiplySSSE3(_mm_shuffle_epi8(s, rotate1), load(Nibbles0B)));
+    out = _mm_xor_si128(out, multiplySSSE3(_mm_shuffle_epi8(s, rotate2), load(Nibbles0D)));
+    return _mm_xor_si128(out, multiplySSSE3(_mm_shuffle_epi8(s, rotate3), load(Nibbles09)));
+}
+
+#endif
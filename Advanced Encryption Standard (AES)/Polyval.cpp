@@ -0,0 +1,132 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the Polyval method definitions and the dispatch between the PCLMULQDQ kernel and the
+ *                  portable code.
+*/
+
+#include "Polyval.h"
+#include "AESKernels.h"
+
+#include <cstring>
+
+#include "../Common/CpuFeatures.h"
+#include "../Common/SecureMemory.h"
+
+
+static inline uint64_t load64(const uint8_t* p)
+{
+    uint64_t v = 0;
+    for(int i = 7; i >= 0; i--)
+    {
+        v = v << 8 | p[i];
+    }
+    return v;
+}
+
+
+static inline void store64(uint8_t* p, uint64_t v)
+{
+    for(int i = 0; i < 8; i++)
+    {
+        p[i] = static_cast<uint8_t>( v >> (8 * i) );
+    }
+}
+
+
+/* Function: dot
+ * Parameters: The two field elements and the output, 16 bytes each; the output may be either input
+ * Return: None
+ * Description: For bit i of a from 0 up, adds b when the bit is set and then multiplies by x^-1, so b meets x^-(128 - i). The
+ *              multiply by x^-1 adds the modulus when the lowest bit is set, which clears it and raises the x^128 term, and
+ *              shifts right by one. The conditions are masks, not branches, so the time does not depend on the key.
+*/
+void Polyval::dot(const uint8_t* a, const uint8_t* b, uint8_t* out)
+{
+    const uint64_t a0 = load64(a);
+    const uint64_t a1 = load64(a + 8);
+    const uint64_t b0 = load64(b);
+    const uint64_t b1 = load64(b + 8);
+
+    uint64_t r0 = 0;
+    uint64_t r1 = 0;
+    for(int i = 0; i < 128; i++)
+    {
+        uint64_t bit = (i < 64 ? a0 >> i : a1 >> (i - 64)) & 1;
+        uint64_t add = 0 - bit;
+        r0 ^= b0 & add;
+        r1 ^= b1 & add;
+
+        // x^128 + x^127 + x^126 + x^121 + 1: the x^127, x^126 and x^121 terms are bits 63, 62 and 57 of the high word
+        uint64_t odd = 0 - (r0 & 1);
+        r0 ^= odd & 1;
+        r1 ^= odd & 0xC200000000000000ull;
+        r0 = r0 >> 1 | r1 << 63;
+        r1 = r1 >> 1 | (odd & 0x8000000000000000ull);
+    }
+
+    store64(out, r0);
+    store64(out + 8, r1);
+}
+
+
+
+
+/* Function: Constructor
+ * Parameters: The 16 byte key H
+ * Return: a Polyval object with S = 0
+ * Description: With PCLMULQDQ the kernel computes the eight powers of H the aggregated loop needs
+*/
+Polyval::Polyval(const uint8_t* H) : powers(), S(), clmul(false)
+{
+    memcpy(this->powers, H, 16);
+    this->clmul = cpuFeatures().pclmul && polyvalPowersCLMUL(H, this->powers, Powers) == Powers;
+}
+
+
+Polyval::~Polyval()
+{
+    secureZero(this->powers, sizeof(this->powers));
+    secureZero(this->S, sizeof(this->S));
+}
+
+
+void Polyval::update(const uint8_t* data, size_t length)
+{
+    size_t blocks = length / 16;
+    size_t done = this->clmul ? polyvalCLMUL(this->powers, this->S, data, blocks) : 0;
+
+    for(size_t i = done; i < blocks; i++)
+    {
+        for(int b = 0; b < 16; b++)
+        {
+            this->S[b] ^= data[16 * i + b];
+        }
+        dot(this->S, this->powers, this->S);
+    }
+
+    size_t tail = length % 16;
+    if(tail > 0)
+    {
+        alignas(16) uint8_t last[16] = {};
+        memcpy(last, data + 16 * blocks, tail);
+        if(this->clmul && polyvalCLMUL(this->powers, this->S, last, 1) == 1)
+        {
+            return;
+        }
+
+        for(int b = 0; b < 16; b++)
+        {
+            this->S[b] ^= last[b];
+        }
+        dot(this->S, this->powers, this->S);
+    }
+}
+
+
+void Polyval::digest(uint8_t* out) const
+{
+    memcpy(out, this->S, 16);
+}
@@ -0,0 +1,46 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains POLYVAL (RFC 8452 section 3), the universal hash of AES-GCM-SIV. It works in GF(2^128)
+ *                  modulo x^128 + x^127 + x^126 + x^121 + 1 with the bits of a block in little-endian order, and absorbs block X
+ *                  as S = dot(S xor X, H), where dot(a, b) = a * b * x^-128.
+ *
+ *                  With PCLMULQDQ the blocks are absorbed eight at a time: the products with H^8 ... H^1 are summed
+ *                  unreduced and reduced once, so the eight carry-less multiplies are independent. The powers are computed
+ *                  when the object is made. The portable code is a constant time shift-and-add.
+*/
+
+#ifndef AES_POLYVAL_H
+#define AES_POLYVAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+using namespace std;
+
+class Polyval
+{
+    public:
+        static const size_t Powers = 8; // blocks absorbed per reduction with PCLMULQDQ
+
+        Polyval(const uint8_t*); // the 16 byte key H
+        ~Polyval();
+
+        Polyval(const Polyval&) = delete;
+        Polyval& operator=(const Polyval&) = delete;
+
+        // absorbs length bytes; a partial last block is zero padded, so only the last call for a field may end mid block
+        void update(const uint8_t*, size_t);
+        void digest(uint8_t*) const; // the 16 byte value S
+
+        static void dot(const uint8_t* a, const uint8_t* b, uint8_t* out); // a * b * x^-128, portable
+
+    private:
+        alignas(16) uint8_t powers[16 * Powers]; // H^1 ... H^8 as dot products; only H^1 without PCLMULQDQ
+        alignas(16) uint8_t S[16];
+        bool clmul;
+};
+
+#endif
@@ -0,0 +1,117 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the PCLMULQDQ POLYVAL kernels. It is compiled with -mpclmul.
+*/
+
+#include "AESKernels.h"
+
+#ifdef __PCLMUL__
+
+#include <immintrin.h>
+
+
+// the 256-bit carry-less product of two field elements, as its low and high halves
+struct Product
+{
+    __m128i low;
+    __m128i high;
+};
+
+
+static inline void accumulate(Product& p, __m128i a, __m128i b)
+{
+    __m128i middle = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x01), _mm_clmulepi64_si128(a, b, 0x10));
+    p.low = _mm_xor_si128(p.low, _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x00), _mm_slli_si128(middle, 8)));
+    p.high = _mm_xor_si128(p.high, _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x11), _mm_srli_si128(middle, 8)));
+}
+
+
+/* Function: reduce
+ * Parameters: A 256-bit product
+ * Return: The product times x^-128 modulo x^128 + x^127 + x^126 + x^121 + 1
+ * Description: Two Montgomery steps of 64 bits each. A step multiplies the low word by the constant x^63 + x^62 + x^57 (the
+ *              high word of 0xc2000000000000000000000000000001), which cancels it, and swaps the words to divide by x^64.
+*/
+static inline __m128i reduce(const Product& p)
+{
+    const __m128i poly = _mm_set_epi64x(static_cast<long long>( 0xC200000000000000ull ), 1);
+
+    __m128i t = _mm_xor_si128(_mm_shuffle_epi32(p.low, 0x4E), _mm_clmulepi64_si128(p.low, poly, 0x10));
+    t = _mm_xor_si128(_mm_shuffle_epi32(t, 0x4E), _mm_clmulepi64_si128(t, poly, 0x10));
+    return _mm_xor_si128(t, p.high);
+}
+
+
+static inline __m128i dot(__m128i a, __m128i b)
+{
+    Product p = {_mm_setzero_si128(), _mm_setzero_si128()};
+    accumulate(p, a, b);
+    return reduce(p);
+}
+
+
+size_t polyvalPowersCLMUL(const uint8_t* H, uint8_t* powers, size_t count)
+{
+    const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(H));
+    __m128i power = h;
+    for(size_t i = 0; i < count; i++)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(powers + 16 * i), power);
+        power = dot(power, h);
+    }
+    return count;
+}
+
+
+/* Function: polyvalCLMUL
+ * Parameters: H^1 ... H^8, the running value S, the input, the number of 16 byte blocks
+ * Return: The number of blocks processed (all of them)
+ * Description: Eight blocks at a time, S' = dot(S xor X0, H^8) xor dot(X1, H^7) xor ... xor dot(X7, H^1). Every term is the
+ *              same x^-128 multiple of its product, so the eight products are summed before the single reduction.
+*/
+size_t polyvalCLMUL(const uint8_t* powers, uint8_t* S, const uint8_t* in, size_t blocks)
+{
+    const __m128i* h = reinterpret_cast<const __m128i*>(powers);
+    __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(S));
+
+    size_t i = 0;
+    if(blocks >= 8)
+    {
+        __m128i hp[8];
+        for(int k = 0; k < 8; k++)
+        {
+            hp[k] = _mm_loadu_si128(h + k);
+        }
+
+        for(; i + 8 <= blocks; i += 8)
+        {
+            const __m128i* x = reinterpret_cast<const __m128i*>(in + 16 * i);
+            Product p = {_mm_setzero_si128(), _mm_setzero_si128()};
+            accumulate(p, _mm_xor_si128(s, _mm_loadu_si128(x)), hp[7]);
+            for(int k = 1; k < 8; k++)
+            {
+                accumulate(p, _mm_loadu_si128(x + k), hp[7 - k]);
+            }
+            s = reduce(p);
+        }
+    }
+
+    const __m128i h1 = _mm_loadu_si128(h);
+    for(; i < blocks; i++)
+    {
+        s = dot(_mm_xor_si128(s, _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * i))), h1);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(S), s);
+    return blocks;
+}
+
+#else
+
+size_t polyvalPowersCLMUL(const uint8_t*, uint8_t*, size_t) { return 0; }
+size_t polyvalCLMUL(const uint8_t*, uint8_t*, const uint8_t*, size_t) { return 0; }
+
+#endif
@@ -6,14 +6,39 @@
  * Synopsis:        This program is the implementation of the Rijndael AES algorithm as described in https://nvlpubs.nist.gov/nistpubs/fips/nist.fips.197.pdf
  *                  This application performs block level encryption and decryption using each key size described in AES.
  *
- * Compilation:     g++ -c main.cpp AES.cpp
- *                  g++ -o aes main.o AES.o
+ * Compilation:     cmake -S . -B build && cmake --build build        (from the repository root)
+ *                  (add -DCRYPTO_PERF_COUNTERS=ON to the first command to print hardware counters per function)
  * 
  * Usage:           ./aes
 */
 
+#include <cstring>
 #include <iostream>
 #include "AES.h"
+#include "AESEngine.h"
+#include "AESBatch.h"
+#include "AESCCM.h"
+#include "AESCMAC.h"
+#include "AESGCMSIV.h"
+#include "AESKeyCache.h"
+#include "AESModes.h"
+#include "../Common/PerfCounters.h"
+
+
+/* Function: printBlock
+ * Parameters: a label, and a pointer to a 16 byte block
+ * Return: None
+ * Description: This function prints a block in hexadecimal notation
+*/
+void printBlock(string label, const uint8_t* block)
+{
+    cout << label;
+    for(int i = 0; i < 16; i++)
+    {
+        cout << hex << setw(2) << setfill('0') << static_cast<int>( block[i] );
+    }
+    cout << endl;
+}
 
 
 int main()
@@ -43,6 +68,10 @@ int main()
     Iaes128.Decipher(); // call decipher
     cout << endl;
 
+    AES EIaes128(dInput, key128, 0);
+    EIaes128.EqDecipher(); // call equivalent inverse cipher
+    cout << endl;
+
     AES aes192(input, key192, 1);
     aes192.Cipher();
     cout << endl;
@@ -57,6 +86,235 @@ int main()
 
     AES Iaes256(dInput256, key256, 0);
     Iaes256.Decipher();
+    cout << endl;
+
+
+
+    /* byte buffer interface and fixed key size implementation */
+
+    cout << endl << "BYTE BUFFER INTERFACE:" << endl;
+
+    uint8_t block[16];
+    uint8_t keyBytes[32];
+    for(int i = 0; i < 16; i++)
+    {
+        block[i] = static_cast<uint8_t>( (i << 4) | i ); // 00112233445566778899aabbccddeeff
+    }
+    for(int i = 0; i < 32; i++)
+    {
+        keyBytes[i] = static_cast<uint8_t>( i ); // 000102030405...
+    }
+
+    for(int keyLength = 16; keyLength <= 32; keyLength += 8)
+    {
+        AESEngine engine(keyBytes, keyLength);
+        uint8_t out[16];
+
+        engine.encryptBlock(block, out);
+        cout << "AES-" << dec << engine.keyBits() << endl;
+        printBlock("    encrypt:        ", out);
+
+        engine.decryptBlock(out, out);
+        printBlock("    decrypt:        ", out);
+
+        AES aes(keyBytes, keyLength); // class-based implementation on the same buffers
+        aes.Cipher(block, out, 1);
+        printBlock("    AES::Cipher:    ", out);
+
+        aes.Decipher(out, out, 1);
+        printBlock("    AES::Decipher:  ", out);
+    }
+
+
+
+
+    /* batch interface: several records sealed into one arena, then opened with one tag altered */
+
+    cout << endl << "BATCH INTERFACE:" << endl;
+
+    const char* messages[3] = {"first record", "a second, somewhat longer record on the bus", "third"};
+    uint8_t nonces[3][AESBatch::NonceSize] = {{1}, {2}, {3}};
+    AESRecord records[3];
+    for(int i = 0; i < 3; i++)
+    {
+        records[i] = AESRecord{reinterpret_cast<const uint8_t*>( messages[i] ), strlen(messages[i]), nullptr, 0, nonces[i], nullptr};
+    }
+
+    AESBatch batch(keyBytes, keyBytes + 16, 16);
+    uint8_t sealedArena[256];
+    AESRecordOutput sealed[3];
+    size_t used = batch.seal(records, 3, sealedArena, sizeof(sealedArena), sealed);
+    cout << "    sealed:         3 records, " << dec << used << " arena bytes" << endl;
+
+    uint8_t forged[AESBatch::TagSize];
+    memcpy(forged, sealed[1].tag, sizeof(forged));
+    forged[0] ^= 1;
+
+    for(int i = 0; i < 3; i++)
+    {
+        records[i] = AESRecord{sealed[i].data, sealed[i].length, nullptr, 0, nonces[i], i == 1 ? forged : sealed[i].tag};
+    }
+
+    uint8_t openedArena[256];
+    AESRecordOutput opened[3];
+    bool authentic[3];
+    size_t passed = batch.open(records, 3, openedArena, sizeof(openedArena), opened, authentic);
+    cout << "    opened:         " << passed << " of 3 authentic" << endl;
+    for(int i = 0; i < 3; i++)
+    {
+        cout << "    record " << i << ":       " << (authentic[i] ? string(reinterpret_cast<char*>( opened[i].data ), opened[i].length) : "rejected") << endl;
+    }
+
+
+
+
+    /* key schedule cache: five tenant keys through a cache of two */
+
+    cout << endl << "KEY SCHEDULE CACHE:" << endl;
+
+    AESKeyCache cache(2, 1);
+    auto loadKey = [&](uint64_t keyId, uint8_t* key) // tenant n uses the Appendix C key with n added to its first byte
+    {
+        memcpy(key, keyBytes, 16);
+        key[0] = static_cast<uint8_t>( key[0] + keyId );
+        return static_cast<size_t>( 16 );
+    };
+
+    const uint64_t requests[6] = {0, 1, 0, 2, 3, 0};
+    for(uint64_t keyId : requests)
+    {
+        AESKeyCache::Handle handle = cache.get(keyId, loadKey);
+        uint8_t out[16];
+        handle->encryptBlock(block, out);
+        cout << "    tenant " << dec << keyId << ":       ";
+        printBlock("", out);
+    }
+
+    AESKeyCacheStats stats = cache.stats();
+    cout << "    hits " << dec << stats.hits << ", misses " << stats.misses << ", evictions " << stats.evictions << endl;
+
+
+
+
+    /* bulk modes: SP 800-38A F.5.1 (CTR-AES128.Encrypt, first two blocks) and IEEE 1619 XTS-AES-128 vector 2 */
+
+    cout << endl << "BULK MODES:" << endl;
+
+    const uint8_t ctrKey[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    const uint8_t ctrCounter[16] = {0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff};
+    const uint8_t ctrPlaintext[32] = {0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+                                      0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51};
+    uint8_t ctrOut[32];
+    aesCtrCrypt(AESEngine(ctrKey, 16), ctrCounter, ctrPlaintext, ctrOut, sizeof(ctrOut));
+    printBlock("    CTR:            ", ctrOut);
+    printBlock("                    ", ctrOut + 16);
+
+    uint8_t xtsDataKey[16];
+    uint8_t xtsTweakKey[16];
+    uint8_t xtsSector[32];
+    memset(xtsDataKey, 0x11, sizeof(xtsDataKey));
+    memset(xtsTweakKey, 0x22, sizeof(xtsTweakKey));
+    memset(xtsSector, 0x44, sizeof(xtsSector));
+    AESXTS xts(xtsDataKey, xtsTweakKey, 16);
+    xts.encryptSectors(xtsSector, xtsSector, sizeof(xtsSector), 0x3333333333ULL, 1);
+    printBlock("    XTS:            ", xtsSector);
+    printBlock("                    ", xtsSector + 16);
+
+
+
+
+
+    /* authentication modes: RFC 4493 example 3 (AES-CMAC over 40 bytes), SP 800-38C C.1 example 2 (AES-CCM, 6 byte tag) and
+       the RFC 8452 C.1 AEAD_AES_128_GCM_SIV example with an 8 byte plaintext */
+
+    cout << endl << "AUTHENTICATION MODES:" << endl;
+
+    uint8_t cmacTag[AESCMAC::TagSize];
+    uint8_t cmacMessage[40];
+    memcpy(cmacMessage, ctrPlaintext, 32); // the same key and first blocks as the CTR vector
+    memcpy(cmacMessage + 32, "\x30\xc8\x1c\x46\xa3\x5c\xe4\x11", 8);
+    AESCMAC(ctrKey, 16).tag(cmacMessage, sizeof(cmacMessage), cmacTag);
+    printBlock("    CMAC:           ", cmacTag);
+
+    uint8_t ccmKey[16];
+    uint8_t ccmNonce[8];
+    uint8_t ccmAad[16];
+    uint8_t ccmPayload[16];
+    for(int i = 0; i < 16; i++)
+    {
+        ccmKey[i] = static_cast<uint8_t>( 0x40 + i );
+        ccmAad[i] = static_cast<uint8_t>( i );
+        ccmPayload[i] = static_cast<uint8_t>( 0x20 + i );
+    }
+    for(int i = 0; i < 8; i++)
+    {
+        ccmNonce[i] = static_cast<uint8_t>( 0x10 + i );
+    }
+
+    AESCCM ccm(ccmKey, 16, sizeof(ccmNonce), 6);
+    uint8_t ccmTag[6];
+    ccm.seal(ccmNonce, ccmAad, sizeof(ccmAad), ccmPayload, sizeof(ccmPayload), ccmPayload, ccmTag);
+    printBlock("    CCM:            ", ccmPayload);
+    cout << "    CCM tag:        ";
+    for(uint8_t b : ccmTag)
+    {
+        cout << hex << setw(2) << setfill('0') << static_cast<int>( b );
+    }
+    cout << endl;
+
+    uint8_t sivKey[16] = {0x01};
+    uint8_t sivNonce[AESGCMSIV::NonceSize] = {0x03};
+    uint8_t sivMessage[8] = {0x01};
+    uint8_t sivTag[AESGCMSIV::TagSize];
+    AESGCMSIV siv(sivKey, sizeof(sivKey));
+    siv.seal(sivNonce, nullptr, 0, sivMessage, sizeof(sivMessage), sivMessage, sivTag);
+    cout << "    GCM-SIV:        ";
+    for(uint8_t b : sivMessage)
+    {
+        cout << hex << setw(2) << setfill('0') << static_cast<int>( b );
+    }
+    cout << endl;
+    printBlock("    GCM-SIV tag:    ", sivTag);
+
+
+
+
+    /* key storage: a schedule sits in one cache line aligned SecureArray that a move hands over without copying */
+    cout << endl << "KEY STORAGE:" << endl;
+
+    AES128 original(keyBytes);
+    const uint32_t* schedule = original.schedule();
+    AES128 moved(move(original));
+    bool inPlace = moved.schedule() == schedule && reinterpret_cast<uintptr_t>( schedule ) % SecureArray<uint32_t>::Alignment == 0;
+    cout << "    schedule:       " << (inPlace ? "64 byte aligned, moved in place" : "COPIED OR MISALIGNED") << endl;
+
+    uint8_t keyOut[16];
+    moved.encryptBlock(block, keyOut);
+    printBlock("    after move:     ", keyOut);
+
+    setKeyMemoryLocking(true);
+    AESEngine lockedEngine(keyBytes, 16);
+    setKeyMemoryLocking(false);
+    lockedEngine.encryptBlock(block, keyOut);
+    printBlock("    locked key:     ", keyOut);
+
+
+
+
+    /* key checks: a hex key of valid digits but no AES length must be refused before the key expansion */
+    cout << endl << "KEY CHECKS:" << endl;
+
+    try
+    {
+        AES shortKey(input, "0011223344", false);
+        cout << "    5 byte key:     ACCEPTED" << endl;
+    }
+    catch(const invalid_argument& error)
+    {
+        cout << "    5 byte key:     rejected (" << error.what() << ")" << endl;
+    }
+
+    PERF_REPORT(cout); // only when built with -DCRYPTO_PERF_COUNTERS
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,324 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the benchmark runner. Each benchmark is run with a growing iteration count until one run
+ *                  lasts at least --benchmark_min_time seconds, then the last run is reported.
+ *
+ * Options:         --benchmark_filter=<regex>       only run benchmarks whose name matches
+ *                  --benchmark_min_time=<seconds>   minimum measured time per benchmark (default 0.5)
+ *                  --benchmark_format=console|json  format written to stdout
+ *                  --benchmark_out=<file>           also write JSON results to a file
+ *                  --benchmark_list_tests           print benchmark names and exit
+*/
+
+#include "Benchmark.h"
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <sstream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace benchmark
+{
+
+static uint64_t nowNs()
+{
+    return static_cast<uint64_t>( chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count() );
+}
+
+
+// Time stamp counter; on current x86 parts this counts at the nominal frequency regardless of turbo
+static uint64_t nowCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+
+bool State::Iterator::operator!=(const Iterator&) const
+{
+    if(remaining != 0)
+    {
+        return true;
+    }
+    parent->stopCycles = nowCycles();
+    parent->stopNs = nowNs();
+    return false;
+}
+
+
+State::Iterator State::begin()
+{
+    startNs = nowNs();
+    startCycles = nowCycles();
+    return Iterator{maxIterations, this};
+}
+
+
+
+
+static vector<unique_ptr<Benchmark>>& registry()
+{
+    static vector<unique_ptr<Benchmark>> benchmarks;
+    return benchmarks;
+}
+
+
+Benchmark::Benchmark(const char* name, void (*function)(State&)) : name(name), function(function), multiplier(8)
+{
+}
+
+
+Benchmark* Benchmark::Arg(int64_t value)
+{
+    argumentSets.push_back({value});
+    return this;
+}
+
+
+Benchmark* Benchmark::RangeMultiplier(int value)
+{
+    multiplier = value;
+    return this;
+}
+
+
+Benchmark* Benchmark::Range(int64_t lo, int64_t hi)
+{
+    for(int64_t value = lo; value < hi; value *= multiplier)
+    {
+        argumentSets.push_back({value});
+    }
+    argumentSets.push_back({hi});
+    return this;
+}
+
+
+Benchmark* registerBenchmark(const char* name, void (*function)(State&))
+{
+    registry().emplace_back(new Benchmark(name, function));
+    return registry().back().get();
+}
+
+
+
+
+struct Result
+{
+    string name;
+    uint64_t iterations;
+    double nsPerOp;
+    double cyclesPerOp;
+    double cyclesPerByte;
+    double bytesPerSecond;
+    double itemsPerSecond;
+};
+
+
+static Result measure(const Benchmark& bench, const vector<int64_t>& args, const string& name, double minTime)
+{
+    uint64_t iterations = 1;
+
+    while(true)
+    {
+        State state(iterations, args);
+        bench.function(state);
+
+        double seconds = (state.stopNs - state.startNs) / 1e9;
+
+        // stop once the run is long enough, or the iteration count can not grow any further
+        if(seconds >= minTime || iterations >= 1000000000)
+        {
+            Result result;
+            result.name = name;
+            result.iterations = iterations;
+            result.nsPerOp = (state.stopNs - state.startNs) / static_cast<double>( iterations );
+            result.cyclesPerOp = (state.stopCycles - state.startCycles) / static_cast<double>( iterations );
+            result.cyclesPerByte = state.bytes ? (state.stopCycles - state.startCycles) / static_cast<double>( state.bytes ) : 0.0;
+            result.bytesPerSecond = state.bytes && seconds > 0 ? state.bytes / seconds : 0.0;
+            result.itemsPerSecond = state.items && seconds > 0 ? state.items / seconds : 0.0;
+            return result;
+        }
+
+        // aim 40% past the target so the next attempt is usually the last one
+        double scale = seconds > 0 ? (minTime * 1.4) / seconds : 10.0;
+        if(scale > 10.0)
+        {
+            scale = 10.0;
+        }
+        uint64_t next = static_cast<uint64_t>( iterations * scale );
+        iterations = next > iterations ? next : iterations + 1;
+    }
+}
+
+
+static string jsonEscape(const string& text)
+{
+    string out;
+    for(char c : text)
+    {
+        if(c == '"' || c == '\\')
+        {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+
+static void writeJson(ostream& out, const vector<Result>& results)
+{
+    time_t now = time(nullptr);
+    char date[64];
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+
+    out << "{" << endl;
+    out << "  \"context\": {" << endl;
+    out << "    \"date\": \"" << date << "\"," << endl;
+#ifdef NDEBUG
+    out << "    \"library_build_type\": \"release\"" << endl;
+#else
+    out << "    \"library_build_type\": \"debug\"" << endl;
+#endif
+    out << "  }," << endl;
+    out << "  \"benchmarks\": [" << endl;
+
+    for(size_t i = 0; i < results.size(); i++)
+    {
+        const Result& r = results[i];
+        out << "    {" << endl;
+        out << "      \"name\": \"" << jsonEscape(r.name) << "\"," << endl;
+        out << "      \"iterations\": " << r.iterations << "," << endl;
+        out << "      \"real_time\": " << setprecision(6) << r.nsPerOp << "," << endl;
+        out << "      \"time_unit\": \"ns\"," << endl;
+        out << "      \"cycles_per_op\": " << r.cyclesPerOp << "," << endl;
+        out << "      \"cycles_per_byte\": " << r.cyclesPerByte << "," << endl;
+        out << "      \"bytes_per_second\": " << setprecision(12) << r.bytesPerSecond;
+        if(r.itemsPerSecond > 0)
+        {
+            out << "," << endl << "      \"items_per_second\": " << r.itemsPerSecond;
+        }
+        out << endl;
+        out << "    }" << (i + 1 < results.size() ? "," : "") << endl;
+    }
+
+    out << "  ]" << endl;
+    out << "}" << endl;
+}
+
+
+static void printRow(const Result& r)
+{
+    cout << left << setw(40) << r.name << right
+         << setw(14) << fixed << setprecision(1) << r.nsPerOp << " ns"
+         << setw(14) << setprecision(2) << r.cyclesPerByte << " c/B"
+         << setw(12) << setprecision(1);
+    if(r.bytesPerSecond == 0 && r.itemsPerSecond > 0)
+    {
+        cout << r.itemsPerSecond << " it/s";
+    }
+    else
+    {
+        cout << r.bytesPerSecond / 1e6 << " MB/s";
+    }
+    cout << setw(14) << r.iterations << endl;
+}
+
+
+int runBenchmarks(int argc, char** argv)
+{
+    string filter = ".*";
+    string format = "console";
+    string outFile;
+    double minTime = 0.5;
+    bool list = false;
+
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        auto value = [&](const string& flag) { return arg.substr(flag.length()); };
+
+        if(arg.rfind("--benchmark_filter=", 0) == 0) filter = value("--benchmark_filter=");
+        else if(arg.rfind("--benchmark_min_time=", 0) == 0) minTime = stod(value("--benchmark_min_time="));
+        else if(arg.rfind("--benchmark_format=", 0) == 0) format = value("--benchmark_format=");
+        else if(arg.rfind("--benchmark_out=", 0) == 0) outFile = value("--benchmark_out=");
+        else if(arg == "--benchmark_list_tests") list = true;
+        else
+        {
+            cerr << "unknown option " << arg << endl;
+            return 1;
+        }
+    }
+
+    regex pattern(filter);
+    vector<Result> results;
+
+    if(format == "console" && !list)
+    {
+        cout << left << setw(40) << "Benchmark" << right << setw(17) << "Time" << setw(18) << "Cycles/Byte"
+             << setw(17) << "Throughput" << setw(14) << "Iterations" << endl;
+        cout << string(106, '-') << endl;
+    }
+
+    for(const auto& bench : registry())
+    {
+        vector<vector<int64_t>> sets = bench->argumentSets;
+        if(sets.empty())
+        {
+            sets.push_back({});
+        }
+
+        for(const auto& args : sets)
+        {
+            string name = bench->name;
+            for(int64_t arg : args)
+            {
+                name += "/" + to_string(arg);
+            }
+
+            if(!regex_search(name, pattern))
+            {
+                continue;
+            }
+            if(list)
+            {
+                cout << name << endl;
+                continue;
+            }
+
+            results.push_back(measure(*bench, args, name, minTime));
+            if(format == "console")
+            {
+                printRow(results.back());
+            }
+        }
+    }
+
+    if(format == "json" && !list)
+    {
+        writeJson(cout, results);
+    }
+    if(!outFile.empty())
+    {
+        ofstream file(outFile);
+        writeJson(file, results);
+    }
+
+    return 0;
+}
+
+}
@@ -0,0 +1,99 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains a small micro-benchmark harness modelled on Google Benchmark. Benchmarks are registered with
+ *                  BENCHMARK(function), loop with "for(auto _ : state)", and report ns/op and cycles/byte on the console or as JSON.
+*/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace benchmark
+{
+
+class State
+{
+    public:
+        State(uint64_t iterations, vector<int64_t> args) : maxIterations(iterations), arguments(args), bytes(0), items(0) {}
+
+        // range-for support: "for(auto _ : state)" runs the body maxIterations times between the timer start and stop
+        struct Value
+        {
+            ~Value() {} // non-trivial so that an unused loop variable does not warn
+        };
+        struct Iterator
+        {
+            uint64_t remaining;
+            State* parent;
+            bool operator!=(const Iterator&) const;
+            void operator++() { remaining--; }
+            Value operator*() const { return Value(); }
+        };
+        Iterator begin();
+        Iterator end() { return Iterator{0, this}; }
+
+        int64_t range(size_t index = 0) const { return arguments.at(index); }
+        uint64_t iterations() const { return maxIterations; }
+        void SetBytesProcessed(uint64_t total) { bytes = total; }
+        void SetItemsProcessed(uint64_t total) { items = total; } // for benchmarks whose unit of work is not bytes
+
+        // filled in by the runner
+        uint64_t maxIterations;
+        vector<int64_t> arguments;
+        uint64_t bytes;
+        uint64_t items;
+        uint64_t startNs, stopNs;
+        uint64_t startCycles, stopCycles;
+};
+
+
+class Benchmark
+{
+    public:
+        Benchmark(const char* name, void (*function)(State&));
+
+        Benchmark* Arg(int64_t);
+        Benchmark* Range(int64_t, int64_t); // powers of the multiplier from lo to hi, inclusive
+        Benchmark* RangeMultiplier(int);
+
+        string name;
+        void (*function)(State&);
+        vector<vector<int64_t>> argumentSets;
+        int multiplier;
+};
+
+
+// Keeps the compiler from discarding a value or the memory behind it
+template<typename T>
+inline void DoNotOptimize(T const& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void ClobberMemory()
+{
+    asm volatile("" : : : "memory");
+}
+
+Benchmark* registerBenchmark(const char*, void (*)(State&));
+int runBenchmarks(int argc, char** argv);
+
+}
+
+#define BENCHMARK_CONCAT2(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT2(a, b)
+#define BENCHMARK(function) \
+    static benchmark::Benchmark* BENCHMARK_CONCAT(benchmark_, __LINE__) = benchmark::registerBenchmark(#function, function)
+#define BENCHMARK_MAIN() \
+    int main(int argc, char** argv) { return benchmark::runBenchmarks(argc, argv); }
+
+#endif
@@ -0,0 +1,663 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This program benchmarks the AES and SHA1 primitives: finite field multiplication, MixColumns, key expansion,
+ *                  single block cipher and inverse cipher for each key size, the SHA1 compression function, and SHA1 digests of
+ *                  16 B to 1 GiB messages.
+ *
+ * Compilation:     cmake -S . -B build && cmake --build build --target crypto_bench        (from the repository root)
+ *
+ * Usage:           ./crypto_bench [--benchmark_filter=<regex>] [--benchmark_format=json] [--benchmark_out=results.json]
+*/
+
+#include "Benchmark.h"
+#include "../Advanced Encryption Standard (AES)/AES.h"
+#include "../Advanced Encryption Standard (AES)/AESEngine.h"
+#include "../Advanced Encryption Standard (AES)/AESBatch.h"
+#include "../Advanced Encryption Standard (AES)/AESCCM.h"
+#include "../Advanced Encryption Standard (AES)/AESCMAC.h"
+#include "../Advanced Encryption Standard (AES)/AESGCMSIV.h"
+#include "../Advanced Encryption Standard (AES)/AESKeyCache.h"
+#include "../Advanced Encryption Standard (AES)/AESModes.h"
+#include "../Advanced Encryption Standard (AES)/GF256.h"
+#include "../Secure Hash Algorithm 1 (SHA1)/SHA1.h"
+#include "../Secure Hash Algorithm 1 (SHA1)/SHA1Tree.h"
+#include "../Secure Hash Algorithm 1 (SHA1)/HMACSHA1.h"
+#include "../Secure Hash Algorithm 2 (SHA2)/SHA2.h"
+
+#include <cstring>
+#include <vector>
+
+using benchmark::State;
+using benchmark::DoNotOptimize;
+using benchmark::ClobberMemory;
+
+
+static const uint8_t KeyBytes[32] =
+{
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+
+static const uint8_t Plaintext[16] =
+{
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+
+
+// Gives the benchmarks access to the private round primitives of the AES class
+class AESBenchmark
+{
+    public:
+        static void ffMultiply(State& state)
+        {
+            AES aes(KeyBytes, 16);
+            uint8_t a = 0x57;
+            uint8_t b = 0x83;
+
+            for(auto _ : state)
+            {
+                DoNotOptimize(a);
+                DoNotOptimize(b);
+                uint8_t product = aes.ffMultiply(a, b);
+                DoNotOptimize(product);
+            }
+        }
+
+        static void MixColumns(State& state)
+        {
+            AES aes(KeyBytes, 16);
+            AESState s{};
+
+            for(auto _ : state)
+            {
+                aes.MixColumns(s);
+                ClobberMemory();
+            }
+            state.SetBytesProcessed(state.iterations() * 16);
+        }
+
+        static void InvMixColumns(State& state)
+        {
+            AES aes(KeyBytes, 16);
+            AESState s{};
+
+            for(auto _ : state)
+            {
+                aes.InvMixColumns(s);
+                ClobberMemory();
+            }
+            state.SetBytesProcessed(state.iterations() * 16);
+        }
+
+        static void KeyExpansion(State& state)
+        {
+            AES aes(KeyBytes, state.range(0) / 8);
+
+            for(auto _ : state)
+            {
+                aes.KeyExpansion(aes.key, aes.w, aes.Nk);
+                ClobberMemory();
+            }
+        }
+};
+
+
+static void BM_AES_ffMultiply(State& state) { AESBenchmark::ffMultiply(state); }
+BENCHMARK(BM_AES_ffMultiply);
+
+static void BM_AES_MixColumns(State& state) { AESBenchmark::MixColumns(state); }
+BENCHMARK(BM_AES_MixColumns);
+
+static void BM_AES_InvMixColumns(State& state) { AESBenchmark::InvMixColumns(state); }
+BENCHMARK(BM_AES_InvMixColumns);
+
+static void BM_AES_KeyExpansion(State& state) { AESBenchmark::KeyExpansion(state); }
+BENCHMARK(BM_AES_KeyExpansion)->Arg(128)->Arg(192)->Arg(256);
+
+
+// range(0) bytes multiplied by one constant with the packed nibble tables
+static void BM_GF256_multiply(State& state)
+{
+    vector<uint8_t> buffer(static_cast<size_t>( state.range(0) ), 0x57);
+    for(auto _ : state)
+    {
+        GF256::multiply(0x83, buffer.data(), buffer.data(), buffer.size());
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GF256_multiply)->Arg(16)->Arg(4096);
+
+
+
+
+// -------------------------------------- AES CLASS --------------------------------------
+
+static void BM_AES_Cipher(State& state)
+{
+    AES aes(KeyBytes, state.range(0) / 8);
+    uint8_t block[16];
+    memcpy(block, Plaintext, 16);
+
+    for(auto _ : state)
+    {
+        aes.Cipher(block, block, 1);
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * 16);
+}
+BENCHMARK(BM_AES_Cipher)->Arg(128)->Arg(192)->Arg(256);
+
+
+static void BM_AES_Decipher(State& state)
+{
+    AES aes(KeyBytes, state.range(0) / 8);
+    uint8_t block[16];
+    memcpy(block, Plaintext, 16);
+
+    for(auto _ : state)
+    {
+        aes.Decipher(block, block, 1);
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * 16);
+}
+BENCHMARK(BM_AES_Decipher)->Arg(128)->Arg(192)->Arg(256);
+
+
+
+
+// -------------------------------------- FIXED KEY SIZE --------------------------------------
+
+template<int KeyBits>
+static void BM_AESFixed_KeyExpansion(State& state)
+{
+    AESFixed<KeyBits> aes;
+
+    for(auto _ : state)
+    {
+        aes.KeyExpansion(KeyBytes);
+        ClobberMemory();
+    }
+}
+BENCHMARK(BM_AESFixed_KeyExpansion<128>);
+BENCHMARK(BM_AESFixed_KeyExpansion<192>);
+BENCHMARK(BM_AESFixed_KeyExpansion<256>);
+
+
+template<int KeyBits>
+static void BM_AESFixed_Cipher(State& state)
+{
+    AESFixed<KeyBits> aes(KeyBytes);
+    uint8_t block[16];
+    memcpy(block, Plaintext, 16);
+
+    for(auto _ : state)
+    {
+        aes.encryptBlock(block, block);
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * 16);
+}
+BENCHMARK(BM_AESFixed_Cipher<128>);
+BENCHMARK(BM_AESFixed_Cipher<192>);
+BENCHMARK(BM_AESFixed_Cipher<256>);
+
+
+template<int KeyBits>
+static void BM_AESFixed_Decipher(State& state)
+{
+    AESFixed<KeyBits> aes(KeyBytes);
+    uint8_t block[16];
+    memcpy(block, Plaintext, 16);
+
+    for(auto _ : state)
+    {
+        aes.decryptBlock(block, block);
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * 16);
+}
+BENCHMARK(BM_AESFixed_Decipher<128>);
+BENCHMARK(BM_AESFixed_Decipher<192>);
+BENCHMARK(BM_AESFixed_Decipher<256>);
+
+
+
+
+// -------------------------------------- RUNTIME DISPATCH --------------------------------------
+
+// ECB over a 4 KiB buffer through AESEngine, which picks VAES, AES-NI or the portable code at runtime
+static void BM_AESEngine_encryptBlocks(State& state)
+{
+    AESEngine engine(KeyBytes, state.range(0) / 8);
+    vector<uint8_t> buffer(4096);
+
+    for(auto _ : state)
+    {
+        engine.encryptBlocks(buffer.data(), buffer.data(), buffer.size() / 16);
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(BM_AESEngine_encryptBlocks)->Arg(128)->Arg(192)->Arg(256);
+
+
+static void BM_AESEngine_decryptBlocks(State& state)
+{
+    AESEngine engine(KeyBytes, state.range(0) / 8);
+    vector<uint8_t> buffer(4096);
+
+    for(auto _ : state)
+    {
+        engine.decryptBlocks(buffer.data(), buffer.data(), buffer.size() / 16);
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(BM_AESEngine_decryptBlocks)->Arg(128)->Arg(192)->Arg(256);
+
+
+// 1024 message bus records of 50 to 500 bytes sealed into one arena
+static void BM_AESBatch_seal(State& state)
+{
+    const size_t count = 1024;
+    AESBatch batch(KeyBytes, KeyBytes + 16, 16);
+    vector<uint8_t> payload(512 * count, 0x5a);
+    vector<uint8_t> nonces(AESBatch::NonceSize * count);
+    vector<AESRecord> records(count);
+    size_t bytes = 0;
+    for(size_t i = 0; i < count; i++)
+    {
+        nonces[AESBatch::NonceSize * i] = static_cast<uint8_t>( i );
+        nonces[AESBatch::NonceSize * i + 1] = static_cast<uint8_t>( i >> 8 );
+        size_t length = 50 + (i * 7919) % 451;
+        records[i] = AESRecord{payload.data() + 512 * i, length, nullptr, 0, nonces.data() + AESBatch::NonceSize * i, nullptr};
+        bytes += length;
+    }
+    vector<uint8_t> arena(AESBatch::arenaSize(records.data(), count));
+    vector<AESRecordOutput> outputs(count);
+
+    for(auto _ : state)
+    {
+        batch.seal(records.data(), count, arena.data(), arena.size(), outputs.data());
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_AESBatch_seal);
+
+
+// 1024 messages of 512 bytes: one at a time (range(0) = 0) or with their chains interleaved (range(0) = 1)
+static void BM_AESCMAC_tag(State& state)
+{
+    const size_t count = 1024;
+    AESCMAC cmac(KeyBytes, 16);
+    vector<uint8_t> payload(512 * count, 0x5a);
+    vector<const uint8_t*> messages(count);
+    vector<size_t> lengths(count, 512);
+    vector<uint8_t> tags(AESCMAC::TagSize * count);
+    for(size_t i = 0; i < count; i++)
+    {
+        messages[i] = payload.data() + 512 * i;
+    }
+
+    for(auto _ : state)
+    {
+        if(state.range(0))
+        {
+            cmac.tagMany(messages.data(), lengths.data(), count, tags.data());
+        }
+        else
+        {
+            for(size_t i = 0; i < count; i++)
+            {
+                cmac.tag(messages[i], lengths[i], tags.data() + AESCMAC::TagSize * i);
+            }
+        }
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK(BM_AESCMAC_tag)->Arg(0)->Arg(1);
+
+
+// 1024 records of 50 to 500 bytes sealed with AES-CCM
+static void BM_AESCCM_sealMany(State& state)
+{
+    const size_t count = 1024;
+    AESCCM ccm(KeyBytes, 16);
+    vector<uint8_t> payload(512 * count, 0x5a);
+    vector<uint8_t> output(512 * count);
+    vector<uint8_t> tags(16 * count);
+    vector<uint8_t> nonces(12 * count);
+    vector<AESRecord> records(count);
+    vector<AESRecordOutput> outputs(count);
+    size_t bytes = 0;
+    for(size_t i = 0; i < count; i++)
+    {
+        nonces[12 * i] = static_cast<uint8_t>( i );
+        nonces[12 * i + 1] = static_cast<uint8_t>( i >> 8 );
+        size_t length = 50 + (i * 7919) % 451;
+        records[i] = AESRecord{payload.data() + 512 * i, length, nullptr, 0, nonces.data() + 12 * i, nullptr};
+        outputs[i] = AESRecordOutput{output.data() + 512 * i, length, tags.data() + 16 * i};
+        bytes += length;
+    }
+
+    for(auto _ : state)
+    {
+        ccm.sealMany(records.data(), count, outputs.data());
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_AESCCM_sealMany);
+
+
+// one message of range(0) bytes, including the per-nonce key derivation; seal takes two passes, open one
+static void BM_AESGCMSIV_seal(State& state)
+{
+    size_t length = static_cast<size_t>( state.range(0) );
+    AESGCMSIV siv(KeyBytes, 16);
+    vector<uint8_t> message(length, 0x5a);
+    uint8_t nonce[AESGCMSIV::NonceSize] = {};
+    uint8_t tag[AESGCMSIV::TagSize];
+
+    for(auto _ : state)
+    {
+        siv.seal(nonce, nullptr, 0, message.data(), length, message.data(), tag);
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * length);
+}
+BENCHMARK(BM_AESGCMSIV_seal)->RangeMultiplier(16)->Range(64, 1 << 24);
+
+
+static void BM_AESGCMSIV_open(State& state)
+{
+    size_t length = static_cast<size_t>( state.range(0) );
+    AESGCMSIV siv(KeyBytes, 16);
+    vector<uint8_t> message(length, 0x5a);
+    vector<uint8_t> opened(length);
+    uint8_t nonce[AESGCMSIV::NonceSize] = {};
+    uint8_t tag[AESGCMSIV::TagSize];
+    siv.seal(nonce, nullptr, 0, message.data(), length, message.data(), tag);
+
+    for(auto _ : state)
+    {
+        DoNotOptimize(siv.open(nonce, nullptr, 0, message.data(), length, tag, opened.data()));
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * length);
+}
+BENCHMARK(BM_AESGCMSIV_open)->RangeMultiplier(16)->Range(64, 1 << 24);
+
+
+// one block under one of range(0) tenant keys per request through a cache of 1024; beyond the capacity every request misses
+static void BM_AESKeyCache_get(State& state)
+{
+    uint64_t tenants = static_cast<uint64_t>( state.range(0) );
+    AESKeyCache cache(1024);
+    auto load = [](uint64_t keyId, uint8_t* key)
+    {
+        memcpy(key, KeyBytes, 16);
+        memcpy(key, &keyId, sizeof(keyId));
+        return static_cast<size_t>( 16 );
+    };
+    uint8_t block[16];
+    memcpy(block, Plaintext, 16);
+    uint64_t keyId = 0;
+
+    for(auto _ : state)
+    {
+        keyId = (keyId + 7919) % tenants;
+        AESKeyCache::Handle handle = cache.get(keyId, load);
+        handle->encryptBlock(block, block);
+        ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AESKeyCache_get)->Arg(512)->Arg(100000);
+
+
+// range(0) bytes in counter mode on the shared pool
+static void BM_AES_CtrCrypt(State& state)
+{
+    AESEngine engine(KeyBytes, 16);
+    vector<uint8_t> buffer(static_cast<size_t>( state.range(0) ), 0x5a);
+    for(auto _ : state)
+    {
+        aesCtrCrypt(engine, Plaintext, buffer.data(), buffer.data(), buffer.size());
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AES_CtrCrypt)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+
+// 4 KiB sectors of a 16 MiB extent
+static void BM_AESXTS_encryptSectors(State& state)
+{
+    uint8_t tweakKey[16];
+    for(int i = 0; i < 16; i++)
+    {
+        tweakKey[i] = static_cast<uint8_t>( KeyBytes[i] ^ 0xFF );
+    }
+    AESXTS xts(KeyBytes, tweakKey, 16);
+    const size_t sectorSize = 4096;
+    vector<uint8_t> buffer(1 << 24, 0x5a);
+    for(auto _ : state)
+    {
+        xts.encryptSectors(buffer.data(), buffer.data(), sectorSize, 0, buffer.size() / sectorSize);
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(BM_AESXTS_encryptSectors);
+
+
+
+
+// -------------------------------------- SHA1 --------------------------------------
+
+static void BM_SHA1_processBlock(State& state)
+{
+    SHA1 sha1;
+    uint8_t block[64] = {};
+
+    for(auto _ : state)
+    {
+        sha1.processBlock(block);
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_SHA1_processBlock);
+
+
+// processBlocks dispatches to SHA-NI when the CPU has it
+static void BM_SHA1_processBlocks(State& state)
+{
+    SHA1 sha1;
+    vector<uint8_t> blocks(64 * 64);
+
+    for(auto _ : state)
+    {
+        sha1.processBlocks(blocks.data(), 64);
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * blocks.size());
+}
+BENCHMARK(BM_SHA1_processBlocks);
+
+
+static void BM_SHA1_digest(State& state)
+{
+    // one buffer shared by every size, grown on demand so that filtering out the large sizes also skips the allocation
+    static vector<uint8_t> message;
+    size_t length = static_cast<size_t>( state.range(0) );
+    if(message.size() < length)
+    {
+        message.resize(length, 0x61);
+    }
+
+    SHA1 sha1;
+    uint8_t digest[SHA1::DigestSize];
+
+    for(auto _ : state)
+    {
+        sha1.digest(message.data(), length, digest);
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * length);
+}
+BENCHMARK(BM_SHA1_digest)->RangeMultiplier(4)->Range(16, 1 << 30);
+
+
+// 64 MiB object in leaves of range(0) bytes, binary tree, one thread per core
+static void BM_SHA1Tree_build(State& state)
+{
+    static vector<uint8_t> object(64 << 20, 0x61);
+    SHA1Tree tree(static_cast<size_t>( state.range(0) ));
+
+    for(auto _ : state)
+    {
+        tree.build(object.data(), object.size());
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * object.size());
+}
+BENCHMARK(BM_SHA1Tree_build)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+
+// re-hash after one 4 KiB write into the same object with 64 KiB leaves
+static void BM_SHA1Tree_update(State& state)
+{
+    static vector<uint8_t> object(64 << 20, 0x61);
+    SHA1Tree tree(1 << 16);
+    tree.build(object.data(), object.size());
+    size_t offset = 0;
+
+    for(auto _ : state)
+    {
+        offset = (offset + 7919 * 4096) % object.size();
+        object[offset]++;
+        tree.update(object.data(), object.size(), offset & ~static_cast<size_t>( 4095 ), 4096, 1);
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * 4096);
+}
+BENCHMARK(BM_SHA1Tree_update);
+
+
+
+// range(0) candidate passwords at 10000 iterations on one thread; reported as derived keys per second
+static void BM_PBKDF2_HMAC_SHA1(State& state)
+{
+    size_t count = static_cast<size_t>( state.range(0) );
+    const uint8_t salt[16] = {};
+    vector<uint8_t> passwords(count * 12, 0x70);
+    vector<const uint8_t*> pointers(count);
+    vector<size_t> lengths(count, 12);
+    vector<uint8_t> keys(count * 20);
+    for(size_t i = 0; i < count; i++)
+    {
+        pointers[i] = passwords.data() + 12 * i;
+        passwords[12 * i] = static_cast<uint8_t>( i );
+    }
+
+    for(auto _ : state)
+    {
+        pbkdf2HmacSha1Batch(pointers.data(), lengths.data(), count, salt, sizeof(salt), 10000, keys.data(), 20, 1);
+        ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_PBKDF2_HMAC_SHA1)->Arg(1)->Arg(8)->Arg(64);
+
+
+// 256 (message, tag) pairs of range(0) bytes checked in one batch; the items are pairs
+static void BM_HMACSHA1_verifyMany(State& state)
+{
+    const size_t count = 256;
+    size_t length = static_cast<size_t>( state.range(0) );
+    HMACSHA1 hmac(reinterpret_cast<const uint8_t*>("Jefe"), 4);
+    vector<uint8_t> messages(count * length, 0x61);
+    vector<uint8_t> tags(count * HMACSHA1::DigestSize);
+
+    const uint8_t* pointers[count];
+    const uint8_t* tagPointers[count];
+    size_t lengths[count];
+    for(size_t i = 0; i < count; i++)
+    {
+        pointers[i] = messages.data() + i * length;
+        lengths[i] = length;
+        tagPointers[i] = tags.data() + i * HMACSHA1::DigestSize;
+        hmac.mac(pointers[i], length, tags.data() + i * HMACSHA1::DigestSize);
+    }
+
+    uint64_t valid[count / 64];
+    for(auto _ : state)
+    {
+        hmac.verifyMany(pointers, lengths, tagPointers, count, valid, 1);
+        DoNotOptimize(valid[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * count * length);
+}
+BENCHMARK(BM_HMACSHA1_verifyMany)->Arg(16)->Arg(64)->Arg(1024)->Arg(16384);
+
+
+template<typename Hash>
+static void BM_SHA2_digest(State& state)
+{
+    size_t length = static_cast<size_t>( state.range(0) );
+    vector<uint8_t> message(length, 0x61);
+    Hash hash;
+    uint8_t digest[Hash::DigestSize];
+
+    for(auto _ : state)
+    {
+        hash.digest(message.data(), length, digest);
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * length);
+}
+BENCHMARK(BM_SHA2_digest<SHA256>)->RangeMultiplier(16)->Range(64, 1 << 20);
+BENCHMARK(BM_SHA2_digest<SHA512>)->RangeMultiplier(16)->Range(64, 1 << 20);
+
+
+// 64 independent messages of range(0) bytes through the multi-buffer interface
+template<typename Hash>
+static void BM_SHA2_digestMany(State& state)
+{
+    const size_t count = 64;
+    size_t length = static_cast<size_t>( state.range(0) );
+    vector<uint8_t> messages(count * length, 0x61);
+    vector<uint8_t> digests(count * Hash::DigestSize);
+
+    const uint8_t* pointers[count];
+    size_t lengths[count];
+    for(size_t i = 0; i < count; i++)
+    {
+        pointers[i] = messages.data() + i * length;
+        lengths[i] = length;
+    }
+
+    for(auto _ : state)
+    {
+        Hash::digestMany(pointers, lengths, count, digests.data());
+        ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * count * length);
+}
+BENCHMARK(BM_SHA2_digestMany<SHA256>)->RangeMultiplier(16)->Range(64, 1 << 14);
+BENCHMARK(BM_SHA2_digestMany<SHA512>)->RangeMultiplier(16)->Range(64, 1 << 14);
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,606 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This program is the differential harness for the AES backends. It proves two things in one run:
+ *                    - correctness: random keys of every size and random buffers of 1 to 64 blocks go through every backend the
+ *                      CPU has, both ways, and each ciphertext must equal the one from a textbook FIPS-197 implementation kept
+ *                      here. That reference computes its own S-box from the field inverse, so it shares no table or code with
+ *                      the backends under test, the AES class included.
+ *                    - speed: the throughput of every backend and key size is measured after the fuzzing. Every backend on a
+ *                      hardware kernel must beat the AES::Cipher path, which is what it replaces, by --min-speedup, and with
+ *                      --baseline every one must stay within --threshold of the throughput a previous run saved with --save.
+ *                      The portable AESFixed is only held to the baseline: its byte-wise rounds trail the SSSE3 state of the
+ *                      AES class, and it is there for code that needs a key of fixed size without any dispatch.
+ *                  A new backend is one more Backend subclass in the list in main(). Any mismatch makes the exit status 1 and
+ *                  prints the seed and case, so it can be replayed. Timings depend on the load of the machine, so the speed
+ *                  checks only report unless --enforce-speed is given; the tests that enforce them are opt-in
+ *                  (CRYPTO_PERF_TESTS).
+ *
+ * Compilation:     cmake -S . -B build && cmake --build build --target crypto_fuzz_diff        (from the repository root)
+ *
+ * Usage:           ./crypto_fuzz_diff [options]
+ *                      --iterations=<n>        random cases per backend (default 2000)
+ *                      --seed=<n>              seed of the cases (default: random)
+ *                      --min-time=<seconds>    measuring time per backend, key size and direction (default 0.1)
+ *                      --min-speedup=<x>       required throughput over AES::Cipher (default 1.0)
+ *                      --save=<path>           write the measured throughput as a baseline
+ *                      --baseline=<path>       fail if a backend is slower than this baseline by more than the threshold
+ *                      --threshold=<fraction>  allowed slowdown against the baseline (default 0.2)
+ *                      --enforce-speed         make a speed check that fails set the exit status, not just report
+*/
+
+#include "../Advanced Encryption Standard (AES)/AES.h"
+#include "../Advanced Encryption Standard (AES)/AESEngine.h"
+#include "../Advanced Encryption Standard (AES)/AESFixed.h"
+#include "../Advanced Encryption Standard (AES)/AESKernels.h"
+#include "../Common/CpuFeatures.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <variant>
+#include <vector>
+
+using namespace std;
+
+
+class Backend
+{
+    public:
+        virtual ~Backend() {}
+        virtual string name() const = 0;
+        virtual bool available() const { return true; }
+        virtual bool accelerated() const { return true; } // runs a hardware kernel, so it is held to --min-speedup over AES::Cipher
+        virtual void setKey(const uint8_t* key, size_t length) = 0;
+        virtual void encrypt(const uint8_t* in, uint8_t* out, size_t blocks) = 0;
+        virtual void decrypt(const uint8_t* in, uint8_t* out, size_t blocks) = 0;
+};
+
+
+
+
+// -------------------------------------- REFERENCE --------------------------------------
+
+// FIPS-197 as written: bytes, xtime, the four transformations one after the other
+class ReferenceBackend : public Backend
+{
+    public:
+        ReferenceBackend()
+        {
+            // S-box: the multiplicative inverse (0 for 0) through the affine transformation of FIPS-197 5.1.1
+            for(int x = 0; x < 256; x++)
+            {
+                uint8_t inverse = 0;
+                for(int y = 1; y < 256 && x != 0; y++)
+                {
+                    if(multiply(static_cast<uint8_t>( x ), static_cast<uint8_t>( y )) == 1)
+                    {
+                        inverse = static_cast<uint8_t>( y );
+                        break;
+                    }
+                }
+
+                uint8_t s = 0x63;
+                for(int bit = 0; bit < 8; bit++)
+                {
+                    int b = (inverse >> bit) ^ (inverse >> ((bit + 4) % 8)) ^ (inverse >> ((bit + 5) % 8)) ^
+                            (inverse >> ((bit + 6) % 8)) ^ (inverse >> ((bit + 7) % 8));
+                    s ^= static_cast<uint8_t>( (b & 1) << bit );
+                }
+                this->sbox[x] = s;
+                this->invSbox[s] = static_cast<uint8_t>( x );
+            }
+        }
+
+        string name() const override { return "reference"; }
+        bool accelerated() const override { return false; }
+
+        void setKey(const uint8_t* key, size_t length) override
+        {
+            int Nk = static_cast<int>( length / 4 );
+            this->Nr = Nk + 6;
+            this->roundKeys.assign(16 * (this->Nr + 1), 0);
+            memcpy(this->roundKeys.data(), key, length);
+
+            uint8_t rcon = 1;
+            for(int i = Nk; i < 4 * (this->Nr + 1); i++)
+            {
+                uint8_t temp[4];
+                memcpy(temp, &this->roundKeys[4 * (i - 1)], 4);
+                if(i % Nk == 0)
+                {
+                    uint8_t first = temp[0];
+                    temp[0] = this->sbox[temp[1]] ^ rcon;
+                    temp[1] = this->sbox[temp[2]];
+                    temp[2] = this->sbox[temp[3]];
+                    temp[3] = this->sbox[first];
+                    rcon = multiply(rcon, 2);
+                }
+                else if(Nk > 6 && i % Nk == 4)
+                {
+                    for(uint8_t& byte : temp)
+                    {
+                        byte = this->sbox[byte];
+                    }
+                }
+                for(int b = 0; b < 4; b++)
+                {
+                    this->roundKeys[4 * i + b] = this->roundKeys[4 * (i - Nk) + b] ^ temp[b];
+                }
+            }
+        }
+
+        void encrypt(const uint8_t* in, uint8_t* out, size_t blocks) override
+        {
+            for(size_t n = 0; n < blocks; n++)
+            {
+                uint8_t s[16];
+                memcpy(s, in + 16 * n, 16);
+                addRoundKey(s, 0);
+                for(int round = 1; round <= this->Nr; round++)
+                {
+                    for(uint8_t& byte : s)
+                    {
+                        byte = this->sbox[byte];
+                    }
+                    shiftRows(s, false);
+                    if(round != this->Nr)
+                    {
+                        mixColumns(s, false);
+                    }
+                    addRoundKey(s, round);
+                }
+                memcpy(out + 16 * n, s, 16);
+            }
+        }
+
+        // the inverse cipher of FIPS-197 5.3, not the equivalent one
+        void decrypt(const uint8_t* in, uint8_t* out, size_t blocks) override
+        {
+            for(size_t n = 0; n < blocks; n++)
+            {
+                uint8_t s[16];
+                memcpy(s, in + 16 * n, 16);
+                addRoundKey(s, this->Nr);
+                for(int round = this->Nr - 1; round >= 0; round--)
+                {
+                    shiftRows(s, true);
+                    for(uint8_t& byte : s)
+                    {
+                        byte = this->invSbox[byte];
+                    }
+                    addRoundKey(s, round);
+                    if(round != 0)
+                    {
+                        mixColumns(s, true);
+                    }
+                }
+                memcpy(out + 16 * n, s, 16);
+            }
+        }
+
+    private:
+        uint8_t sbox[256];
+        uint8_t invSbox[256];
+        vector<uint8_t> roundKeys;
+        int Nr = 0;
+
+        static uint8_t multiply(uint8_t a, uint8_t b)
+        {
+            uint8_t product = 0;
+            for(int bit = 0; bit < 8; bit++)
+            {
+                if(b & 1)
+                {
+                    product ^= a;
+                }
+                a = static_cast<uint8_t>( (a << 1) ^ ((a & 0x80) ? 0x1b : 0x00) );
+                b >>= 1;
+            }
+            return product;
+        }
+
+        void addRoundKey(uint8_t* s, int round)
+        {
+            for(int i = 0; i < 16; i++)
+            {
+                s[i] ^= this->roundKeys[16 * round + i];
+            }
+        }
+
+        // byte (r, c) at s[r + 4c]; row r rotates left by r, or right to invert
+        static void shiftRows(uint8_t* s, bool inverse)
+        {
+            uint8_t t[16];
+            for(int r = 0; r < 4; r++)
+            {
+                for(int c = 0; c < 4; c++)
+                {
+                    int source = inverse ? (c + 4 - r) % 4 : (c + r) % 4;
+                    t[r + 4 * c] = s[r + 4 * source];
+                }
+            }
+            memcpy(s, t, 16);
+        }
+
+        static void mixColumns(uint8_t* s, bool inverse)
+        {
+            const uint8_t forward[4] = {2, 3, 1, 1};
+            const uint8_t backward[4] = {14, 11, 13, 9};
+            const uint8_t* m = inverse ? backward : forward;
+
+            for(int c = 0; c < 4; c++)
+            {
+                uint8_t column[4];
+                memcpy(column, s + 4 * c, 4);
+                for(int r = 0; r < 4; r++)
+                {
+                    s[r + 4 * c] = multiply(m[(4 - r) % 4], column[0]) ^ multiply(m[(5 - r) % 4], column[1]) ^
+                                   multiply(m[(6 - r) % 4], column[2]) ^ multiply(m[(7 - r) % 4], column[3]);
+                }
+            }
+        }
+};
+
+
+
+
+// -------------------------------------- BACKENDS --------------------------------------
+
+// the AES class, the path every faster backend has to beat
+class ClassBackend : public Backend
+{
+    public:
+        string name() const override { return "AES::Cipher"; }
+        bool accelerated() const override { return false; }
+        void setKey(const uint8_t* key, size_t length) override { this->aes.reset(new AES(key, length)); }
+        void encrypt(const uint8_t* in, uint8_t* out, size_t blocks) override { this->aes->Cipher(in, out, blocks); }
+        void decrypt(const uint8_t* in, uint8_t* out, size_t blocks) override { this->aes->Decipher(in, out, blocks); }
+
+    private:
+        unique_ptr<AES> aes;
+};
+
+
+// AESFixed on its own or under one of the block kernels, which take its schedules; a kernel that stops short of the end (VAES
+// works in fours) is finished by the portable code
+class FixedBackend : public Backend
+{
+    public:
+        enum Kernel { Portable, AESNI, VAES };
+
+        explicit FixedBackend(Kernel kernel) : kernel(kernel) {}
+
+        string name() const override
+        {
+            return this->kernel == Portable ? "AESFixed" : this->kernel == AESNI ? "AES-NI" : "VAES";
+        }
+
+        bool accelerated() const override { return this->kernel != Portable; }
+
+        bool available() const override
+        {
+            const CpuFeatures& cpu = cpuFeatures();
+            return this->kernel == Portable || (this->kernel == AESNI && cpu.aesni && cpu.ssse3) ||
+                   (this->kernel == VAES && cpu.vaes && cpu.avx512f);
+        }
+
+        void setKey(const uint8_t* key, size_t length) override
+        {
+            switch(length)
+            {
+                case 16: this->aes.emplace<AES128>(key); break;
+                case 24: this->aes.emplace<AES192>(key); break;
+                default: this->aes.emplace<AES256>(key); break;
+            }
+        }
+
+        void encrypt(const uint8_t* in, uint8_t* out, size_t blocks) override { run(in, out, blocks, false); }
+        void decrypt(const uint8_t* in, uint8_t* out, size_t blocks) override { run(in, out, blocks, true); }
+
+    private:
+        Kernel kernel;
+        variant<monostate, AES128, AES192, AES256> aes;
+
+        void run(const uint8_t* in, uint8_t* out, size_t blocks, bool decrypt)
+        {
+            visit([&](const auto& fixed)
+            {
+                using Fixed = decay_t<decltype(fixed)>;
+                if constexpr (!is_same_v<Fixed, monostate>)
+                {
+                    size_t done = 0;
+                    if(this->kernel == AESNI)
+                    {
+                        done = decrypt ? aesniDecryptBlocks(fixed.inverseSchedule(), Fixed::Nr, in, out, blocks)
+                                       : aesniEncryptBlocks(fixed.schedule(), Fixed::Nr, in, out, blocks);
+                    }
+                    else if(this->kernel == VAES)
+                    {
+                        done = decrypt ? vaesDecryptBlocks(fixed.inverseSchedule(), Fixed::Nr, in, out, blocks)
+                                       : vaesEncryptBlocks(fixed.schedule(), Fixed::Nr, in, out, blocks);
+                    }
+
+                    for(size_t n = done; n < blocks; n++)
+                    {
+                        if(decrypt)
+                        {
+                            fixed.decryptBlock(in + 16 * n, out + 16 * n);
+                        }
+                        else
+                        {
+                            fixed.encryptBlock(in + 16 * n, out + 16 * n);
+                        }
+                    }
+                }
+            }, this->aes);
+        }
+};
+
+
+// AESEngine with its runtime dispatch, as every mode uses it
+class EngineBackend : public Backend
+{
+    public:
+        string name() const override { return "AESEngine"; }
+        bool accelerated() const override { return cpuFeatures().aesni && cpuFeatures().ssse3; }
+        void setKey(const uint8_t* key, size_t length) override { this->engine.setKey(key, length); }
+        void encrypt(const uint8_t* in, uint8_t* out, size_t blocks) override { this->engine.encryptBlocks(in, out, blocks); }
+        void decrypt(const uint8_t* in, uint8_t* out, size_t blocks) override { this->engine.decryptBlocks(in, out, blocks); }
+
+    private:
+        AESEngine engine;
+};
+
+
+
+
+// -------------------------------------- HARNESS --------------------------------------
+
+struct Throughput
+{
+    double encrypt; // MB/s
+    double decrypt;
+};
+
+
+/* Function: fuzz
+ * Parameters: The backends, the reference, the number of cases, the seed
+ * Return: The number of mismatches
+ * Description: Every case draws a key size, a key and 1 to 64 blocks, encrypts them with the reference, and checks that each
+ *              backend produces the same ciphertext and decrypts it back to the plaintext. The first few mismatches are printed
+ *              with what is needed to replay them.
+*/
+static size_t fuzz(vector<unique_ptr<Backend>>& backends, ReferenceBackend& reference, size_t iterations, uint64_t seed)
+{
+    mt19937_64 random(seed);
+    size_t mismatches = 0;
+
+    for(size_t iteration = 0; iteration < iterations; iteration++)
+    {
+        size_t keyLength = 16 + 8 * (random() % 3);
+        size_t blocks = 1 + random() % 64;
+        uint8_t key[32];
+        vector<uint8_t> plaintext(16 * blocks), expected(16 * blocks), out(16 * blocks), back(16 * blocks);
+        for(uint8_t& byte : key)
+        {
+            byte = static_cast<uint8_t>( random() );
+        }
+        for(uint8_t& byte : plaintext)
+        {
+            byte = static_cast<uint8_t>( random() );
+        }
+
+        reference.setKey(key, keyLength);
+        reference.encrypt(plaintext.data(), expected.data(), blocks);
+
+        for(unique_ptr<Backend>& backend : backends)
+        {
+            backend->setKey(key, keyLength);
+            backend->encrypt(plaintext.data(), out.data(), blocks);
+            backend->decrypt(out.data(), back.data(), blocks);
+
+            if(out != expected || back != plaintext)
+            {
+                if(++mismatches <= 10)
+                {
+                    cout << "MISMATCH: " << backend->name() << ", AES-" << 8 * keyLength << ", " << blocks << " blocks, seed "
+                         << seed << ", case " << iteration << (out != expected ? ", encrypt" : ", decrypt") << endl;
+                }
+            }
+        }
+    }
+    return mismatches;
+}
+
+
+// MB/s of one direction over a 64 KiB buffer (4 KiB for the slow byte-wise paths), run for at least minTime
+static double measure(Backend& backend, bool decrypt, double minTime)
+{
+    size_t blocks = backend.accelerated() ? 4096 : 256;
+    vector<uint8_t> buffer(16 * blocks, 0x5a);
+
+    size_t bytes = 0;
+    auto start = chrono::steady_clock::now();
+    double elapsed = 0.0;
+    do
+    {
+        if(decrypt)
+        {
+            backend.decrypt(buffer.data(), buffer.data(), blocks);
+        }
+        else
+        {
+            backend.encrypt(buffer.data(), buffer.data(), blocks);
+        }
+        bytes += buffer.size();
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+    while(elapsed < minTime);
+
+    return static_cast<double>( bytes ) / elapsed / 1e6;
+}
+
+
+// "name bits encrypt decrypt" per line; names have no spaces
+static map<string, Throughput> loadBaseline(const string& path)
+{
+    map<string, Throughput> baseline;
+    ifstream in(path);
+    if(!in)
+    {
+        throw runtime_error("cannot read baseline " + path);
+    }
+
+    string name;
+    int bits;
+    Throughput rate;
+    while(in >> name >> bits >> rate.encrypt >> rate.decrypt)
+    {
+        baseline[name + "/" + to_string(bits)] = rate;
+    }
+    return baseline;
+}
+
+
+int main(int argc, char** argv)
+{
+    size_t iterations = 2000;
+    uint64_t seed = random_device()();
+    double minTime = 0.1;
+    double minSpeedup = 1.0;
+    double threshold = 0.2;
+    bool enforceSpeed = false;
+    string savePath;
+    string baselinePath;
+
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        auto value = [&](const string& flag) { return arg.substr(flag.length()); };
+
+        try
+        {
+            if(arg.rfind("--iterations=", 0) == 0) iterations = stoul(value("--iterations="));
+            else if(arg.rfind("--seed=", 0) == 0) seed = stoull(value("--seed="));
+            else if(arg.rfind("--min-time=", 0) == 0) minTime = stod(value("--min-time="));
+            else if(arg.rfind("--min-speedup=", 0) == 0) minSpeedup = stod(value("--min-speedup="));
+            else if(arg.rfind("--save=", 0) == 0) savePath = value("--save=");
+            else if(arg.rfind("--baseline=", 0) == 0) baselinePath = value("--baseline=");
+            else if(arg.rfind("--threshold=", 0) == 0) threshold = stod(value("--threshold="));
+            else if(arg == "--enforce-speed") enforceSpeed = true;
+            else
+            {
+                cerr << "unknown option " << arg << endl;
+                return 1;
+            }
+        }
+        catch(const exception&)
+        {
+            cerr << "bad value in " << arg << endl;
+            return 1;
+        }
+    }
+
+    ReferenceBackend reference;
+    vector<unique_ptr<Backend>> candidates;
+    candidates.emplace_back(new ClassBackend());
+    candidates.emplace_back(new FixedBackend(FixedBackend::Portable));
+    candidates.emplace_back(new FixedBackend(FixedBackend::AESNI));
+    candidates.emplace_back(new FixedBackend(FixedBackend::VAES));
+    candidates.emplace_back(new EngineBackend());
+
+    vector<unique_ptr<Backend>> backends;
+    for(unique_ptr<Backend>& backend : candidates)
+    {
+        if(backend->available())
+        {
+            backends.push_back(move(backend));
+        }
+        else
+        {
+            cout << backend->name() << ": skipped, not supported by this CPU or disabled by CRYPTO_DISABLE" << endl;
+        }
+    }
+
+    size_t mismatches = fuzz(backends, reference, iterations, seed);
+    cout << "fuzz: " << iterations << " cases through " << backends.size() << " backends, seed " << seed << ", " << mismatches
+         << " mismatches" << endl << endl;
+
+    map<string, Throughput> baseline;
+    if(!baselinePath.empty())
+    {
+        baseline = loadBaseline(baselinePath);
+    }
+
+    // every backend at every key size, AES::Cipher first as the others are compared to it, and the reference for scale
+    backends.emplace_back(new ReferenceBackend(reference));
+    ofstream save;
+    if(!savePath.empty())
+    {
+        save.open(savePath);
+    }
+
+    size_t regressions = 0;
+    cout << left << setw(14) << "backend" << right << setw(6) << "bits" << setw(14) << "encrypt MB/s" << setw(14) << "decrypt MB/s"
+         << setw(18) << "vs AES::Cipher" << setw(14) << "vs baseline" << endl;
+
+    for(int bits = 128; bits <= 256; bits += 64)
+    {
+        uint8_t key[32] = {};
+        Throughput classRate = {0, 0};
+
+        for(unique_ptr<Backend>& backend : backends)
+        {
+            backend->setKey(key, static_cast<size_t>( bits / 8 ));
+            Throughput rate = {measure(*backend, false, minTime), measure(*backend, true, minTime)};
+            if(backend->name() == "AES::Cipher")
+            {
+                classRate = rate;
+            }
+
+            double speedup = classRate.encrypt > 0 ? min(rate.encrypt / classRate.encrypt, rate.decrypt / classRate.decrypt) : 0.0;
+            string verdict;
+            if(backend->accelerated() && speedup < minSpeedup)
+            {
+                verdict = " SLOWER";
+                regressions++;
+            }
+
+            string against = "-";
+            auto found = baseline.find(backend->name() + "/" + to_string(bits));
+            if(found != baseline.end())
+            {
+                double ratio = min(rate.encrypt / found->second.encrypt, rate.decrypt / found->second.decrypt);
+                ostringstream text;
+                text << fixed << setprecision(2) << ratio << "x";
+                against = text.str();
+                if(ratio < 1.0 - threshold)
+                {
+                    verdict += " REGRESSED";
+                    regressions++;
+                }
+            }
+
+            cout << left << setw(14) << backend->name() << right << setw(6) << dec << bits << fixed << setprecision(1)
+                 << setw(14) << rate.encrypt << setw(14) << rate.decrypt << setw(17) << setprecision(2) << speedup << "x"
+                 << setw(14) << against << verdict << endl;
+            if(save)
+            {
+                save << backend->name() << " " << bits << " " << rate.encrypt << " " << rate.decrypt << endl;
+            }
+        }
+    }
+
+    cout << endl << "throughput: " << (regressions == 0 ? "no regressions" : to_string(regressions) + " regressions")
+         << (enforceSpeed ? "" : " (report only)") << endl;
+    return mismatches == 0 && (regressions == 0 || !enforceSpeed) ? 0 : 1;
+}
@@ -0,0 +1,303 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This program is the training workload for profile guided optimization. It replays a fixed, seeded mix of the
+ *                  traffic the libraries see in production so that the profile weights the same branches and loops:
+ *                    - record encryption: AES counter mode over records of mixed sizes (small control messages, MTU sized
+ *                      packets, full 16 KiB records) with all three key sizes and periodic rekeying, plus decryption of a share,
+ *                      and the portable single block functions
+ *                    - SHA1 digests of 64 B to 1 MiB messages, one-shot and streamed in uneven pieces
+ *                    - HMAC-SHA1 bursts over short messages, as produced by request signing
+ *                    - hex encoding of digests and hex decoding of keys, as produced by logging and configuration
+ *                  Counter mode stands in for AES-GCM here: it drives the same AESEngine::encryptBlocks path for the bulk data.
+ *
+ * Usage:           ./crypto_pgo_train [--scale=<n>]      (n multiplies the amount of work, default 10)
+*/
+
+#include "../Advanced Encryption Standard (AES)/AES.h"
+#include "../Advanced Encryption Standard (AES)/AESEngine.h"
+#include "../Advanced Encryption Standard (AES)/AESFixed.h"
+#include "../Secure Hash Algorithm 1 (SHA1)/SHA1.h"
+#include "../Secure Hash Algorithm 1 (SHA1)/HMACSHA1.h"
+#include "../Common/HexCodec.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+
+static mt19937_64 generator(0x5eed); // fixed seed so every training run replays the same traffic
+
+
+/* Function: recordSize
+ * Parameters: None
+ * Return: A record length in bytes
+ * Description: 60% control messages (16 - 512 B), 30% MTU sized packets (1200 - 1500 B), 10% full 16 KiB records
+*/
+static size_t recordSize()
+{
+    uint64_t kind = generator() % 10;
+    if(kind < 6)
+    {
+        return 16 + generator() % 497;
+    }
+    if(kind < 9)
+    {
+        return 1200 + generator() % 301;
+    }
+    return 16384;
+}
+
+
+/* Function: ctrCrypt
+ * Parameters: The engine, a 16 byte initial counter block, the record, its length
+ * Return: None
+ * Description: Counter mode with a 32-bit big-endian block counter. The keystream is produced in batches of 32 blocks so the
+ *              multi-block kernels see realistic batch sizes.
+*/
+static void ctrCrypt(const AESEngine& engine, const uint8_t* iv, uint8_t* data, size_t length)
+{
+    uint8_t counters[32 * 16];
+    uint8_t keystream[32 * 16];
+    uint32_t counter = 1;
+
+    for(size_t offset = 0; offset < length; offset += sizeof(keystream))
+    {
+        size_t chunk = min(sizeof(keystream), length - offset);
+        size_t blocks = (chunk + 15) / 16;
+
+        for(size_t b = 0; b < blocks; b++)
+        {
+            memcpy(counters + 16 * b, iv, 12);
+            counters[16 * b + 12] = static_cast<uint8_t>( counter >> 24 );
+            counters[16 * b + 13] = static_cast<uint8_t>( counter >> 16 );
+            counters[16 * b + 14] = static_cast<uint8_t>( counter >> 8 );
+            counters[16 * b + 15] = static_cast<uint8_t>( counter );
+            counter++;
+        }
+
+        engine.encryptBlocks(counters, keystream, blocks);
+        for(size_t i = 0; i < chunk; i++)
+        {
+            data[offset + i] ^= keystream[i];
+        }
+    }
+}
+
+
+static void fill(uint8_t* data, size_t length)
+{
+    for(size_t i = 0; i < length; i++)
+    {
+        data[i] = static_cast<uint8_t>( generator() );
+    }
+}
+
+
+
+
+static uint64_t trainRecords(int scale)
+{
+    uint64_t bytes = 0;
+    vector<uint8_t> record(16384);
+    uint8_t key[32];
+    uint8_t iv[16];
+
+    for(int session = 0; session < 60 * scale; session++)
+    {
+        // a new session key every 200 records; key sizes weighted towards AES-128 and AES-256
+        size_t keyLength = (session % 4 == 1) ? 24 : (session % 2 == 0 ? 16 : 32);
+        fill(key, keyLength);
+        AESEngine engine(key, keyLength);
+
+        for(int r = 0; r < 200; r++)
+        {
+            size_t length = recordSize();
+            fill(iv, sizeof(iv));
+            fill(record.data(), min<size_t>(length, 64));
+
+            ctrCrypt(engine, iv, record.data(), length);
+            bytes += length;
+
+            // one record in four arrives padded to whole blocks and is decrypted block by block
+            if(r % 4 == 0)
+            {
+                engine.decryptBlocks(record.data(), record.data(), length / 16);
+                bytes += length & ~static_cast<size_t>( 15 );
+            }
+        }
+    }
+
+    // the portable block functions, which are what AESEngine runs on machines without AES-NI
+    AES128 aes128(key);
+    AES192 aes192(key);
+    AES256 aes256(key);
+    for(int i = 0; i < 2000 * scale; i++)
+    {
+        uint8_t* block = record.data() + 16 * (i % 64);
+        aes128.encryptBlock(block, block);
+        aes192.encryptBlock(block, block);
+        aes256.encryptBlock(block, block);
+        aes256.decryptBlock(block, block);
+        aes192.decryptBlock(block, block);
+        aes128.decryptBlock(block, block);
+        bytes += 96;
+    }
+
+    // a small share through the AES class byte interface
+    AES aes(key, 16);
+    for(int i = 0; i < 200 * scale; i++)
+    {
+        aes.Cipher(record.data(), record.data(), 4);
+        aes.Decipher(record.data(), record.data(), 4);
+        bytes += 128;
+    }
+
+    return bytes;
+}
+
+
+static uint64_t trainDigests(int scale)
+{
+    uint64_t bytes = 0;
+    vector<uint8_t> message(1 << 20);
+    fill(message.data(), message.size());
+
+    SHA1 sha1;
+    uint8_t digest[SHA1::DigestSize];
+    char hex[2 * SHA1::DigestSize];
+
+    for(int i = 0; i < 400 * scale; i++)
+    {
+        // sizes spread log-uniformly from 64 B to 1 MiB
+        size_t length = static_cast<size_t>( 64 ) << (generator() % 15);
+        length += generator() % length;
+        length = min(length, message.size());
+
+        if(i % 3 == 0)
+        {
+            // streamed in uneven pieces, as a network reader would deliver them
+            sha1.reset();
+            size_t offset = 0;
+            while(offset < length)
+            {
+                size_t piece = min<size_t>(1 + generator() % 9000, length - offset);
+                sha1.update(message.data() + offset, piece);
+                offset += piece;
+            }
+            sha1.finalize(digest);
+        }
+        else
+        {
+            sha1.digest(message.data(), length, digest);
+        }
+
+        hexEncode(digest, sizeof(digest), hex);
+        bytes += length;
+    }
+
+    // the hex string interface used by older callers
+    for(int i = 0; i < 500 * scale; i++)
+    {
+        bytes += 64;
+        sha1.digest(string(reinterpret_cast<const char*>(message.data()) + (i % 1000), 64));
+    }
+
+    return bytes;
+}
+
+
+static uint64_t trainHmac(int scale)
+{
+    uint64_t bytes = 0;
+    uint8_t key[20];
+    uint8_t message[256];
+    uint8_t mac[SHA1::DigestSize];
+
+    for(int burst = 0; burst < 100 * scale; burst++)
+    {
+        fill(key, sizeof(key));
+        HMACSHA1 hmac(key, sizeof(key));
+
+        // bursts of 200 signatures over 32 - 256 byte requests with one key
+        for(int i = 0; i < 200; i++)
+        {
+            size_t length = 32 + generator() % 225;
+            fill(message, 16);
+            hmac.mac(message, length, mac);
+            bytes += length;
+        }
+    }
+
+    return bytes;
+}
+
+
+static uint64_t trainHex(int scale)
+{
+    uint64_t bytes = 0;
+    uint8_t raw[4096];
+    char hex[8192];
+    fill(raw, sizeof(raw));
+
+    for(int i = 0; i < 2000 * scale; i++)
+    {
+        size_t length = 16 + generator() % 1024;
+        hexEncode(raw, length, hex);
+        hexDecode(hex, 2 * length, raw);
+        bytes += length;
+    }
+
+    return bytes;
+}
+
+
+
+
+int main(int argc, char** argv)
+{
+    int scale = 10;
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if(arg.rfind("--scale=", 0) == 0)
+        {
+            scale = max(1, stoi(arg.substr(8)));
+        }
+        else
+        {
+            cerr << "usage: " << argv[0] << " [--scale=<n>]" << endl;
+            return 1;
+        }
+    }
+
+    struct Phase
+    {
+        const char* name;
+        uint64_t (*run)(int);
+    };
+    const Phase phases[] =
+    {
+        {"AES records", trainRecords},
+        {"SHA1 digests", trainDigests},
+        {"HMAC-SHA1 bursts", trainHmac},
+        {"hex codec", trainHex},
+    };
+
+    for(const Phase& phase : phases)
+    {
+        auto start = chrono::steady_clock::now();
+        uint64_t bytes = phase.run(scale);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cout << phase.name << ": " << bytes << " bytes in " << seconds << " s (" << (bytes / 1e6) / seconds << " MB/s)" << endl;
+    }
+
+    return 0;
+}
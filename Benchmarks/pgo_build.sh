@@ -0,0 +1,48 @@
+#!/bin/sh
+# Builds the libraries with profile guided optimization and compares them with a plain release build.
+#
+#   1. instrumented build   (CRYPTO_PGO=GENERATE)
+#   2. training             (crypto_pgo_train writes .gcda profiles to <build>/pgo-profiles)
+#   3. optimized build      (CRYPTO_PGO=USE, same build directory so the profile names match the objects)
+#   4. report               (crypto_bench on both builds, compared by pgo_report.py)
+#
+# Usage: Benchmarks/pgo_build.sh [build root, default build-pgo] [extra cmake arguments...]
+
+set -e
+
+SOURCE_DIR=$(cd "$(dirname "$0")/.." && pwd)
+ROOT=${1:-build-pgo}
+[ $# -gt 0 ] && shift
+
+BASELINE="$ROOT/baseline"
+PGO="$ROOT/pgo"
+PROFILES="$PWD/$PGO/pgo-profiles"
+BENCH_FILTER=${BENCH_FILTER:-'^BM_(AES_Cipher|AESFixed|AESEngine|SHA1_processBlock|SHA1_digest/(16|64|1024|16384|262144|1048576)$)'}
+BENCH_MIN_TIME=${BENCH_MIN_TIME:-0.2}
+
+echo "== baseline build"
+cmake -S "$SOURCE_DIR" -B "$BASELINE" -DCMAKE_BUILD_TYPE=Release -DCRYPTO_PGO=OFF "$@"
+cmake --build "$BASELINE" -j
+
+echo "== instrumented build"
+rm -rf "$PROFILES"
+cmake -S "$SOURCE_DIR" -B "$PGO" -DCMAKE_BUILD_TYPE=Release -DCRYPTO_PGO=GENERATE -DCRYPTO_PGO_DIR="$PROFILES" "$@"
+cmake --build "$PGO" -j
+
+echo "== training"
+"$PGO/Benchmarks/crypto_pgo_train" --scale="${TRAIN_SCALE:-10}"
+# a short pass of the benchmark suite as well: AESFixed is header only, so the benchmark translation unit carries its own
+# instantiations, and without a profile of its own GCC compiles them as never executed
+"$PGO/Benchmarks/crypto_bench" --benchmark_filter="$BENCH_FILTER" --benchmark_min_time=0.001 > /dev/null
+
+echo "== optimized build"
+cmake -S "$SOURCE_DIR" -B "$PGO" -DCRYPTO_PGO=USE
+cmake --build "$PGO" -j --clean-first
+
+echo "== benchmarks"
+"$BASELINE/Benchmarks/crypto_bench" --benchmark_filter="$BENCH_FILTER" --benchmark_min_time="$BENCH_MIN_TIME" \
+    --benchmark_format=json --benchmark_out="$ROOT/baseline.json" > /dev/null
+"$PGO/Benchmarks/crypto_bench" --benchmark_filter="$BENCH_FILTER" --benchmark_min_time="$BENCH_MIN_TIME" \
+    --benchmark_format=json --benchmark_out="$ROOT/pgo.json" > /dev/null
+
+python3 "$SOURCE_DIR/Benchmarks/pgo_report.py" "$ROOT/baseline.json" "$ROOT/pgo.json" | tee "$ROOT/pgo_report.md"
@@ -0,0 +1,67 @@
+# Compares two crypto_bench JSON result files (for example a plain release build and a PGO build) and prints a markdown table
+# of throughput for every benchmark present in both, with the relative change.
+#
+# Usage: python3 pgo_report.py baseline.json pgo.json [--threshold=<percent>]
+#        exits with status 1 if any benchmark is slower than the baseline by more than the threshold (default: never fails)
+
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        return {b["name"]: b for b in json.load(f)["benchmarks"]}
+
+
+def rate(benchmark):
+    # throughput in MB/s where the benchmark counts bytes, otherwise operations per microsecond
+    if benchmark.get("bytes_per_second"):
+        return benchmark["bytes_per_second"] / 1e6, "MB/s"
+    return 1e3 / benchmark["real_time"], "op/us"
+
+
+def main(argv):
+    paths = [a for a in argv[1:] if not a.startswith("--")]
+    threshold = None
+    for a in argv[1:]:
+        if a.startswith("--threshold="):
+            threshold = float(a.split("=", 1)[1])
+
+    if len(paths) != 2:
+        print(__doc__ or "usage: pgo_report.py baseline.json pgo.json [--threshold=<percent>]")
+        return 2
+
+    baseline = load(paths[0])
+    candidate = load(paths[1])
+
+    print("| Benchmark | Baseline | PGO | Change |")
+    print("|---|---:|---:|---:|")
+
+    changes = []
+    for name, base in baseline.items():
+        if name not in candidate:
+            continue
+        before, unit = rate(base)
+        after, _ = rate(candidate[name])
+        change = (after / before - 1.0) * 100.0 if before else 0.0
+        changes.append((name, change))
+        print("| %s | %.1f %s | %.1f %s | %+.1f%% |" % (name, before, unit, after, unit, change))
+
+    if changes:
+        geomean = 1.0
+        for _, change in changes:
+            geomean *= 1.0 + change / 100.0
+        geomean = geomean ** (1.0 / len(changes))
+        print()
+        print("Geometric mean change over %d benchmarks: %+.1f%%" % (len(changes), (geomean - 1.0) * 100.0))
+
+    if threshold is not None:
+        regressions = [(n, c) for n, c in changes if c < -threshold]
+        for name, change in regressions:
+            print("REGRESSION: %s %+.1f%%" % (name, change), file=sys.stderr)
+        return 1 if regressions else 0
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,172 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the CAVPFile method definitions: the mapping and the record parser.
+*/
+
+#include "CAVPFile.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+string_view CAVPRecord::field(string_view name) const
+{
+    for(const pair<string_view, string_view>& entry : this->fields)
+    {
+        if(entry.first == name)
+        {
+            return entry.second;
+        }
+    }
+    return string_view();
+}
+
+
+bool CAVPRecord::has(string_view name) const
+{
+    for(const pair<string_view, string_view>& entry : this->fields)
+    {
+        if(entry.first == name)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+
+// -------------------------------------- MAPPING --------------------------------------
+
+CAVPFile::CAVPFile(const string& path) : filePath(path), data(nullptr), size(0)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat status;
+    if(fd < 0 || fstat(fd, &status) != 0)
+    {
+        string error = strerror(errno);
+        if(fd >= 0)
+        {
+            close(fd);
+        }
+        throw runtime_error("cannot open " + path + ": " + error);
+    }
+
+    this->size = static_cast<size_t>( status.st_size );
+    if(this->size > 0)
+    {
+        void* mapping = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(mapping == MAP_FAILED)
+        {
+            string error = strerror(errno);
+            close(fd);
+            throw runtime_error("cannot map " + path + ": " + error);
+        }
+        madvise(mapping, this->size, MADV_SEQUENTIAL); // read once, front to back
+        this->data = static_cast<const char*>( mapping );
+    }
+    close(fd); // the mapping keeps the file
+
+    parse();
+}
+
+
+CAVPFile::~CAVPFile()
+{
+    if(this->data != nullptr)
+    {
+        munmap(const_cast<char*>( this->data ), this->size);
+    }
+}
+
+
+string CAVPFile::name() const
+{
+    size_t slash = this->filePath.find_last_of('/');
+    return slash == string::npos ? this->filePath : this->filePath.substr(slash + 1);
+}
+
+
+
+
+// -------------------------------------- PARSER --------------------------------------
+
+static string_view trim(string_view text)
+{
+    size_t begin = 0;
+    size_t end = text.size();
+    while(begin < end && (text[begin] == ' ' || text[begin] == '\t'))
+    {
+        begin++;
+    }
+    while(end > begin && (text[end - 1] == ' ' || text[end - 1] == '\t' || text[end - 1] == '\r'))
+    {
+        end--;
+    }
+    return text.substr(begin, end - begin);
+}
+
+
+/* Function: parse
+ * Parameters: None
+ * Return: None
+ * Description: One pass over the mapping, a line at a time. A field line adds to the open record, or opens one; a blank line,
+ *              a comment or a section header closes it. Lines that are none of these (CAVP has none) are ignored.
+*/
+void CAVPFile::parse()
+{
+    string_view text(this->data, this->size);
+    string_view section;
+    bool open = false;
+    size_t lineNumber = 0;
+
+    size_t position = 0;
+    while(position < text.size())
+    {
+        size_t newline = text.find('\n', position);
+        if(newline == string_view::npos)
+        {
+            newline = text.size();
+        }
+        string_view line = trim(text.substr(position, newline - position));
+        position = newline + 1;
+        lineNumber++;
+
+        if(line.empty() || line[0] == '#')
+        {
+            open = false;
+            continue;
+        }
+
+        if(line[0] == '[')
+        {
+            size_t close = line.find(']');
+            section = trim(line.substr(1, (close == string_view::npos ? line.size() : close) - 1));
+            open = false;
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if(equals == string_view::npos)
+        {
+            continue;
+        }
+
+        if(!open)
+        {
+            this->parsed.push_back(CAVPRecord{section, lineNumber, {}});
+            open = true;
+        }
+        this->parsed.back().fields.emplace_back(trim(line.substr(0, equals)), trim(line.substr(equals + 1)));
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains CAVPFile, the loader of the NIST CAVP response (.rsp) files. The file is memory mapped and
+ *                  parsed once into records without copying: every name and value is a string_view into the mapping, which
+ *                  lives as long as the CAVPFile. The format is line based, with LF or CRLF endings:
+ *
+ *                      # comment
+ *                      [ENCRYPT]                   section header, kept with every record below it ("L = 20" for SHA)
+ *                                                  blank lines end a record
+ *                      COUNT = 0                   NAME = VALUE, one field per line
+ *                      KEY = 00000000000000000000000000000000
+ *
+ *                  Nothing about the algorithm is interpreted here; CAVPValidation.h decides what the fields mean.
+*/
+
+#ifndef CAVP_FILE_H
+#define CAVP_FILE_H
+
+#include <stddef.h>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+struct CAVPRecord
+{
+    string_view section; // the last [header] above the record, without the brackets; empty before the first one
+    size_t line; // 1 based line number of the first field
+    vector<pair<string_view, string_view>> fields; // in file order
+
+    string_view field(string_view name) const; // the value of name, empty if the record has no such field
+    bool has(string_view name) const;
+};
+
+class CAVPFile
+{
+    public:
+        explicit CAVPFile(const string&); // maps and parses the file; throws runtime_error when it cannot be read
+        CAVPFile(const CAVPFile&) = delete;
+        CAVPFile& operator=(const CAVPFile&) = delete;
+        ~CAVPFile();
+
+        const string& path() const { return this->filePath; }
+        string name() const; // the file name without its directory, which names the test
+        const vector<CAVPRecord>& records() const { return this->parsed; }
+
+    private:
+        string filePath;
+        const char* data;
+        size_t size;
+        vector<CAVPRecord> parsed;
+
+        void parse();
+};
+
+#endif
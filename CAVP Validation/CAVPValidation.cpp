@@ -0,0 +1,424 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the CAVP runner: the classification of the files, the record checks and the parallel loop
+ *                  over the record groups of every file.
+*/
+
+#include "CAVPValidation.h"
+#include "../Advanced Encryption Standard (AES)/AESEngine.h"
+#include "../Advanced Encryption Standard (AES)/AESModes.h"
+#include "../Secure Hash Algorithm 1 (SHA1)/SHA1.h"
+#include "../Common/HexCodec.h"
+#include "../Common/Parallel.h"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+
+static const size_t GroupRecords = 16; // records per parallelFor item, and per SHA1::digestMany call
+static const size_t MaxFailures = 20; // failures kept for the report; all of them are counted
+static const int MonteCarloRounds = 1000; // inner iterations of AESAVS 6.4 and SHAVS 6.4
+
+
+enum class CAVPTest { AESECB, AESCBC, AESCTR, SHA1Message, SHA1Monte, Unsupported };
+
+enum Verdict { Pass, Fail, Skip, NotACase };
+
+struct Classification
+{
+    CAVPTest test;
+    bool monteCarlo;
+    string description;
+};
+
+
+static Classification classify(const string& name)
+{
+    auto startsWith = [&](const char* prefix) { return name.rfind(prefix, 0) == 0; };
+    bool mct = name.find("MCT") != string::npos;
+
+    if(startsWith("ECB")) return {CAVPTest::AESECB, mct, mct ? "AES-ECB MCT" : "AES-ECB KAT"};
+    if(startsWith("CBC")) return {CAVPTest::AESCBC, mct, mct ? "AES-CBC MCT" : "AES-CBC KAT"};
+    if(startsWith("CTR") && !mct) return {CAVPTest::AESCTR, false, "AES-CTR KAT"};
+    if(startsWith("SHA1Monte")) return {CAVPTest::SHA1Monte, true, "SHA-1 Monte"};
+    if(startsWith("SHA1ShortMsg") || startsWith("SHA1LongMsg")) return {CAVPTest::SHA1Message, false, "SHA-1 messages"};
+    if(startsWith("gcm")) return {CAVPTest::Unsupported, false, "skipped, no AES-GCM here"};
+    return {CAVPTest::Unsupported, false, "skipped, unknown test"};
+}
+
+
+static bool decode(string_view hex, vector<uint8_t>& out)
+{
+    out.resize(hex.size() / 2);
+    return hexDecode(hex.data(), hex.size(), out.data());
+}
+
+
+static string locate(const CAVPFile& file, const CAVPRecord& record)
+{
+    string where = file.name() + " line " + to_string(record.line);
+    if(record.has("COUNT"))
+    {
+        where += ", COUNT = " + string(record.field("COUNT"));
+    }
+    if(!record.section.empty())
+    {
+        where += " [" + string(record.section) + "]";
+    }
+    return where;
+}
+
+
+
+
+// -------------------------------------- AES --------------------------------------
+
+/* Function: monteCarlo
+ * Parameters: The keyed engine, CBC or ECB, the direction, the IV (CBC only), the 16 byte input, the 16 byte output
+ * Return: None
+ * Description: The inner loop of the AESAVS 6.4 Monte Carlo test: 1000 chained block operations of which the last output is
+ *              checked. In ECB each output is the next input. In CBC the second input is the IV and each later input is the
+ *              output before last, while the chaining value runs as in ordinary CBC.
+*/
+static void monteCarlo(const AESEngine& engine, bool cbc, bool decrypt, const uint8_t* iv, const uint8_t* input, uint8_t* output)
+{
+    uint8_t x[16], y[16], chain[16], previous[16];
+    memcpy(x, input, 16);
+    if(cbc)
+    {
+        memcpy(chain, iv, 16);
+    }
+
+    for(int j = 0; j < MonteCarloRounds; j++)
+    {
+        if(!cbc)
+        {
+            decrypt ? engine.decryptBlock(x, y) : engine.encryptBlock(x, y);
+            memcpy(x, y, 16);
+            continue;
+        }
+
+        if(decrypt)
+        {
+            engine.decryptBlock(x, y);
+            for(int i = 0; i < 16; i++)
+            {
+                y[i] ^= chain[i];
+            }
+            memcpy(chain, x, 16);
+        }
+        else
+        {
+            for(int i = 0; i < 16; i++)
+            {
+                x[i] ^= chain[i];
+            }
+            engine.encryptBlock(x, y);
+            memcpy(chain, y, 16);
+        }
+        memcpy(x, j == 0 ? iv : previous, 16);
+        memcpy(previous, y, 16);
+    }
+    memcpy(output, y, 16);
+}
+
+
+// one record of an ECB, CBC or CTR file: KEY, IV outside ECB, and PLAINTEXT and CIPHERTEXT in the order of the section
+static Verdict checkAES(const Classification& kind, const CAVPRecord& record, AESEngine& engine, string& detail)
+{
+    if(!record.has("COUNT"))
+    {
+        return NotACase;
+    }
+
+    bool decrypt = record.section == "DECRYPT";
+    bool needsIv = kind.test != CAVPTest::AESECB;
+    vector<uint8_t> key, iv, input, expected;
+    if(!decode(record.field("KEY"), key) || (needsIv && !decode(record.field("IV"), iv)) ||
+       !decode(record.field(decrypt ? "CIPHERTEXT" : "PLAINTEXT"), input) ||
+       !decode(record.field(decrypt ? "PLAINTEXT" : "CIPHERTEXT"), expected))
+    {
+        detail = "malformed hex";
+        return Fail;
+    }
+
+    bool wholeBlocks = input.size() % 16 == 0 || kind.test == CAVPTest::AESCTR;
+    if((key.size() != 16 && key.size() != 24 && key.size() != 32) || (needsIv && iv.size() != 16) || input.empty() ||
+       !wholeBlocks || expected.size() != input.size() || (kind.monteCarlo && input.size() != 16))
+    {
+        detail = "malformed record";
+        return Fail;
+    }
+
+    engine.setKey(key.data(), key.size());
+    vector<uint8_t> output(input.size());
+    size_t blocks = input.size() / 16;
+
+    if(kind.monteCarlo)
+    {
+        monteCarlo(engine, kind.test == CAVPTest::AESCBC, decrypt, iv.data(), input.data(), output.data());
+    }
+    else if(kind.test == CAVPTest::AESCTR)
+    {
+        aesCtrCrypt(engine, iv.data(), input.data(), output.data(), input.size(), 1);
+    }
+    else if(kind.test == CAVPTest::AESECB || decrypt)
+    {
+        decrypt ? engine.decryptBlocks(input.data(), output.data(), blocks) : engine.encryptBlocks(input.data(), output.data(), blocks);
+
+        // CBC decryption is ECB decryption of every block, then the previous ciphertext block (the IV for the first) xored in
+        for(size_t i = 0; kind.test == CAVPTest::AESCBC && i < input.size(); i++)
+        {
+            output[i] ^= i < 16 ? iv[i] : input[i - 16];
+        }
+    }
+    else
+    {
+        const uint8_t* chain = iv.data();
+        for(size_t block = 0; block < blocks; block++)
+        {
+            uint8_t x[16];
+            for(int i = 0; i < 16; i++)
+            {
+                x[i] = input[16 * block + i] ^ chain[i];
+            }
+            engine.encryptBlock(x, &output[16 * block]);
+            chain = &output[16 * block];
+        }
+    }
+
+    if(output != expected)
+    {
+        detail = "expected " + hexEncode(expected.data(), expected.size()) + ", got " + hexEncode(output.data(), output.size());
+        return Fail;
+    }
+    return Pass;
+}
+
+
+
+
+// -------------------------------------- SHA-1 --------------------------------------
+
+// the SHAVS 6.4 Monte Carlo test: the seed of COUNT 0 is the Seed record, the seed of each later COUNT the MD of the one before
+static Verdict checkSHA1Monte(const vector<CAVPRecord>& records, size_t index, string& detail)
+{
+    const CAVPRecord& record = records[index];
+    if(!record.has("COUNT"))
+    {
+        return NotACase;
+    }
+
+    vector<uint8_t> seed, expected;
+    string_view seedHex = index == 0 ? string_view() : records[index - 1].has("MD") ? records[index - 1].field("MD")
+                                                                                     : records[index - 1].field("Seed");
+    if(!decode(seedHex, seed) || !decode(record.field("MD"), expected) || seed.size() != SHA1::DigestSize ||
+       expected.size() != SHA1::DigestSize)
+    {
+        detail = "malformed record or no seed before it";
+        return Fail;
+    }
+
+    // M[i] = MD[i-3] || MD[i-2] || MD[i-1], kept as one 60 byte window that shifts by a digest each step
+    SHA1 sha1;
+    uint8_t window[3 * SHA1::DigestSize];
+    uint8_t digest[SHA1::DigestSize];
+    for(int i = 0; i < 3; i++)
+    {
+        memcpy(window + i * SHA1::DigestSize, seed.data(), SHA1::DigestSize);
+    }
+    for(int i = 0; i < MonteCarloRounds; i++)
+    {
+        sha1.digest(window, sizeof(window), digest);
+        memmove(window, window + SHA1::DigestSize, 2 * SHA1::DigestSize);
+        memcpy(window + 2 * SHA1::DigestSize, digest, SHA1::DigestSize);
+    }
+
+    if(memcmp(digest, expected.data(), SHA1::DigestSize) != 0)
+    {
+        detail = "expected " + hexEncode(expected.data(), expected.size()) + ", got " + hexEncode(digest, sizeof(digest));
+        return Fail;
+    }
+    return Pass;
+}
+
+
+
+
+// -------------------------------------- RUNNER --------------------------------------
+
+struct FileTally
+{
+    Classification kind;
+    atomic<size_t> passed{0};
+    atomic<size_t> failed{0};
+    atomic<size_t> skipped{0};
+};
+
+
+struct RecordGroup
+{
+    size_t file;
+    size_t begin;
+    size_t end;
+};
+
+
+/* Function: runGroup
+ * Parameters: The file, its classification, the record range, the verdict of each record in the range
+ * Return: None
+ * Description: Checks one group of records. The message digests of a group are computed in a single SHA1::digestMany call,
+ *              so the AVX2 lanes fill up; everything else is checked one record at a time with one engine rekeyed in place.
+*/
+static void runGroup(const CAVPFile& file, const Classification& kind, size_t begin, size_t end, Verdict* verdicts, string* details)
+{
+    const vector<CAVPRecord>& records = file.records();
+
+    if(kind.test == CAVPTest::SHA1Message)
+    {
+        vector<vector<uint8_t>> messages(end - begin), expected(end - begin);
+        vector<const uint8_t*> pointers;
+        vector<size_t> lengths;
+        vector<size_t> owners;
+
+        for(size_t i = begin; i < end; i++)
+        {
+            const CAVPRecord& record = records[i];
+            Verdict& verdict = verdicts[i - begin];
+            unsigned long bits = 0;
+            if(!record.has("Len"))
+            {
+                verdict = NotACase;
+                continue;
+            }
+            try
+            {
+                bits = stoul(string(record.field("Len")));
+            }
+            catch(const exception&)
+            {
+                verdict = Fail;
+                details[i - begin] = "malformed Len";
+                continue;
+            }
+            if(bits % 8 != 0)
+            {
+                verdict = Skip;
+                continue;
+            }
+
+            vector<uint8_t>& message = messages[i - begin];
+            if(!decode(record.field("Msg"), message) || !decode(record.field("MD"), expected[i - begin]) ||
+               message.size() < bits / 8 || expected[i - begin].size() != SHA1::DigestSize)
+            {
+                verdict = Fail;
+                details[i - begin] = "malformed record";
+                continue;
+            }
+            message.resize(bits / 8); // a zero length message is written as Msg = 00
+
+            pointers.push_back(message.data());
+            lengths.push_back(message.size());
+            owners.push_back(i - begin);
+        }
+
+        vector<uint8_t> digests(pointers.size() * SHA1::DigestSize);
+        SHA1::digestMany(pointers.data(), lengths.data(), pointers.size(), digests.data());
+
+        for(size_t n = 0; n < owners.size(); n++)
+        {
+            const uint8_t* digest = &digests[n * SHA1::DigestSize];
+            const vector<uint8_t>& want = expected[owners[n]];
+            bool match = memcmp(digest, want.data(), SHA1::DigestSize) == 0;
+            verdicts[owners[n]] = match ? Pass : Fail;
+            if(!match)
+            {
+                details[owners[n]] = "expected " + hexEncode(want.data(), want.size()) + ", got " + hexEncode(digest, SHA1::DigestSize);
+            }
+        }
+        return;
+    }
+
+    AESEngine engine;
+    for(size_t i = begin; i < end; i++)
+    {
+        switch(kind.test)
+        {
+            case CAVPTest::SHA1Monte: verdicts[i - begin] = checkSHA1Monte(records, i, details[i - begin]); break;
+            case CAVPTest::Unsupported: verdicts[i - begin] = Skip; break;
+            default: verdicts[i - begin] = checkAES(kind, records[i], engine, details[i - begin]); break;
+        }
+    }
+    engine.clear();
+}
+
+
+/* Function: runCAVP
+ * Parameters: The loaded files, the number of threads
+ * Return: The per file and total counts and the first failures
+ * Description: Cuts every file into groups of GroupRecords records and runs all the groups of all the files in one parallelFor.
+ *              The counts are tallied per file with atomics; the failure messages are kept under a mutex, as there are few.
+*/
+CAVPReport runCAVP(const vector<unique_ptr<CAVPFile>>& files, unsigned threads)
+{
+    vector<FileTally> tallies(files.size());
+    vector<RecordGroup> groups;
+    for(size_t f = 0; f < files.size(); f++)
+    {
+        tallies[f].kind = classify(files[f]->name());
+        size_t count = files[f]->records().size();
+        for(size_t begin = 0; begin < count; begin += GroupRecords)
+        {
+            groups.push_back({f, begin, min(begin + GroupRecords, count)});
+        }
+    }
+
+    CAVPReport report{{}, {}, 0, 0, 0};
+    mutex failuresMutex;
+
+    parallelFor(groups.size(), threads, [&](size_t g)
+    {
+        const RecordGroup& group = groups[g];
+        const CAVPFile& file = *files[group.file];
+        FileTally& tally = tallies[group.file];
+
+        Verdict verdicts[GroupRecords];
+        string details[GroupRecords];
+        runGroup(file, tally.kind, group.begin, group.end, verdicts, details);
+
+        for(size_t i = 0; i < group.end - group.begin; i++)
+        {
+            switch(verdicts[i])
+            {
+                case Pass: tally.passed.fetch_add(1, memory_order_relaxed); break;
+                case Skip: tally.skipped.fetch_add(1, memory_order_relaxed); break;
+                case NotACase: break;
+                case Fail:
+                {
+                    tally.failed.fetch_add(1, memory_order_relaxed);
+                    lock_guard<mutex> lock(failuresMutex);
+                    if(report.failures.size() < MaxFailures)
+                    {
+                        report.failures.push_back(locate(file, file.records()[group.begin + i]) + ": " + details[i]);
+                    }
+                    break;
+                }
+            }
+        }
+    });
+
+    for(size_t f = 0; f < files.size(); f++)
+    {
+        CAVPFileResult result{files[f]->name(), tallies[f].kind.description, tallies[f].passed.load(), tallies[f].failed.load(),
+                              tallies[f].skipped.load()};
+        report.passed += result.passed;
+        report.failed += result.failed;
+        report.skipped += result.skipped;
+        report.files.push_back(result);
+    }
+    return report;
+}
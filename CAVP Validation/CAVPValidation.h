@@ -0,0 +1,52 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the bulk runner of the CAVP response files. The test a file holds is told by its name, as
+ *                  NIST names them:
+ *
+ *                    - ECB*, CBC*, CTR*:           AES known answer (GFSbox, KeySbox, VarKey, VarTxt) and multi-block message
+ *                                                  tests, and the Monte Carlo tests of AESAVS 6.4 when the name has MCT in it.
+ *                                                  CTR files carry the initial counter block as IV, as in SP 800-38A F.5.
+ *                    - SHA1ShortMsg*, SHA1LongMsg*: SHA-1 message digests; bit oriented lengths are skipped.
+ *                    - SHA1Monte*:                 the SHA-1 Monte Carlo test of SHAVS 6.4.
+ *
+ *                  Anything else, gcm* included since there is no AES-GCM here, is reported and skipped. The records of every
+ *                  file are cut into groups and the groups of all files run in one parallelFor, so the small files do not wait
+ *                  on the large ones. Within a group the work goes through the batch interfaces: AESEngine::encryptBlocks over a
+ *                  whole message, aesCtrCrypt, and SHA1::digestMany over every message of the group at once. A Monte Carlo
+ *                  record depends only on the inputs the file gives it, so its records run in parallel too.
+*/
+
+#ifndef CAVP_VALIDATION_H
+#define CAVP_VALIDATION_H
+
+#include "CAVPFile.h"
+
+#include <memory>
+
+using namespace std;
+
+struct CAVPFileResult
+{
+    string name;
+    string test; // e.g. "AES-ECB KAT", "SHA-1 Monte", or why the file was skipped
+    size_t passed;
+    size_t failed;
+    size_t skipped;
+};
+
+struct CAVPReport
+{
+    vector<CAVPFileResult> files; // in the order given
+    vector<string> failures; // the first few, with file, line and COUNT
+    size_t passed;
+    size_t failed;
+    size_t skipped;
+};
+
+// Checks every record of every file on up to threads threads (0 = one per pool worker)
+CAVPReport runCAVP(const vector<unique_ptr<CAVPFile>>&, unsigned threads = 0);
+
+#endif
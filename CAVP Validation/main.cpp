@@ -0,0 +1,112 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This program runs NIST CAVP response files against the AES and SHA-1 implementations: the AESAVS ECB, CBC
+ *                  and CTR known answer and Monte Carlo files and the SHAVS ShortMsg, LongMsg and Monte files. A directory
+ *                  argument stands for every .rsp file in it. Each file gets one line of counts, then the first failures and
+ *                  the totals with the time taken from mapping the first file to checking the last record are printed.
+ *                  The exit status is 1 when a vector fails or none passes.
+ *
+ *                  The vectors directory next to this file holds the first vectors of several NIST files and the SP 800-38A
+ *                  examples in the same format, for the tests; the full suites come from the CAVP pages at csrc.nist.gov.
+ *
+ * Compilation:     cmake -S . -B build && cmake --build build --target crypto_cavp        (from the repository root)
+ *
+ * Usage:           ./crypto_cavp [--threads=<n>] <file.rsp | directory>...
+*/
+
+#include "CAVPValidation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+int main(int argc, char** argv)
+{
+    unsigned threads = 0;
+    vector<string> paths;
+
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        auto value = [&](const string& flag) { return arg.substr(flag.length()); };
+
+        try
+        {
+            if(arg.rfind("--threads=", 0) == 0) threads = static_cast<unsigned>( stoul(value("--threads=")) );
+            else if(arg.rfind("--", 0) == 0)
+            {
+                cerr << "unknown option " << arg << endl;
+                return 1;
+            }
+            else paths.push_back(arg);
+        }
+        catch(const exception&)
+        {
+            cerr << "bad value in " << arg << endl;
+            return 1;
+        }
+    }
+
+    if(paths.empty())
+    {
+        cerr << "usage: crypto_cavp [--threads=<n>] <file.rsp | directory>..." << endl;
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<unique_ptr<CAVPFile>> files;
+    try
+    {
+        for(const string& path : paths)
+        {
+            if(!filesystem::is_directory(path))
+            {
+                files.emplace_back(new CAVPFile(path));
+                continue;
+            }
+
+            vector<string> found;
+            for(const filesystem::directory_entry& entry : filesystem::directory_iterator(path))
+            {
+                if(entry.is_regular_file() && entry.path().extension() == ".rsp")
+                {
+                    found.push_back(entry.path().string());
+                }
+            }
+            sort(found.begin(), found.end());
+            for(const string& file : found)
+            {
+                files.emplace_back(new CAVPFile(file));
+            }
+        }
+    }
+    catch(const exception& error)
+    {
+        cerr << error.what() << endl;
+        return 1;
+    }
+
+    CAVPReport report = runCAVP(files, threads);
+    double milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    for(const CAVPFileResult& file : report.files)
+    {
+        cout << left << setw(28) << file.name << setw(28) << file.test << right << setw(7) << file.passed << " passed"
+             << setw(7) << file.failed << " failed" << setw(7) << file.skipped << " skipped" << endl;
+    }
+    for(const string& failure : report.failures)
+    {
+        cout << "FAILED: " << failure << endl;
+    }
+
+    cout << endl << "CAVP: " << files.size() << " files, " << report.passed << " passed, " << report.failed << " failed, "
+         << report.skipped << " skipped in " << fixed << setprecision(1) << milliseconds << " ms" << endl;
+    return report.failed == 0 && report.passed > 0 ? 0 : 1;
+}
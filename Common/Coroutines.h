@@ -0,0 +1,312 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the C++20 coroutine building blocks of the streaming pipelines:
+ *
+ *                    - CoTask: a coroutine that starts on the shared ThreadPool when a CoGroup spawns it. A suspended
+ *                      coroutine holds no thread, so a pipeline of many stages and workers runs on however many pool
+ *                      workers there are, one core included.
+ *                    - CoGroup: spawns CoTasks and lets a thread outside the pool wait for all of them. The first exception a
+ *                      task lets escape is kept and rethrown by wait().
+ *                    - Channel<T>: a bounded multi-producer multi-consumer queue. push suspends while the queue is full, which
+ *                      is the backpressure between stages, and pop suspends while it is empty. After close() pushes fail and
+ *                      pops drain what is left, then return nothing. The suspensions on either side are counted, so a report
+ *                      can tell a stage that starves from one that is held back.
+ *
+ *                  A coroutine resumed by another one is posted to the pool rather than resumed inline, so a long chain of
+ *                  handoffs never deepens the stack, and the locks of a Channel are never held while anything is resumed.
+*/
+
+#ifndef COROUTINES_H
+#define COROUTINES_H
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "ThreadPool.h"
+
+using namespace std;
+
+// resumes a suspended coroutine on a pool worker
+inline void coSchedule(coroutine_handle<> handle)
+{
+    ThreadPool::shared().submit(ThreadPool::Task{[](void* address) { coroutine_handle<>::from_address(address).resume(); }, handle.address()});
+}
+
+
+class CoGroup;
+
+class CoTask
+{
+    public:
+        struct promise_type
+        {
+            CoGroup* group = nullptr;
+
+            CoTask get_return_object() { return CoTask(coroutine_handle<promise_type>::from_promise(*this)); }
+            suspend_always initial_suspend() noexcept { return {}; }
+
+            // the frame is destroyed as the coroutine ends, then the group learns that one task fewer is running
+            struct Final
+            {
+                bool await_ready() noexcept { return false; }
+                void await_suspend(coroutine_handle<promise_type>) noexcept;
+                void await_resume() noexcept {}
+            };
+            Final final_suspend() noexcept { return {}; }
+
+            void return_void() {}
+            void unhandled_exception();
+        };
+
+        CoTask(CoTask&& other) noexcept : handle(exchange(other.handle, nullptr)) {}
+        CoTask(const CoTask&) = delete;
+        CoTask& operator=(const CoTask&) = delete;
+        ~CoTask()
+        {
+            if(this->handle)
+            {
+                this->handle.destroy(); // never spawned
+            }
+        }
+
+    private:
+        friend class CoGroup;
+        explicit CoTask(coroutine_handle<promise_type> handle) : handle(handle) {}
+        coroutine_handle<promise_type> handle;
+};
+
+
+class CoGroup
+{
+    public:
+        CoGroup() : running(0) {}
+        CoGroup(const CoGroup&) = delete;
+        CoGroup& operator=(const CoGroup&) = delete;
+        ~CoGroup() { wait(nothrow); }
+
+        void spawn(CoTask task)
+        {
+            coroutine_handle<CoTask::promise_type> handle = exchange(task.handle, nullptr);
+            handle.promise().group = this;
+            this->running++;
+            coSchedule(handle);
+        }
+
+        // blocks until every spawned task has finished, then rethrows the first exception one of them let escape
+        void wait()
+        {
+            wait(nothrow);
+            if(this->error)
+            {
+                rethrow_exception(exchange(this->error, nullptr));
+            }
+        }
+
+    private:
+        friend struct CoTask::promise_type;
+
+        atomic<size_t> running;
+        mutex lock;
+        condition_variable done;
+        exception_ptr error;
+
+        void wait(const nothrow_t&)
+        {
+            unique_lock<mutex> guard(this->lock);
+            this->done.wait(guard, [this]() { return this->running == 0; });
+        }
+
+        void finished()
+        {
+            lock_guard<mutex> guard(this->lock);
+            if(--this->running == 0)
+            {
+                this->done.notify_all();
+            }
+        }
+
+        void fail(exception_ptr e)
+        {
+            lock_guard<mutex> guard(this->lock);
+            if(!this->error)
+            {
+                this->error = e;
+            }
+        }
+};
+
+
+inline void CoTask::promise_type::Final::await_suspend(coroutine_handle<promise_type> handle) noexcept
+{
+    CoGroup* group = handle.promise().group;
+    handle.destroy();
+    group->finished();
+}
+
+
+inline void CoTask::promise_type::unhandled_exception()
+{
+    this->group->fail(current_exception());
+}
+
+
+
+
+template<typename T>
+class Channel
+{
+    public:
+        explicit Channel(size_t capacity) : capacity(capacity < 1 ? 1 : capacity), closed(false), fullWaits(0), emptyWaits(0) {}
+        Channel(const Channel&) = delete;
+        Channel& operator=(const Channel&) = delete;
+
+        // co_await push(value): true once the value is queued, false if the channel is closed
+        struct PushAwaiter
+        {
+            Channel& channel;
+            T value;
+            bool accepted = false;
+
+            bool await_ready() { return false; }
+            bool await_suspend(coroutine_handle<> handle) { return channel.suspendPush(*this, handle); }
+            bool await_resume() { return accepted; }
+        };
+
+        // co_await pop(): the oldest value, or nothing once the channel is closed and empty
+        struct PopAwaiter
+        {
+            Channel& channel;
+            optional<T> value;
+
+            bool await_ready() { return false; }
+            bool await_suspend(coroutine_handle<> handle) { return channel.suspendPop(*this, handle); }
+            optional<T> await_resume() { return move(value); }
+        };
+
+        PushAwaiter push(T value) { return PushAwaiter{*this, move(value)}; }
+        PopAwaiter pop() { return PopAwaiter{*this, nullopt}; }
+
+        // wakes every waiting consumer with nothing and every waiting producer with false
+        void close()
+        {
+            deque<pair<coroutine_handle<>, PopAwaiter*>> consumers;
+            deque<pair<coroutine_handle<>, PushAwaiter*>> producers;
+            {
+                lock_guard<mutex> guard(this->lock);
+                this->closed = true;
+                swap(consumers, this->consumers);
+                swap(producers, this->producers);
+            }
+            for(auto& consumer : consumers)
+            {
+                coSchedule(consumer.first);
+            }
+            for(auto& producer : producers)
+            {
+                coSchedule(producer.first);
+            }
+        }
+
+        uint64_t producerWaits() const { return this->fullWaits; } // pushes that found the channel full
+        uint64_t consumerWaits() const { return this->emptyWaits; } // pops that found it empty
+
+    private:
+        const size_t capacity;
+        mutex lock;
+        deque<T> items;
+        deque<pair<coroutine_handle<>, PopAwaiter*>> consumers;
+        deque<pair<coroutine_handle<>, PushAwaiter*>> producers;
+        bool closed;
+        atomic<uint64_t> fullWaits;
+        atomic<uint64_t> emptyWaits;
+
+        // hands the value to a waiting consumer, or queues it, or parks the producer; returns whether it suspends
+        bool suspendPush(PushAwaiter& push, coroutine_handle<> handle)
+        {
+            coroutine_handle<> wake = nullptr;
+            {
+                lock_guard<mutex> guard(this->lock);
+                if(this->closed)
+                {
+                    return false;
+                }
+
+                push.accepted = true;
+                if(!this->consumers.empty())
+                {
+                    auto consumer = this->consumers.front();
+                    this->consumers.pop_front();
+                    consumer.second->value = move(push.value);
+                    wake = consumer.first;
+                }
+                else if(this->items.size() < this->capacity)
+                {
+                    this->items.push_back(move(push.value));
+                }
+                else
+                {
+                    push.accepted = false;
+                    this->producers.emplace_back(handle, &push);
+                    this->fullWaits++;
+                    return true;
+                }
+            }
+
+            if(wake)
+            {
+                coSchedule(wake);
+            }
+            return false;
+        }
+
+        // takes the oldest value and lets a parked producer queue its own, or parks the consumer; returns whether it suspends
+        bool suspendPop(PopAwaiter& pop, coroutine_handle<> handle)
+        {
+            coroutine_handle<> wake = nullptr;
+            {
+                lock_guard<mutex> guard(this->lock);
+                if(!this->items.empty())
+                {
+                    pop.value = move(this->items.front());
+                    this->items.pop_front();
+                    if(!this->producers.empty())
+                    {
+                        auto producer = this->producers.front();
+                        this->producers.pop_front();
+                        this->items.push_back(move(producer.second->value));
+                        producer.second->accepted = true;
+                        wake = producer.first;
+                    }
+                }
+                else if(this->closed)
+                {
+                    return false;
+                }
+                else
+                {
+                    this->consumers.emplace_back(handle, &pop);
+                    this->emptyWaits++;
+                    return true;
+                }
+            }
+
+            if(wake)
+            {
+                coSchedule(wake);
+            }
+            return false;
+        }
+};
+
+#endif
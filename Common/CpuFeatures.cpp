@@ -0,0 +1,100 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the CPUID and XGETBV based feature detection.
+*/
+
+#include "CpuFeatures.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+using namespace std;
+
+
+/* Function: disabled
+ * Parameters: A feature name
+ * Return: true if CRYPTO_DISABLE lists the feature or "all"
+*/
+static bool disabled(const char* feature)
+{
+    const char* list = getenv("CRYPTO_DISABLE");
+    if(list == nullptr)
+    {
+        return false;
+    }
+
+    string names = string(",") + list + ",";
+    return names.find(",all,") != string::npos || names.find(string(",") + feature + ",") != string::npos;
+}
+
+
+static CpuFeatures detect()
+{
+    CpuFeatures features;
+    memset(&features, 0, sizeof(features));
+
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+        return features;
+    }
+
+    bool ssse3 = ecx & (1u << 9);
+    bool sse41 = ecx & (1u << 19);
+    bool pclmul = ecx & (1u << 1);
+    bool aesni = ecx & (1u << 25);
+    bool osxsave = ecx & (1u << 27);
+    bool avx = ecx & (1u << 28);
+
+    // the OS must save the YMM (and for AVX-512 the opmask and ZMM) registers on a context switch
+    bool ymmState = false;
+    bool zmmState = false;
+    if(osxsave && avx)
+    {
+        unsigned int xcr0Low, xcr0High;
+        __asm__ ("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+        ymmState = (xcr0Low & 0x06) == 0x06;
+        zmmState = (xcr0Low & 0xE6) == 0xE6;
+    }
+
+    bool avx2 = false, avx512f = false, avx512bw = false, sha = false, vaes = false, vpclmulqdq = false;
+    if(__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    {
+        avx2 = ymmState && (ebx & (1u << 5));
+        avx512f = zmmState && (ebx & (1u << 16));
+        avx512bw = zmmState && (ebx & (1u << 30));
+        sha = ebx & (1u << 29);
+        vaes = ymmState && (ecx & (1u << 9));
+        vpclmulqdq = ymmState && (ecx & (1u << 10));
+    }
+
+    features.ssse3 = ssse3 && !disabled("ssse3");
+    features.sse41 = sse41 && !disabled("sse41");
+    features.pclmul = pclmul && !disabled("pclmul");
+    features.aesni = aesni && !disabled("aesni");
+    features.avx2 = avx2 && !disabled("avx2");
+    features.avx512f = avx512f && !disabled("avx512");
+    features.avx512bw = avx512bw && !disabled("avx512");
+    features.sha = sha && !disabled("sha");
+    features.vaes = vaes && !disabled("vaes");
+    features.vpclmulqdq = vpclmulqdq && !disabled("vpclmulqdq");
+#endif
+
+    return features;
+}
+
+
+const CpuFeatures& cpuFeatures()
+{
+    static const CpuFeatures features = detect();
+    return features;
+}
@@ -0,0 +1,39 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the runtime CPU feature detection used to pick between the portable code and the per-ISA
+ *                  kernels (SSSE3, AVX2, AVX-512, AES-NI, SHA-NI, ...). A kernel is only used if the CPU and the OS both support
+ *                  it. Features can be switched off for testing with the CRYPTO_DISABLE environment variable, a comma separated
+ *                  list of feature names such as "avx512,aesni", or "all" to force the portable code everywhere.
+*/
+
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+struct CpuFeatures
+{
+    bool ssse3;
+    bool sse41;
+    bool pclmul;
+    bool aesni;
+    bool avx2;
+    bool avx512f;
+    bool avx512bw;
+    bool sha;
+    bool vaes;
+    bool vpclmulqdq;
+};
+
+const CpuFeatures& cpuFeatures();
+
+
+// Function multiversioning for portable hot loops: the compiler emits a default and an AVX2 clone and the loader picks one
+#if defined(CRYPTO_MULTIVERSIONING) && (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && defined(__ELF__)
+#define CRYPTO_MULTIVERSION __attribute__((target_clones("default", "avx2")))
+#else
+#define CRYPTO_MULTIVERSION
+#endif
+
+#endif
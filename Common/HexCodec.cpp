@@ -0,0 +1,118 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the scalar hexadecimal codec and the runtime dispatch to the SSSE3 and AVX2 kernels.
+*/
+
+#include "HexCodec.h"
+#include "HexCodecKernels.h"
+#include "CpuFeatures.h"
+
+
+const char HexDigits[] = "0123456789abcdef";
+
+
+// -------------------------------------- SCALAR --------------------------------------
+
+/* Function: hexValue
+ * Parameters: A character
+ * Return: The value 0 - 15 of the hex digit, or -1 if the character is not a hex digit
+ * Description: This function converts one hex digit without a lookup table so that it can not read out of bounds on bad input
+*/
+static inline int hexValue(char c)
+{
+    uint8_t digit = static_cast<uint8_t>( c - '0' );
+    uint8_t alpha = static_cast<uint8_t>( (c | 0x20) - 'a' );
+
+    if(digit <= 9)
+    {
+        return digit;
+    }
+    if(alpha <= 5)
+    {
+        return alpha + 10;
+    }
+    return -1;
+}
+
+
+static void hexEncodeScalar(const uint8_t* in, size_t length, char* out)
+{
+    for(size_t i = 0; i < length; i++)
+    {
+        out[2 * i] = HexDigits[in[i] >> 4];
+        out[2 * i + 1] = HexDigits[in[i] & 0x0F];
+    }
+}
+
+
+static bool hexDecodeScalar(const char* in, size_t bytes, uint8_t* out)
+{
+    for(size_t i = 0; i < bytes; i++)
+    {
+        int hi = hexValue(in[2 * i]);
+        int lo = hexValue(in[2 * i + 1]);
+        if(hi < 0 || lo < 0)
+        {
+            return false;
+        }
+        out[i] = static_cast<uint8_t>( (hi << 4) | lo );
+    }
+    return true;
+}
+
+
+
+
+// -------------------------------------- DISPATCH --------------------------------------
+
+size_t hexEncode(const uint8_t* in, size_t length, char* out)
+{
+    size_t done = 0;
+
+    if(cpuFeatures().avx2)
+    {
+        done = hexEncodeAVX2(in, length, out);
+    }
+    if(cpuFeatures().ssse3)
+    {
+        done += hexEncodeSSSE3(in + done, length - done, out + 2 * done);
+    }
+
+    hexEncodeScalar(in + done, length - done, out + 2 * done);
+    return 2 * length;
+}
+
+
+bool hexDecode(const char* in, size_t length, uint8_t* out)
+{
+    if(length % 2 != 0)
+    {
+        return false;
+    }
+
+    size_t bytes = length / 2;
+    size_t done = 0;
+    bool ok = true;
+
+    if(cpuFeatures().avx2)
+    {
+        done = hexDecodeAVX2(in, bytes, out, ok);
+    }
+    if(ok && cpuFeatures().ssse3)
+    {
+        done += hexDecodeSSSE3(in + 2 * done, bytes - done, out + done, ok);
+    }
+
+    return ok && hexDecodeScalar(in + 2 * done, bytes - done, out + done);
+}
+
+
+string hexEncode(const uint8_t* in, size_t length)
+{
+    string out(2 * length, '\0');
+    hexEncode(in, length, &out[0]);
+    return out;
+}
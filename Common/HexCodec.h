@@ -0,0 +1,30 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the hexadecimal codec shared by the AES and SHA1 projects. Encoding produces lowercase digits,
+ *                  decoding accepts either case and rejects anything that is not a hex digit. The SSSE3 and AVX2 paths are selected
+ *                  at runtime and produce exactly the same output as the scalar path.
+*/
+
+#ifndef HEX_CODEC_H
+#define HEX_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+using namespace std;
+
+// Writes 2 * length lowercase hex characters to out (no terminator is written). Returns the number of characters written.
+size_t hexEncode(const uint8_t* in, size_t length, char* out);
+
+// Reads length hex characters and writes length / 2 bytes to out. Returns false, leaving out unspecified, if length is odd or
+// any character is not a hex digit.
+bool hexDecode(const char* in, size_t length, uint8_t* out);
+
+// Allocating convenience wrapper around hexEncode
+string hexEncode(const uint8_t* in, size_t length);
+
+#endif
@@ -0,0 +1,26 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file declares the per-ISA hex codec kernels. Each kernel lives in its own translation unit that the build
+ *                  compiles with the matching -m flags; without them the kernel is a stub that processes nothing. A kernel handles
+ *                  whole vectors only and returns the number of input bytes it encoded or output bytes it decoded, so the caller
+ *                  finishes the tail with the next narrower kernel or the scalar code.
+*/
+
+#ifndef HEX_CODEC_KERNELS_H
+#define HEX_CODEC_KERNELS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+size_t hexEncodeSSSE3(const uint8_t* in, size_t length, char* out);
+size_t hexDecodeSSSE3(const char* in, size_t bytes, uint8_t* out, bool& ok);
+
+size_t hexEncodeAVX2(const uint8_t* in, size_t length, char* out);
+size_t hexDecodeAVX2(const char* in, size_t bytes, uint8_t* out, bool& ok);
+
+extern const char HexDigits[];
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the AVX2 hex codec kernels. It is compiled with -mavx2.
+*/
+
+#include "HexCodecKernels.h"
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+
+// -------------------------------------- AVX2 --------------------------------------
+
+size_t hexEncodeAVX2(const uint8_t* in, size_t length, char* out)
+{
+    const __m256i digits = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(HexDigits)));
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+
+    size_t i = 0;
+    for(; i + 32 <= length; i += 32)
+    {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i hi = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble));
+        __m256i lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(x, nibble));
+
+        // the unpacks work within each 128 bit lane, so the lanes are put back in order afterwards
+        __m256i first = _mm256_unpacklo_epi8(hi, lo);
+        __m256i second = _mm256_unpackhi_epi8(hi, lo);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    return i;
+}
+
+
+static inline __m256i hexValuesAVX2(__m256i c, __m256i& valid)
+{
+    __m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    __m256i alpha = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+
+    __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    __m256i isAlpha = _mm256_cmpeq_epi8(_mm256_min_epu8(alpha, _mm256_set1_epi8(5)), alpha);
+
+    valid = _mm256_and_si256(valid, _mm256_or_si256(isDigit, isAlpha));
+
+    return _mm256_blendv_epi8(_mm256_add_epi8(alpha, _mm256_set1_epi8(10)), digit, isDigit);
+}
+
+
+size_t hexDecodeAVX2(const char* in, size_t bytes, uint8_t* out, bool& ok)
+{
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    __m256i valid = _mm256_set1_epi8(-1);
+
+    size_t i = 0;
+    for(; i + 32 <= bytes; i += 32)
+    {
+        __m256i a = hexValuesAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i)), valid);
+        __m256i b = hexValuesAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i + 32)), valid);
+
+        // PACKUSWB interleaves the 128 bit lanes of its operands; VPERMQ restores the byte order
+        __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+
+    ok = _mm256_movemask_epi8(valid) == -1;
+    return i;
+}
+
+#else
+
+size_t hexEncodeAVX2(const uint8_t*, size_t, char*)
+{
+    return 0;
+}
+
+
+size_t hexDecodeAVX2(const char*, size_t, uint8_t*, bool& ok)
+{
+    ok = true;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the SSSE3 hex codec kernels. It is compiled with -mssse3.
+*/
+
+#include "HexCodecKernels.h"
+
+#ifdef __SSSE3__
+
+#include <immintrin.h>
+
+
+// -------------------------------------- SSSE3 --------------------------------------
+
+/* Function: hexEncodeSSSE3
+ * Description: Each 16 byte load is split into high and low nibbles, PSHUFB looks every nibble up in the digit table, and the two
+ *              halves are interleaved into 32 output characters.
+*/
+size_t hexEncodeSSSE3(const uint8_t* in, size_t length, char* out)
+{
+    const __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(HexDigits));
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+
+    size_t i = 0;
+    for(; i + 16 <= length; i += 16)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(x, 4), nibble));
+        __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(x, nibble));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    return i;
+}
+
+
+/* Function: hexValuesSSSE3
+ * Description: Converts 16 characters to their nibble values. Digits and letters are recognised with unsigned range checks; any
+ *              lane that is neither clears the corresponding bit of valid.
+*/
+static inline __m128i hexValuesSSSE3(__m128i c, __m128i& valid)
+{
+    __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    __m128i alpha = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+
+    __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    __m128i isAlpha = _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(5)), alpha);
+
+    valid = _mm_and_si128(valid, _mm_or_si128(isDigit, isAlpha));
+
+    return _mm_or_si128(_mm_and_si128(isDigit, digit),
+                        _mm_andnot_si128(isDigit, _mm_add_epi8(alpha, _mm_set1_epi8(10))));
+}
+
+
+/* Function: hexDecodeSSSE3
+ * Description: 32 characters become 16 bytes per iteration. PMADDUBSW combines each (high, low) nibble pair as high * 16 + low and
+ *              PACKUSWB narrows the words back to bytes.
+*/
+size_t hexDecodeSSSE3(const char* in, size_t bytes, uint8_t* out, bool& ok)
+{
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    __m128i valid = _mm_set1_epi8(-1);
+
+    size_t i = 0;
+    for(; i + 16 <= bytes; i += 16)
+    {
+        __m128i a = hexValuesSSSE3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i)), valid);
+        __m128i b = hexValuesSSSE3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i + 16)), valid);
+
+        __m128i packed = _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+    }
+
+    ok = _mm_movemask_epi8(valid) == 0xFFFF;
+    return i;
+}
+
+#else
+
+size_t hexEncodeSSSE3(const uint8_t*, size_t, char*)
+{
+    return 0;
+}
+
+
+size_t hexDecodeSSSE3(const char*, size_t, uint8_t*, bool& ok)
+{
+    ok = true;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,136 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the LatencyHistogram method definitions.
+*/
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+
+void LatencyHistogram::reset()
+{
+    memset(this->counts, 0, sizeof(this->counts));
+    this->samples = 0;
+    this->total = 0;
+    this->largest = 0;
+}
+
+
+/* Function: bucket
+ * Parameters: A value
+ * Return: Its bucket
+ * Description: Values below SubBuckets have a bucket each. Above, e is the position of the top bit and the next three bits pick
+ *              one of the SubBuckets buckets that split [2^e, 2^(e + 1)).
+*/
+int LatencyHistogram::bucket(uint64_t value)
+{
+    if(value < SubBuckets)
+    {
+        return static_cast<int>( value );
+    }
+
+    int e = 63 - __builtin_clzll(value);
+    int sub = static_cast<int>( value >> (e - 3) ) & (SubBuckets - 1);
+    return (e - 2) * SubBuckets + sub;
+}
+
+
+uint64_t LatencyHistogram::upperBound(int index)
+{
+    if(index < SubBuckets)
+    {
+        return static_cast<uint64_t>( index );
+    }
+
+    int e = index / SubBuckets + 2;
+    uint64_t sub = static_cast<uint64_t>( index % SubBuckets );
+    return ((SubBuckets + sub) << (e - 3)) + ((uint64_t(1) << (e - 3)) - 1);
+}
+
+
+void LatencyHistogram::record(uint64_t nanoseconds)
+{
+    this->counts[bucket(nanoseconds)]++;
+    this->samples++;
+    this->total += nanoseconds;
+    this->largest = std::max(this->largest, nanoseconds);
+}
+
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    for(int i = 0; i < Buckets; i++)
+    {
+        this->counts[i] += other.counts[i];
+    }
+    this->samples += other.samples;
+    this->total += other.total;
+    this->largest = std::max(this->largest, other.largest);
+}
+
+
+double LatencyHistogram::mean() const
+{
+    return this->samples == 0 ? 0.0 : static_cast<double>( this->total ) / static_cast<double>( this->samples );
+}
+
+
+uint64_t LatencyHistogram::percentile(double fraction) const
+{
+    if(this->samples == 0)
+    {
+        return 0;
+    }
+
+    // the rank of the sample, 1 based, rounded up so that p100 is the last sample
+    uint64_t rank = static_cast<uint64_t>( fraction * static_cast<double>( this->samples ) + 0.999999 );
+    rank = std::min(std::max<uint64_t>(rank, 1), this->samples);
+
+    uint64_t seen = 0;
+    for(int i = 0; i < Buckets; i++)
+    {
+        seen += this->counts[i];
+        if(seen >= rank)
+        {
+            return std::min(upperBound(i), this->largest);
+        }
+    }
+    return this->largest;
+}
+
+
+void LatencyHistogram::print(ostream& out, const char* label) const
+{
+    auto us = [](double ns) { return ns / 1000.0; };
+
+    ios_base::fmtflags flags = out.flags();
+    out << left << setw(12) << label << right << setw(10) << this->samples << fixed << setprecision(1)
+        << setw(10) << us(mean())
+        << setw(10) << us(static_cast<double>( percentile(0.50) ))
+        << setw(10) << us(static_cast<double>( percentile(0.90) ))
+        << setw(10) << us(static_cast<double>( percentile(0.99) ))
+        << setw(10) << us(static_cast<double>( percentile(0.999) ))
+        << setw(10) << us(static_cast<double>( this->largest )) << endl;
+    out.flags(flags);
+}
+
+
+void LatencyHistogram::printHeader(ostream& out)
+{
+    ios_base::fmtflags flags = out.flags();
+    out << left << setw(12) << "" << right << setw(10) << "count" << setw(10) << "mean us" << setw(10) << "p50" << setw(10) << "p90"
+        << setw(10) << "p99" << setw(10) << "p99.9" << setw(10) << "max" << endl;
+    out.flags(flags);
+}
@@ -0,0 +1,52 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains LatencyHistogram, a fixed size log-linear histogram of durations in nanoseconds. Every power
+ *                  of two is split into SubBuckets equal buckets, so a recorded value is known to within 1 / SubBuckets of itself
+ *                  (12.5%) from 1 ns to the full 64-bit range, in 4 KiB and without allocating. Recording is an index computation
+ *                  and an increment; it is not synchronized, so each thread keeps its own histogram and merges them to report.
+*/
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <ostream>
+
+using namespace std;
+
+class LatencyHistogram
+{
+    public:
+        static const int SubBuckets = 8;
+        static const int Buckets = 64 * SubBuckets;
+
+        LatencyHistogram();
+
+        void record(uint64_t nanoseconds);
+        void merge(const LatencyHistogram&);
+        void reset();
+
+        uint64_t count() const { return this->samples; }
+        uint64_t max() const { return this->largest; }
+        double mean() const; // nanoseconds
+        uint64_t percentile(double) const; // upper bound of the bucket holding that fraction (0 to 1) of the samples
+
+        // count, mean, p50, p90, p99, p99.9 and max in microseconds on one line
+        void print(ostream&, const char* label) const;
+        static void printHeader(ostream&); // the column titles of print
+
+    private:
+        uint64_t counts[Buckets];
+        uint64_t samples;
+        uint64_t total;
+        uint64_t largest;
+
+        static int bucket(uint64_t);
+        static uint64_t upperBound(int);
+};
+
+#endif
@@ -0,0 +1,159 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the Merkle-Damgard streaming framework shared by SHA1 and the SHA-2 family. The hashes
+ *                  differ only in their block size, the width of the length field and the compression function; buffering of
+ *                  partial blocks, padding (a '1' bit, zeros, then the big-endian message length in bits) and the one-shot
+ *                  interface live here once.
+ *
+ *                  Hash derives from MerkleDamgard<Hash, BlockBytes, LengthBytes> and provides
+ *                      void processBlocks(const uint8_t* blocks, size_t count);   compress count whole blocks
+ *                      void reset();                                               set the initial hash value, call resetStream()
+ *                      void finalize(uint8_t* digest);                             call finishStream(), write the digest
+*/
+
+#ifndef MERKLE_DAMGARD_H
+#define MERKLE_DAMGARD_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+using namespace std;
+
+template<typename Hash, size_t BlockBytes, size_t LengthBytes>
+class MerkleDamgard
+{
+    public:
+        static constexpr size_t BlockSize = BlockBytes;
+
+        // absorb length bytes of the message; full blocks are compressed straight from the caller's buffer without copying
+        void update(const uint8_t* data, size_t length)
+        {
+            if(length == 0) // data may be null
+            {
+                return;
+            }
+            this->messageLength += length;
+
+            // top up a partial block left by the previous call
+            if(this->bufferLength > 0)
+            {
+                size_t take = BlockBytes - this->bufferLength;
+                if(take > length)
+                {
+                    take = length;
+                }
+
+                memcpy(this->buffer + this->bufferLength, data, take);
+                this->bufferLength += take;
+                data += take;
+                length -= take;
+
+                if(this->bufferLength < BlockBytes)
+                {
+                    return;
+                }
+
+                hash().processBlocks(this->buffer, 1);
+                this->bufferLength = 0;
+            }
+
+            size_t blocks = length / BlockBytes;
+            hash().processBlocks(data, blocks);
+            data += blocks * BlockBytes;
+            length -= blocks * BlockBytes;
+
+            memcpy(this->buffer, data, length);
+            this->bufferLength = length;
+        }
+
+        // one-shot: reset, update, finalize
+        void digest(const uint8_t* message, size_t length, uint8_t* digest)
+        {
+            hash().reset();
+            update(message, length);
+            hash().finalize(digest);
+        }
+
+        // the whole padded message at once, as a multiple of BlockBytes
+        static string padMessage(string message)
+        {
+            uint64_t originalLength = message.length() * 8;
+
+            // append a single '1' bit
+            string paddedMessage = message + static_cast<char>(0x80);
+
+            // append the 0s up to the length field
+            size_t paddingLength = (2 * BlockBytes - LengthBytes - paddedMessage.length() % BlockBytes) % BlockBytes;
+            paddedMessage.append(paddingLength, static_cast<char>(0x00));
+
+            // append the bytes of the original length; only the low 64 bits can be non-zero for a string
+            paddedMessage.append(LengthBytes - 8, static_cast<char>(0x00));
+            for(int i = 0; i < 8; i++)
+            {
+                paddedMessage += static_cast<char>((originalLength >> (56 - (8 * i))) & 0xFF);
+            }
+
+            return paddedMessage;
+        }
+
+    protected:
+        uint8_t buffer[BlockBytes]; // the partial block carried between update() calls
+        size_t bufferLength; // number of bytes held in buffer
+        uint64_t messageLength; // total message length in bytes
+
+        void resetStream()
+        {
+            this->bufferLength = 0;
+            this->messageLength = 0;
+        }
+
+        // continue a message whose first length bytes (whole blocks) are already in the hash value
+        void resumeStream(uint64_t length)
+        {
+            this->bufferLength = 0;
+            this->messageLength = length;
+        }
+
+        // pad the buffered tail as padMessage does and compress it; the hash value is then final
+        void finishStream()
+        {
+            // append a single '1' bit
+            this->buffer[this->bufferLength++] = 0x80;
+
+            // no room left for the length; pad out this block and start another
+            if(this->bufferLength > BlockBytes - LengthBytes)
+            {
+                memset(this->buffer + this->bufferLength, 0, BlockBytes - this->bufferLength);
+                hash().processBlocks(this->buffer, 1);
+                this->bufferLength = 0;
+            }
+
+            // append the 0s and the bytes of the length in bits; the bits above 64 come from the top of the byte count
+            memset(this->buffer + this->bufferLength, 0, BlockBytes - this->bufferLength);
+            uint64_t low = this->messageLength << 3;
+            uint64_t high = this->messageLength >> 61;
+            for(int i = 0; i < 8; i++)
+            {
+                this->buffer[BlockBytes - 1 - i] = static_cast<uint8_t>( low >> (8 * i) );
+            }
+            if(LengthBytes > 8)
+            {
+                this->buffer[BlockBytes - 9] = static_cast<uint8_t>( high );
+            }
+
+            hash().processBlocks(this->buffer, 1);
+            this->bufferLength = 0;
+        }
+
+    private:
+        Hash& hash() { return static_cast<Hash&>( *this ); }
+
+};
+
+
+#endif
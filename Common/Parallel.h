@@ -0,0 +1,29 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains parallelFor, the fork-join loop used to spread independent items (files, tree leaves,
+ *                  password candidates, record groups) across cores. It runs on the shared work-stealing ThreadPool, and threads
+ *                  take the next item from a shared counter, so items of uneven cost balance out without any up-front partitioning.
+*/
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <cstddef>
+
+#include "ThreadPool.h"
+
+using namespace std;
+
+// Runs work(i) for every i below count on up to threads threads (0 = one per pool worker). The calling thread takes part, and
+// a single thread or a single item runs inline.
+template<typename Work>
+void parallelFor(size_t count, unsigned threads, const Work& work)
+{
+    ThreadPool::shared().parallelFor(count, threads, work);
+}
+
+
+#endif
@@ -0,0 +1,292 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the perf_event_open counter groups behind PERF_SCOPE. Every thread opens its own group of four
+ *                  user-space counters the first time it enters a scope, and a scope costs one read() of the group on entry and one
+ *                  on exit. Nested scopes are measured independently from the same running counters.
+*/
+
+#include "PerfCounters.h"
+
+#ifdef CRYPTO_PERF_COUNTERS
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+
+// -------------------------------------- COUNTER GROUP --------------------------------------
+
+class PerfGroup
+{
+    public:
+        PerfGroup();
+        ~PerfGroup();
+
+        bool ok() const { return leader >= 0; }
+        void read(uint64_t (&)[PerfRegion::CounterCount]);
+
+    private:
+        int leader;
+        int fds[4];
+};
+
+
+static int openCounter(uint32_t type, uint64_t config, int group)
+{
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group < 0; // the leader starts disabled and enables the whole group at once
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    return static_cast<int>( syscall(SYS_perf_event_open, &attr, 0, -1, group, 0) );
+}
+
+
+PerfGroup::PerfGroup() : leader(-1), fds{-1, -1, -1, -1}
+{
+    const uint64_t l1dReadMiss = PERF_COUNT_HW_CACHE_L1D |
+                                 (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                 (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+    fds[0] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+    if(fds[0] < 0)
+    {
+        return;
+    }
+    fds[1] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, fds[0]);
+    fds[2] = openCounter(PERF_TYPE_HW_CACHE, l1dReadMiss, fds[0]);
+    fds[3] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, fds[0]);
+
+    // all four must be scheduled together or the ratios between them are meaningless
+    for(int fd : fds)
+    {
+        if(fd < 0)
+        {
+            for(int& open : fds)
+            {
+                if(open >= 0)
+                {
+                    close(open);
+                    open = -1;
+                }
+            }
+            return;
+        }
+    }
+
+    leader = fds[0];
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+
+PerfGroup::~PerfGroup()
+{
+    for(int fd : fds)
+    {
+        if(fd >= 0)
+        {
+            close(fd);
+        }
+    }
+}
+
+
+void PerfGroup::read(uint64_t (&values)[PerfRegion::CounterCount])
+{
+    values[PerfRegion::Nanoseconds] = static_cast<uint64_t>(
+        chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count() );
+
+    // PERF_FORMAT_GROUP layout: nr, then one value per counter in the order they were opened
+    uint64_t buffer[1 + 4] = {};
+    if(ok() && ::read(leader, buffer, sizeof(buffer)) == static_cast<ssize_t>( sizeof(buffer) ))
+    {
+        for(int i = 0; i < 4; i++)
+        {
+            values[i] = buffer[1 + i];
+        }
+    }
+    else
+    {
+        for(int i = 0; i < 4; i++)
+        {
+            values[i] = 0;
+        }
+    }
+}
+
+
+static PerfGroup& threadGroup()
+{
+    thread_local PerfGroup group;
+    return group;
+}
+
+
+
+
+// -------------------------------------- REGIONS --------------------------------------
+
+static mutex& registryLock()
+{
+    static mutex lock;
+    return lock;
+}
+
+
+static vector<unique_ptr<PerfRegion>>& registry()
+{
+    static vector<unique_ptr<PerfRegion>> regions;
+    return regions;
+}
+
+
+PerfRegion::PerfRegion(const char* name) : name(name), calls(0), items(0)
+{
+    for(auto& total : totals)
+    {
+        total.store(0, memory_order_relaxed);
+    }
+}
+
+
+PerfRegion& PerfRegion::get(const char* name)
+{
+    lock_guard<mutex> guard(registryLock());
+
+    for(auto& region : registry())
+    {
+        if(strcmp(region->name, name) == 0)
+        {
+            return *region;
+        }
+    }
+
+    registry().emplace_back(new PerfRegion(name));
+    return *registry().back();
+}
+
+
+PerfScope::PerfScope(PerfRegion& region, uint64_t items) : region(region), items(items)
+{
+    threadGroup().read(start);
+}
+
+
+PerfScope::~PerfScope()
+{
+    uint64_t stop[PerfRegion::CounterCount];
+    threadGroup().read(stop);
+
+    for(int i = 0; i < PerfRegion::CounterCount; i++)
+    {
+        region.totals[i].fetch_add(stop[i] - start[i], memory_order_relaxed);
+    }
+    region.calls.fetch_add(1, memory_order_relaxed);
+    region.items.fetch_add(items, memory_order_relaxed);
+}
+
+
+bool perfCountersAvailable()
+{
+    return threadGroup().ok();
+}
+
+
+void perfReset()
+{
+    lock_guard<mutex> guard(registryLock());
+
+    for(auto& region : registry())
+    {
+        region->calls.store(0, memory_order_relaxed);
+        region->items.store(0, memory_order_relaxed);
+        for(auto& total : region->totals)
+        {
+            total.store(0, memory_order_relaxed);
+        }
+    }
+}
+
+
+
+
+/* Function: perfReport
+ * Parameters: The stream to write to
+ * Return: None
+ * Description: This function prints one row per region with totals divided by the number of items (blocks, calls) the region
+ *              processed, plus instructions per cycle. Counter columns read n/a if perf_event_open is not permitted.
+*/
+void perfReport(ostream& out)
+{
+    lock_guard<mutex> guard(registryLock());
+    bool counters = threadGroup().ok();
+
+    // callers such as the AES demo leave the stream in hex with a '0' fill
+    ios::fmtflags flags = out.flags();
+    char fill = out.fill();
+    out << dec << setfill(' ');
+
+    out << left << setw(28) << "Region" << right
+        << setw(12) << "Calls" << setw(12) << "Items"
+        << setw(12) << "ns/item" << setw(14) << "cycles/item" << setw(12) << "instr/item"
+        << setw(8) << "IPC" << setw(12) << "L1D miss" << setw(12) << "br miss" << endl;
+    out << string(122, '-') << endl;
+
+    for(auto& region : registry())
+    {
+        uint64_t calls = region->calls.load(memory_order_relaxed);
+        uint64_t items = region->items.load(memory_order_relaxed);
+        if(calls == 0)
+        {
+            continue;
+        }
+
+        auto perItem = [&](PerfRegion::Counter counter)
+        {
+            return region->totals[counter].load(memory_order_relaxed) / static_cast<double>( items ? items : 1 );
+        };
+
+        out << left << setw(28) << region->name << right
+            << setw(12) << calls << setw(12) << items
+            << setw(12) << fixed << setprecision(1) << perItem(PerfRegion::Nanoseconds);
+
+        if(counters)
+        {
+            double cycles = perItem(PerfRegion::Cycles);
+            double instructions = perItem(PerfRegion::Instructions);
+
+            out << setw(14) << cycles << setw(12) << instructions
+                << setw(8) << setprecision(2) << (cycles > 0 ? instructions / cycles : 0.0)
+                << setw(12) << setprecision(3) << perItem(PerfRegion::L1DMisses)
+                << setw(12) << perItem(PerfRegion::BranchMisses);
+        }
+        else
+        {
+            out << setw(14) << "n/a" << setw(12) << "n/a" << setw(8) << "n/a" << setw(12) << "n/a" << setw(12) << "n/a";
+        }
+        out << endl;
+    }
+
+    out.flags(flags);
+    out.fill(fill);
+}
+
+#endif
@@ -0,0 +1,78 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the optional hardware performance counter instrumentation. When the project is compiled with
+ *                  -DCRYPTO_PERF_COUNTERS, PERF_SCOPE("name") measures cycles, instructions, L1D read misses and branch misses of
+ *                  the enclosing scope through perf_event_open and accumulates them per name, and PERF_REPORT(stream) prints the
+ *                  summary table. Without the define every macro expands to nothing.
+ *
+ * Usage:           void AES::Cipher()           { PERF_SCOPE("AES::Cipher"); ... }           one sample per call
+ *                  void encryptBlocks(..., n)   { PERF_BATCH_SCOPE("encryptBlocks", n); ... }  one sample per batch of n items
+ *                  PERF_REPORT(cerr);
+*/
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#ifdef CRYPTO_PERF_COUNTERS
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <ostream>
+
+using namespace std;
+
+class PerfRegion
+{
+    public:
+        enum Counter { Cycles, Instructions, L1DMisses, BranchMisses, Nanoseconds, CounterCount };
+
+        static PerfRegion& get(const char*); // the region of that name, created on first use
+
+        const char* name;
+        atomic<uint64_t> calls;
+        atomic<uint64_t> items;
+        atomic<uint64_t> totals[CounterCount];
+
+    private:
+        explicit PerfRegion(const char*);
+};
+
+
+class PerfScope
+{
+    public:
+        PerfScope(PerfRegion&, uint64_t items = 1);
+        ~PerfScope();
+
+    private:
+        PerfRegion& region;
+        uint64_t items;
+        uint64_t start[PerfRegion::CounterCount];
+};
+
+
+bool perfCountersAvailable(); // false if perf_event_open was refused; only call counts and time are then collected
+void perfReport(ostream&);
+void perfReset();
+
+#define PERF_CONCAT2(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT2(a, b)
+#define PERF_BATCH_SCOPE(name, count) \
+    static PerfRegion& PERF_CONCAT(perfRegion_, __LINE__) = PerfRegion::get(name); \
+    PerfScope PERF_CONCAT(perfScope_, __LINE__)(PERF_CONCAT(perfRegion_, __LINE__), (count))
+#define PERF_SCOPE(name) PERF_BATCH_SCOPE(name, 1)
+#define PERF_REPORT(stream) perfReport(stream)
+
+#else
+
+#define PERF_BATCH_SCOPE(name, count) do { } while(0)
+#define PERF_SCOPE(name) do { } while(0)
+#define PERF_REPORT(stream) do { } while(0)
+
+#endif
+
+#endif
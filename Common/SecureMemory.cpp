@@ -0,0 +1,97 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the allocation behind SecureArray.
+*/
+
+#include "SecureMemory.h"
+
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+static atomic<bool> lockKeys(false);
+
+
+void setKeyMemoryLocking(bool lock)
+{
+    lockKeys.store(lock, memory_order_relaxed);
+}
+
+
+bool keyMemoryLocking()
+{
+    return lockKeys.load(memory_order_relaxed);
+}
+
+
+static size_t pageRound(size_t bytes)
+{
+    size_t page = static_cast<size_t>( sysconf(_SC_PAGESIZE) );
+    return (bytes + page - 1) / page * page;
+}
+
+
+
+
+/* Function: secureAllocate
+ * Parameters: The size in bytes, whether to lock it, set to whether the lock took
+ * Return: The zeroed allocation, nullptr for 0 bytes
+ * Description: Unlocked storage comes from the aligned operator new. Locked storage is an anonymous mapping of its own, page
+ *              aligned and so cache line aligned, kept out of core dumps and mlocked when the limit allows.
+*/
+void* secureAllocate(size_t bytes, bool lock, bool& locked)
+{
+    locked = false;
+    if(bytes == 0)
+    {
+        return nullptr;
+    }
+
+    if(!lock)
+    {
+        void* data = ::operator new(bytes, align_val_t(SecureArray<uint8_t>::Alignment));
+        memset(data, 0, bytes);
+        return data;
+    }
+
+    size_t length = pageRound(bytes);
+    void* data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(data == MAP_FAILED)
+    {
+        throw bad_alloc();
+    }
+#ifdef MADV_DONTDUMP
+    madvise(data, length, MADV_DONTDUMP);
+#endif
+    locked = mlock(data, length) == 0;
+    return data;
+}
+
+
+size_t secureFootprint(size_t bytes, bool lock)
+{
+    return bytes == 0 ? 0 : lock ? pageRound(bytes) : bytes;
+}
+
+
+void secureFree(void* data, size_t bytes, bool lock)
+{
+    if(data == nullptr)
+    {
+        return;
+    }
+
+    secureZero(data, bytes);
+    if(lock)
+    {
+        munmap(data, pageRound(bytes)); // drops the lock with the mapping
+    }
+    else
+    {
+        ::operator delete(data, align_val_t(SecureArray<uint8_t>::Alignment));
+    }
+}
@@ -0,0 +1,130 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the handling of key material: secureZero, which wipes memory in a way the compiler may not
+ *                  remove as a dead store, and SecureArray, the container every key schedule lives in.
+ *
+ *                  A SecureArray is one 64 byte aligned allocation, so a schedule starts on a cache line and spans as few lines as
+ *                  its size allows. It cannot be copied, so the only copy of a key is the one its owner expanded; moving it hands
+ *                  over the allocation without touching the bytes. It is wiped when it is destroyed or replaced. With locking on, it
+ *                  takes whole pages of its own, which are mlocked so they are never written to swap and left out of core dumps;
+ *                  pages of their own, because a page lock is not counted and unlocking one key must not unlock another. Locking is
+ *                  best effort: past RLIMIT_MEMLOCK the pages are still private and excluded from core dumps, just not locked.
+*/
+
+#ifndef SECURE_MEMORY_H
+#define SECURE_MEMORY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string.h>
+#include <type_traits>
+#include <utility>
+
+using namespace std;
+
+inline void secureZero(void* data, size_t length)
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 25))
+    explicit_bzero(data, length);
+#else
+    volatile uint8_t* bytes = static_cast<volatile uint8_t*>( data );
+    for(size_t i = 0; i < length; i++)
+    {
+        bytes[i] = 0;
+    }
+    atomic_signal_fence(memory_order_seq_cst);
+#endif
+}
+
+
+// whether SecureArrays created from now on lock their memory; off by default, since every locked key costs a page
+void setKeyMemoryLocking(bool);
+bool keyMemoryLocking();
+
+// zeroed, 64 byte aligned storage; with lock, whole mlocked pages. Throws bad_alloc. locked reports whether mlock succeeded.
+void* secureAllocate(size_t bytes, bool lock, bool& locked);
+void secureFree(void* data, size_t bytes, bool lock); // wipes, then frees as it was allocated
+size_t secureFootprint(size_t bytes, bool lock); // what an allocation of bytes takes: bytes, or the whole pages when locked
+
+
+template<typename T>
+class SecureArray
+{
+    static_assert(is_trivially_copyable<T>::value && is_trivially_destructible<T>::value, "key material is plain data");
+    static_assert(alignof(T) <= 64, "SecureArray aligns to a cache line");
+
+    public:
+        static constexpr size_t Alignment = 64;
+
+        SecureArray() : items(nullptr), count(0), lock(false), locked(false) {}
+
+        // count zeroed elements; lock defaults to the process wide setting
+        explicit SecureArray(size_t count, bool lock = keyMemoryLocking()) : items(nullptr), count(count), lock(lock), locked(false)
+        {
+            this->items = static_cast<T*>( secureAllocate(count * sizeof(T), lock, this->locked) );
+        }
+
+        SecureArray(const SecureArray&) = delete;
+        SecureArray& operator=(const SecureArray&) = delete;
+
+        SecureArray(SecureArray&& other) noexcept
+            : items(exchange(other.items, nullptr)), count(exchange(other.count, 0)), lock(other.lock), locked(exchange(other.locked, false))
+        {
+        }
+
+        SecureArray& operator=(SecureArray&& other) noexcept
+        {
+            if(this != &other)
+            {
+                release();
+                this->items = exchange(other.items, nullptr);
+                this->count = exchange(other.count, 0);
+                this->lock = other.lock;
+                this->locked = exchange(other.locked, false);
+            }
+            return *this;
+        }
+
+        ~SecureArray() { release(); }
+
+        T* data() { return this->items; }
+        const T* data() const { return this->items; }
+        size_t size() const { return this->count; }
+        bool empty() const { return this->count == 0; }
+        bool isLocked() const { return this->locked; }
+        size_t footprint() const { return secureFootprint(this->count * sizeof(T), this->lock); } // bytes allocated
+
+        T& operator[](size_t i) { return this->items[i]; }
+        const T& operator[](size_t i) const { return this->items[i]; }
+
+        T* begin() { return this->items; }
+        T* end() { return this->items + this->count; }
+        const T* begin() const { return this->items; }
+        const T* end() const { return this->items + this->count; }
+
+        void wipe() { secureZero(this->items, this->count * sizeof(T)); } // zeroes the contents, keeps the allocation
+
+    private:
+        T* items;
+        size_t count;
+        bool lock; // allocated as locked pages
+        bool locked;
+
+        void release()
+        {
+            if(this->items != nullptr)
+            {
+                secureFree(this->items, this->count * sizeof(T), this->lock);
+                this->items = nullptr;
+                this->count = 0;
+                this->locked = false;
+            }
+        }
+};
+
+
+#endif
@@ -0,0 +1,562 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the ThreadPool workers, deques and CPU topology discovery.
+*/
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+
+// tasks a worker's deque can hold; a push to full deques runs the task on the caller instead
+static const size_t DequeCapacity = 1024;
+
+
+struct alignas(64) ThreadPool::Worker
+{
+    atomic_flag lock; // guards head, tail and ring
+    atomic<size_t> head; // next task to steal
+    atomic<size_t> tail; // one past the next task to pop; both change only under lock, but are peeked without it
+    Task ring[DequeCapacity];
+
+    thread handle;
+    int cpu;
+    int node;
+    vector<unsigned> victims; // steal order: own node first
+    uint64_t startNs;
+
+    atomic<uint64_t> tasks;
+    atomic<uint64_t> steals;
+    atomic<uint64_t> busyNs;
+
+    Worker() : head(0), tail(0), cpu(-1), node(0), startNs(0), tasks(0), steals(0), busyNs(0)
+    {
+        lock.clear();
+    }
+
+    void acquire()
+    {
+        while(lock.test_and_set(memory_order_acquire))
+        {
+            this_thread::yield();
+        }
+    }
+
+    void release()
+    {
+        lock.clear(memory_order_release);
+    }
+};
+
+
+struct ThreadPool::Job
+{
+    void (*call)(const void*, size_t);
+    const void* work;
+    size_t count;
+    atomic<size_t> next;
+    atomic<unsigned> pending; // helper tasks posted and not yet finished
+    atomic<bool> failed;
+    exception_ptr error;
+};
+
+
+// the pool and worker index of the calling thread, so tasks posted from a worker go to its own deque
+static thread_local const ThreadPool* currentPool = nullptr;
+static thread_local int currentWorker = -1;
+
+
+static uint64_t nowNs()
+{
+    return static_cast<uint64_t>( chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count() );
+}
+
+
+
+
+// -------------------------------------- TOPOLOGY --------------------------------------
+
+// CPU numbers in a sysfs list such as "0-3,8-11"
+static vector<int> parseCpuList(const string& text)
+{
+    vector<int> cpus;
+    stringstream stream(text);
+    string range;
+    while(getline(stream, range, ','))
+    {
+        size_t dash = range.find('-');
+        try
+        {
+            int first = stoi(range.substr(0, dash));
+            int last = dash == string::npos ? first : stoi(range.substr(dash + 1));
+            for(int cpu = first; cpu <= last; cpu++)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+        catch(const exception&)
+        {
+        }
+    }
+    return cpus;
+}
+
+
+/* Function: topology
+ * Parameters: None
+ * Return: The CPUs this process may run on as (node, cpu) pairs, sorted by node
+ * Description: Reads the affinity mask and the NUMA node CPU lists from sysfs. Without either, every CPU is placed on node 0.
+*/
+static vector<pair<int, int>> topology()
+{
+    vector<pair<int, int>> cpus;
+
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if(sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+    {
+        vector<int> nodeOf(CPU_SETSIZE, 0);
+        for(int node = 0; node < 1024; node++)
+        {
+            ifstream list("/sys/devices/system/node/node" + to_string(node) + "/cpulist");
+            if(!list)
+            {
+                if(node > 0)
+                {
+                    break;
+                }
+                continue;
+            }
+
+            string text;
+            getline(list, text);
+            for(int cpu : parseCpuList(text))
+            {
+                if(cpu >= 0 && cpu < CPU_SETSIZE)
+                {
+                    nodeOf[cpu] = node;
+                }
+            }
+        }
+
+        for(int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if(CPU_ISSET(cpu, &allowed))
+            {
+                cpus.push_back({nodeOf[cpu], cpu});
+            }
+        }
+    }
+#endif
+
+    if(cpus.empty())
+    {
+        for(unsigned cpu = 0; cpu < max(1u, thread::hardware_concurrency()); cpu++)
+        {
+            cpus.push_back({0, -1});
+        }
+    }
+
+    stable_sort(cpus.begin(), cpus.end(), [](const pair<int, int>& a, const pair<int, int>& b) { return a.first < b.first; });
+    return cpus;
+}
+
+
+
+
+// -------------------------------------- POOL --------------------------------------
+
+/* Function: Constructor
+ * Parameters: The number of workers (0 = one per allowed CPU), whether to pin each worker to its CPU
+ * Return: a ThreadPool object
+ * Description: Worker i takes the i-th allowed CPU in node order, so consecutive workers share a node. Workers are only pinned
+ *              when there are no more of them than CPUs.
+*/
+ThreadPool::ThreadPool(unsigned workers, bool pin) : stopping(false), queued(0), sleepers(0), nextVictim(0)
+{
+    vector<pair<int, int>> cpus = topology();
+    this->workerCount = workers ? workers : static_cast<unsigned>( cpus.size() );
+    this->workers.reset(new Worker[this->workerCount]);
+    pin = pin && this->workerCount <= cpus.size();
+    uint64_t start = nowNs();
+
+    for(unsigned i = 0; i < this->workerCount; i++)
+    {
+        this->workers[i].node = cpus[i % cpus.size()].first;
+        this->workers[i].cpu = pin ? cpus[i].second : -1;
+        this->workers[i].startNs = start;
+    }
+
+    for(unsigned i = 0; i < this->workerCount; i++)
+    {
+        for(int sameNode = 1; sameNode >= 0; sameNode--)
+        {
+            for(unsigned step = 1; step < this->workerCount; step++)
+            {
+                unsigned victim = (i + step) % this->workerCount;
+                if((this->workers[victim].node == this->workers[i].node) == (sameNode == 1))
+                {
+                    this->workers[i].victims.push_back(victim);
+                }
+            }
+        }
+    }
+
+    for(unsigned i = 0; i < this->workerCount; i++)
+    {
+        this->workers[i].handle = thread([this, i]() { workerLoop(i); });
+    }
+}
+
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> guard(this->sleepLock);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+
+    for(unsigned i = 0; i < this->workerCount; i++)
+    {
+        this->workers[i].handle.join();
+    }
+}
+
+
+ThreadPool& ThreadPool::shared()
+{
+    static ThreadPool pool([]()
+    {
+        const char* value = getenv("CRYPTO_THREADS");
+        return value ? static_cast<unsigned>( strtoul(value, nullptr, 10) ) : 0u;
+    }());
+    return pool;
+}
+
+
+unsigned ThreadPool::size() const
+{
+    return this->workerCount;
+}
+
+
+
+
+/* Function: push
+ * Parameters: A task
+ * Return: Whether the task was queued
+ * Description: A worker of this pool pushes onto the back of its own deque. Any other thread spreads its tasks round robin, and
+ *              moves on to the next deque when one is full. A sleeping worker is woken for every task.
+*/
+bool ThreadPool::push(const Task& task)
+{
+    unsigned self = currentPool == this ? static_cast<unsigned>( currentWorker ) : this->nextVictim++;
+
+    for(unsigned attempt = 0; attempt < this->workerCount; attempt++)
+    {
+        Worker& worker = this->workers[(self + attempt) % this->workerCount];
+        worker.acquire();
+        if(worker.tail - worker.head < DequeCapacity)
+        {
+            // counted before it is visible, so the count never drops below the tasks actually queued
+            this->queued++;
+            worker.ring[worker.tail.load(memory_order_relaxed) % DequeCapacity] = task;
+            worker.tail++;
+            worker.release();
+
+            if(this->sleepers.load() > 0)
+            {
+                lock_guard<mutex> guard(this->sleepLock);
+                this->wake.notify_one();
+            }
+            return true;
+        }
+        worker.release();
+    }
+
+    return false;
+}
+
+
+void ThreadPool::submit(Task task)
+{
+    if(!push(task))
+    {
+        task.run(task.argument);
+    }
+}
+
+
+
+
+/* Function: runOne
+ * Parameters: The calling worker's index, or -1 for a thread outside the pool
+ * Return: Whether a task was run
+ * Description: Pops the newest task of the worker's own deque, which is the one most likely still in its cache, or else steals
+ *              the oldest task of another deque, trying the victims on the same node first.
+*/
+bool ThreadPool::runOne(int self)
+{
+    Task task = {nullptr, nullptr};
+    bool stolen = false;
+
+    if(self >= 0)
+    {
+        Worker& own = this->workers[self];
+        own.acquire();
+        if(own.tail != own.head)
+        {
+            own.tail--;
+            task = own.ring[own.tail.load(memory_order_relaxed) % DequeCapacity];
+        }
+        own.release();
+    }
+
+    for(unsigned n = 0; task.run == nullptr && n + (self >= 0 ? 1 : 0) < this->workerCount; n++)
+    {
+        unsigned index = self >= 0 ? this->workers[self].victims[n] : (this->nextVictim.load(memory_order_relaxed) + n) % this->workerCount;
+        Worker& victim = this->workers[index];
+        if(victim.tail == victim.head) // unlocked peek; a stale answer only skips or retries a victim
+        {
+            continue;
+        }
+
+        victim.acquire();
+        if(victim.tail != victim.head)
+        {
+            task = victim.ring[victim.head.load(memory_order_relaxed) % DequeCapacity];
+            victim.head++;
+            stolen = true;
+        }
+        victim.release();
+    }
+
+    if(task.run == nullptr)
+    {
+        return false;
+    }
+    this->queued--;
+
+    if(self < 0)
+    {
+        task.run(task.argument);
+        return true;
+    }
+
+    Worker& worker = this->workers[self];
+    uint64_t start = nowNs();
+    task.run(task.argument);
+    worker.busyNs.fetch_add(nowNs() - start, memory_order_relaxed);
+    worker.tasks.fetch_add(1, memory_order_relaxed);
+    if(stolen)
+    {
+        worker.steals.fetch_add(1, memory_order_relaxed);
+    }
+    return true;
+}
+
+
+void ThreadPool::workerLoop(unsigned index)
+{
+    Worker& worker = this->workers[index];
+    currentPool = this;
+    currentWorker = static_cast<int>( index );
+
+#ifdef __linux__
+    if(worker.cpu >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(worker.cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
+
+    while(true)
+    {
+        if(runOne(static_cast<int>( index )))
+        {
+            continue;
+        }
+
+        // a short spin catches the next task of a fork-join burst without a trip through the kernel
+        bool found = false;
+        for(int spin = 0; spin < 64 && !found; spin++)
+        {
+            this_thread::yield();
+            found = this->queued.load() > 0;
+        }
+        if(found)
+        {
+            continue;
+        }
+
+        unique_lock<mutex> guard(this->sleepLock);
+        this->sleepers++;
+        this->wake.wait(guard, [this]() { return this->stopping.load() || this->queued.load() > 0; });
+        this->sleepers--;
+
+        if(this->stopping.load() && this->queued.load() == 0)
+        {
+            return;
+        }
+    }
+}
+
+
+
+
+// -------------------------------------- FORK-JOIN --------------------------------------
+
+void ThreadPool::drain(Job& job)
+{
+    try
+    {
+        for(size_t i = job.next++; i < job.count; i = job.next++)
+        {
+            job.call(job.work, i);
+        }
+    }
+    catch(...)
+    {
+        if(!job.failed.exchange(true))
+        {
+            job.error = current_exception();
+        }
+        job.next = job.count;
+    }
+}
+
+
+void ThreadPool::runHelper(void* argument)
+{
+    Job& job = *static_cast<Job*>( argument );
+    drain(job);
+    job.pending.fetch_sub(1, memory_order_release);
+}
+
+
+/* Function: forkJoin
+ * Parameters: The item count, the thread limit, the type-erased work and its context
+ * Return: None
+ * Description: Posts threads - 1 helper tasks for a Job on this stack frame and drains the items alongside them. The frame
+ *              can only return once every helper has finished, so until then the caller runs queued tasks, its own unstarted
+ *              helpers among them.
+*/
+void ThreadPool::forkJoin(size_t count, unsigned threads, void (*call)(const void*, size_t), const void* work)
+{
+    if(threads == 0)
+    {
+        threads = max(1u, this->workerCount);
+    }
+    threads = static_cast<unsigned>( min<size_t>(threads, count) );
+
+    if(threads <= 1 || this->workerCount == 0)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            call(work, i);
+        }
+        return;
+    }
+
+    Job job;
+    job.call = call;
+    job.work = work;
+    job.count = count;
+    job.next = 0;
+    job.pending = 0;
+    job.failed = false;
+
+    for(unsigned t = 1; t < threads; t++)
+    {
+        job.pending++;
+        if(!push(Task{&ThreadPool::runHelper, &job}))
+        {
+            job.pending--;
+            break;
+        }
+    }
+
+    drain(job);
+
+    int self = currentPool == this ? currentWorker : -1;
+    while(job.pending.load(memory_order_acquire) > 0)
+    {
+        if(!runOne(self))
+        {
+            this_thread::yield();
+        }
+    }
+
+    if(job.failed)
+    {
+        rethrow_exception(job.error);
+    }
+}
+
+
+
+
+// -------------------------------------- STATISTICS --------------------------------------
+
+vector<ThreadPoolWorkerStats> ThreadPool::stats() const
+{
+    vector<ThreadPoolWorkerStats> all;
+    uint64_t now = nowNs();
+
+    for(unsigned i = 0; i < this->workerCount; i++)
+    {
+        const Worker& worker = this->workers[i];
+        ThreadPoolWorkerStats s;
+        s.cpu = worker.cpu;
+        s.node = worker.node;
+        s.tasks = worker.tasks.load(memory_order_relaxed);
+        s.steals = worker.steals.load(memory_order_relaxed);
+        s.busyNs = worker.busyNs.load(memory_order_relaxed);
+        s.uptimeNs = now - worker.startNs;
+        s.utilization = s.uptimeNs ? static_cast<double>( s.busyNs ) / s.uptimeNs : 0.0;
+        all.push_back(s);
+    }
+
+    return all;
+}
+
+
+double ThreadPool::utilization() const
+{
+    uint64_t busy = 0;
+    uint64_t uptime = 0;
+    for(const ThreadPoolWorkerStats& s : stats())
+    {
+        busy += s.busyNs;
+        uptime += s.uptimeNs;
+    }
+    return uptime ? static_cast<double>( busy ) / uptime : 0.0;
+}
+
+
+uint64_t ThreadPool::steals() const
+{
+    uint64_t total = 0;
+    for(unsigned i = 0; i < this->workerCount; i++)
+    {
+        total += this->workers[i].steals.load(memory_order_relaxed);
+    }
+    return total;
+}
@@ -0,0 +1,99 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains ThreadPool, the work-stealing scheduler that every parallel path in the libraries (batch
+ *                  record sealing, parallel CTR and XTS, file hashing, Merkle trees, PBKDF2, the hash attack driver) submits to,
+ *                  so that nesting or running several of them at once never starts more threads than there are cores.
+ *
+ *                  Each worker owns a fixed size deque of tasks. A worker pushes and pops at the back of its own deque and,
+ *                  when that is empty, steals from the front of the others: first those on its own NUMA node, then the rest.
+ *                  Workers are pinned one per allowed CPU, taken node by node, and sleep when no deque has a task.
+ *
+ *                  parallelFor is fork-join. The caller takes part and posts one helper task per extra thread; helpers and caller
+ *                  claim items from a shared counter. While waiting for its helpers the caller runs queued tasks itself, so
+ *                  nested calls from inside a task can not deadlock. A task is a function pointer and an argument, and the
+ *                  deques are preallocated, so a parallelFor makes no heap allocations.
+*/
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+struct ThreadPoolWorkerStats
+{
+    int cpu; // the CPU the worker is pinned to, or -1
+    int node; // its NUMA node
+    uint64_t tasks; // tasks run
+    uint64_t steals; // tasks taken from another worker's deque
+    uint64_t busyNs; // time spent running tasks
+    uint64_t uptimeNs; // time since the worker started
+    double utilization; // busyNs / uptimeNs
+};
+
+class ThreadPool
+{
+    public:
+        struct Task
+        {
+            void (*run)(void*);
+            void* argument;
+        };
+
+        explicit ThreadPool(unsigned workers = 0, bool pin = true); // 0 = one worker per allowed CPU
+        ~ThreadPool();
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // the process-wide pool the libraries use; the CRYPTO_THREADS environment variable overrides its size
+        static ThreadPool& shared();
+
+        unsigned size() const;
+        void submit(Task); // run a task on some worker; the caller keeps argument alive until it has run
+
+        // work(i) for every i below count on up to threads threads including the caller (0 = one per worker). The first
+        // exception thrown by work stops the remaining items and is rethrown here.
+        template<typename Work>
+        void parallelFor(size_t count, unsigned threads, const Work& work)
+        {
+            forkJoin(count, threads, [](const void* context, size_t i) { (*static_cast<const Work*>( context ))(i); }, &work);
+        }
+
+        vector<ThreadPoolWorkerStats> stats() const;
+        double utilization() const; // over all workers
+        uint64_t steals() const;
+
+    private:
+        struct Worker;
+        struct Job;
+
+        unique_ptr<Worker[]> workers;
+        unsigned workerCount;
+        atomic<bool> stopping;
+        atomic<size_t> queued; // tasks in all deques
+        atomic<unsigned> sleepers;
+        atomic<unsigned> nextVictim; // round robin target for tasks posted from outside the pool
+        mutex sleepLock;
+        condition_variable wake;
+
+        void forkJoin(size_t, unsigned, void (*)(const void*, size_t), const void*);
+        bool push(const Task&);
+        bool runOne(int);
+        void workerLoop(unsigned);
+        static void drain(Job&);
+        static void runHelper(void*);
+};
+
+#endif
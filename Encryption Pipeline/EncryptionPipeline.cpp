@@ -0,0 +1,409 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the EncryptionPipeline stages and method definitions.
+*/
+
+#include "EncryptionPipeline.h"
+#include "../Advanced Encryption Standard (AES)/AESModes.h"
+#include "../Common/Coroutines.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <unistd.h>
+
+
+enum Stage { Read, Encrypt, Mac, Write, StageCount };
+
+static const char* const StageNames[StageCount] = {"read", "encrypt", "mac", "write"};
+
+
+static uint64_t nowNs()
+{
+    return static_cast<uint64_t>( chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count() );
+}
+
+
+struct Chunk
+{
+    uint64_t index;
+    size_t length;
+    uint8_t* data;
+};
+
+
+// The state of one encrypt call, shared by all the stage coroutines
+struct PipelineRun
+{
+    const AESEngine& engine;
+    const HMACSHA1& mac;
+    const PipelineOptions& options;
+    int in;
+    int out;
+    const uint8_t* iv;
+    uint64_t outOffset;
+
+    Channel<Chunk*> free;
+    Channel<Chunk*> toEncrypt;
+    Channel<Chunk*> toMac;
+    Channel<Chunk*> toWrite;
+
+    atomic<uint64_t> nextRead{0};
+    atomic<unsigned> readersLeft;
+    atomic<unsigned> encryptorsLeft;
+    atomic<bool> failed{false};
+    atomic<uint64_t> bytes[StageCount] = {};
+    atomic<uint64_t> busyNs[StageCount] = {};
+    uint8_t tag[HMACSHA1::DigestSize] = {};
+
+    PipelineRun(const AESEngine& engine, const HMACSHA1& mac, const PipelineOptions& options, int in, int out, const uint8_t* iv,
+                uint64_t outOffset, size_t buffers)
+        : engine(engine), mac(mac), options(options), in(in), out(out), iv(iv), outOffset(outOffset), free(buffers),
+          toEncrypt(options.queueDepth), toMac(options.queueDepth), toWrite(options.queueDepth), readersLeft(options.readers),
+          encryptorsLeft(options.encryptors)
+    {
+    }
+
+    // after an error every stage stops at its next channel operation
+    void abort()
+    {
+        this->failed = true;
+        this->free.close();
+        this->toEncrypt.close();
+        this->toMac.close();
+        this->toWrite.close();
+    }
+
+    void busy(Stage stage, uint64_t start, size_t length)
+    {
+        this->busyNs[stage] += nowNs() - start;
+        this->bytes[stage] += length;
+    }
+};
+
+
+
+
+// -------------------------------------- STAGES --------------------------------------
+
+/* Function: readStage
+ * Parameters: The run
+ * Return: The coroutine
+ * Description: Takes a free buffer before it claims the next chunk number, so a claimed chunk always has somewhere to go. A
+ *              short read is the end of the file; the last reader to stop closes the channel to the encryptors.
+*/
+static CoTask readStage(PipelineRun& run)
+{
+    try
+    {
+        while(!run.failed)
+        {
+            optional<Chunk*> buffer = co_await run.free.pop();
+            if(!buffer)
+            {
+                break;
+            }
+
+            Chunk* chunk = *buffer;
+            uint64_t start = nowNs();
+            chunk->index = run.nextRead++;
+            off_t offset = static_cast<off_t>( chunk->index * run.options.chunkSize );
+            chunk->length = 0;
+            while(chunk->length < run.options.chunkSize)
+            {
+                ssize_t n = pread(run.in, chunk->data + chunk->length, run.options.chunkSize - chunk->length, offset + static_cast<off_t>( chunk->length ));
+                if(n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if(n < 0)
+                {
+                    throw runtime_error(string("pipeline read failed: ") + strerror(errno));
+                }
+                if(n == 0)
+                {
+                    break;
+                }
+                chunk->length += static_cast<size_t>( n );
+            }
+            run.busy(Read, start, chunk->length);
+
+            if(chunk->length == 0)
+            {
+                co_await run.free.push(chunk);
+                break;
+            }
+            if(!co_await run.toEncrypt.push(chunk) || chunk->length < run.options.chunkSize)
+            {
+                break;
+            }
+        }
+    }
+    catch(...)
+    {
+        run.abort();
+        throw;
+    }
+
+    if(--run.readersLeft == 0)
+    {
+        run.toEncrypt.close();
+    }
+}
+
+
+/* Function: encryptStage
+ * Parameters: The run
+ * Return: The coroutine
+ * Description: Chunk i starts at counter iv + i * chunkSize / 16, so the chunks are independent and any worker can take any
+ *              of them
+*/
+static CoTask encryptStage(PipelineRun& run)
+{
+    try
+    {
+        while(optional<Chunk*> next = co_await run.toEncrypt.pop())
+        {
+            if(run.failed)
+            {
+                break;
+            }
+
+            Chunk* chunk = *next;
+            uint64_t start = nowNs();
+            uint8_t counter[16];
+            uint64_t carry = chunk->index * (run.options.chunkSize / 16);
+            for(int i = 15; i >= 0; i--)
+            {
+                uint64_t sum = run.iv[i] + (carry & 0xFF);
+                counter[i] = static_cast<uint8_t>( sum );
+                carry = (carry >> 8) + (sum >> 8);
+            }
+            aesCtrCrypt(run.engine, counter, chunk->data, chunk->data, chunk->length, 1);
+            run.busy(Encrypt, start, chunk->length);
+
+            if(!co_await run.toMac.push(chunk))
+            {
+                break;
+            }
+        }
+    }
+    catch(...)
+    {
+        run.abort();
+        throw;
+    }
+
+    if(--run.encryptorsLeft == 0)
+    {
+        run.toMac.close();
+    }
+}
+
+
+/* Function: macStage
+ * Parameters: The run
+ * Return: The coroutine
+ * Description: The inner hash continues from the HMAC midstate over iv and then the chunks in order; chunks that arrive early
+ *              wait in a map. The tag is only set when every chunk up to the end of the file was hashed.
+*/
+static CoTask macStage(PipelineRun& run)
+{
+    try
+    {
+        SHA1 inner;
+        inner.restore(run.mac.innerState(), SHA1::BlockSize);
+        inner.update(run.iv, 16);
+
+        map<uint64_t, Chunk*> early;
+        uint64_t next = 0;
+        bool stopped = false;
+        while(!stopped)
+        {
+            optional<Chunk*> arrived = co_await run.toMac.pop();
+            if(!arrived || run.failed)
+            {
+                break;
+            }
+            early[(*arrived)->index] = *arrived;
+
+            for(auto found = early.find(next); found != early.end() && !stopped; found = early.find(next))
+            {
+                Chunk* chunk = found->second;
+                early.erase(found);
+                next++;
+
+                uint64_t start = nowNs();
+                inner.update(chunk->data, chunk->length);
+                run.busy(Mac, start, chunk->length);
+                stopped = !co_await run.toWrite.push(chunk);
+            }
+        }
+
+        if(!run.failed && early.empty())
+        {
+            uint8_t digest[SHA1::DigestSize];
+            inner.finalize(digest);
+            SHA1 outer;
+            outer.restore(run.mac.outerState(), SHA1::BlockSize);
+            outer.update(digest, sizeof(digest));
+            outer.finalize(run.tag);
+        }
+    }
+    catch(...)
+    {
+        run.abort();
+        throw;
+    }
+
+    run.toWrite.close();
+}
+
+
+static CoTask writeStage(PipelineRun& run)
+{
+    try
+    {
+        while(optional<Chunk*> next = co_await run.toWrite.pop())
+        {
+            if(run.failed)
+            {
+                break;
+            }
+
+            Chunk* chunk = *next;
+            uint64_t start = nowNs();
+            off_t offset = static_cast<off_t>( run.outOffset + chunk->index * run.options.chunkSize );
+            for(size_t written = 0; written < chunk->length; )
+            {
+                ssize_t n = pwrite(run.out, chunk->data + written, chunk->length - written, offset + static_cast<off_t>( written ));
+                if(n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if(n <= 0)
+                {
+                    throw runtime_error(string("pipeline write failed: ") + strerror(errno));
+                }
+                written += static_cast<size_t>( n );
+            }
+            run.busy(Write, start, chunk->length);
+
+            co_await run.free.push(chunk);
+        }
+    }
+    catch(...)
+    {
+        run.abort();
+        throw;
+    }
+}
+
+
+
+
+// the free channel holds every buffer, so this never suspends
+static CoTask releaseBuffer(PipelineRun& run, Chunk* chunk)
+{
+    co_await run.free.push(chunk);
+}
+
+
+
+
+// -------------------------------------- PIPELINE --------------------------------------
+
+EncryptionPipeline::EncryptionPipeline(const uint8_t* encryptionKey, size_t keyLength, const uint8_t* macKey, size_t macKeyLength, PipelineOptions options)
+    : engine(encryptionKey, keyLength), mac(macKey, macKeyLength), options(options)
+{
+    if(options.chunkSize == 0 || options.chunkSize % 16 != 0)
+    {
+        throw invalid_argument("EncryptionPipeline: the chunk size must be a non-zero multiple of 16 bytes");
+    }
+    if(options.queueDepth == 0 || options.readers == 0 || options.encryptors == 0 || options.writers == 0)
+    {
+        throw invalid_argument("EncryptionPipeline: every stage needs a queue and at least one worker");
+    }
+}
+
+
+/* Function: encrypt
+ * Parameters: The input and output files, the iv, where the ciphertext starts in the output
+ * Return: The tag, the byte count and the stage statistics
+ * Description: Allocates the buffers once, fills the free channel with them and spawns every worker of every stage into one
+ *              group on the shared pool, then waits for the group
+*/
+PipelineResult EncryptionPipeline::encrypt(int in, int out, const uint8_t* iv, uint64_t outOffset) const
+{
+    const PipelineOptions& o = this->options;
+    size_t buffers = 3 * o.queueDepth + o.readers + o.encryptors + o.writers + 1;
+    unique_ptr<uint8_t[]> storage(new uint8_t[buffers * o.chunkSize]);
+    vector<Chunk> chunks(buffers);
+
+    PipelineRun run(this->engine, this->mac, o, in, out, iv, outOffset, buffers);
+    CoGroup group;
+    auto started = chrono::steady_clock::now();
+    for(size_t b = 0; b < buffers; b++)
+    {
+        chunks[b] = Chunk{0, 0, storage.get() + b * o.chunkSize};
+        group.spawn(releaseBuffer(run, &chunks[b]));
+    }
+    group.wait();
+
+    for(unsigned w = 0; w < o.readers; w++)
+    {
+        group.spawn(readStage(run));
+    }
+    for(unsigned w = 0; w < o.encryptors; w++)
+    {
+        group.spawn(encryptStage(run));
+    }
+    group.spawn(macStage(run));
+    for(unsigned w = 0; w < o.writers; w++)
+    {
+        group.spawn(writeStage(run));
+    }
+    group.wait();
+
+    PipelineResult result;
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    result.bytes = run.bytes[Mac];
+    memcpy(result.tag, run.tag, sizeof(result.tag));
+
+    const unsigned workers[StageCount] = {o.readers, o.encryptors, 1, o.writers};
+    const Channel<Chunk*>* inputs[StageCount] = {&run.free, &run.toEncrypt, &run.toMac, &run.toWrite};
+    const Channel<Chunk*>* outputs[StageCount] = {&run.toEncrypt, &run.toMac, &run.toWrite, &run.free};
+    for(int s = 0; s < StageCount; s++)
+    {
+        result.stages.push_back(PipelineStageStats{StageNames[s], workers[s], run.bytes[s], run.busyNs[s], inputs[s]->consumerWaits(),
+                                                   outputs[s]->producerWaits()});
+    }
+    return result;
+}
+
+
+void PipelineResult::report(ostream& out) const
+{
+    ios_base::fmtflags flags = out.flags();
+    out << left << setw(10) << "stage" << right << setw(8) << "workers" << setw(12) << "MB/s busy" << setw(12) << "busy %"
+        << setw(14) << "input waits" << setw(14) << "output waits" << endl;
+
+    for(const PipelineStageStats& stage : this->stages)
+    {
+        double busySeconds = static_cast<double>( stage.busyNs ) / 1e9;
+        double rate = busySeconds > 0 ? static_cast<double>( stage.bytes ) / busySeconds / 1e6 : 0.0;
+        double utilization = this->seconds > 0 ? 100.0 * busySeconds / (this->seconds * stage.workers) : 0.0;
+        out << left << setw(10) << stage.name << right << setw(8) << stage.workers << fixed << setprecision(1) << setw(12) << rate
+            << setw(12) << utilization << setw(14) << stage.inputWaits << setw(14) << stage.outputWaits << endl;
+    }
+    out << "total: " << this->bytes << " bytes in " << setprecision(3) << this->seconds << " s, "
+        << setprecision(1) << (this->seconds > 0 ? static_cast<double>( this->bytes ) / this->seconds / 1e6 : 0.0) << " MB/s" << endl;
+    out.flags(flags);
+}
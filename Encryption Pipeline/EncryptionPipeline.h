@@ -0,0 +1,84 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains EncryptionPipeline, the streaming file encryptor for large transfers. A file goes through
+ *                  four stages of C++20 coroutines (Coroutines.h) joined by bounded channels, so reading, encrypting,
+ *                  authenticating and writing overlap:
+ *
+ *                    read      pread a chunk into a free buffer                        readers workers
+ *                    encrypt   AES-CTR in place, counter = iv + chunk offset / 16      encryptors workers
+ *                    mac       HMAC-SHA1 over iv | ciphertext, in chunk order          one worker, the chain is serial
+ *                    write     pwrite the chunk at its offset, return the buffer       writers workers
+ *
+ *                  Every chunk lives in one of a fixed set of buffers for its whole trip and is never copied. A stage that
+ *                  falls behind fills the channel in front of it, the stages before it suspend on their pushes, and the reader
+ *                  finally waits for a free buffer: that is the backpressure, and it bounds memory at
+ *                  (3 * queueDepth + workers) chunks. Workers of the parallel stages finish chunks out of order; the mac stage
+ *                  puts them back in order before they are hashed.
+ *
+ *                  Each stage reports its busy time next to the waits on its input (starved) and output (held back), and the
+ *                  busy time over the run time shows which stage is the bottleneck.
+*/
+
+#ifndef ENCRYPTION_PIPELINE_H
+#define ENCRYPTION_PIPELINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../Advanced Encryption Standard (AES)/AESEngine.h"
+#include "../Secure Hash Algorithm 1 (SHA1)/HMACSHA1.h"
+
+using namespace std;
+
+struct PipelineOptions
+{
+    size_t chunkSize = 1 << 20; // bytes per chunk, a multiple of 16
+    size_t queueDepth = 4; // chunks each channel between two stages holds
+    unsigned readers = 1;
+    unsigned encryptors = 1;
+    unsigned writers = 1;
+};
+
+struct PipelineStageStats
+{
+    string name;
+    unsigned workers;
+    uint64_t bytes;
+    uint64_t busyNs; // summed over the workers
+    uint64_t inputWaits; // pops that found the channel in front empty
+    uint64_t outputWaits; // pushes that found the channel behind full
+};
+
+struct PipelineResult
+{
+    uint64_t bytes;
+    uint8_t tag[HMACSHA1::DigestSize];
+    double seconds;
+    vector<PipelineStageStats> stages; // read, encrypt, mac, write
+
+    // per stage: MB/s while busy, utilization of its workers over the run, and the waits
+    void report(ostream&) const;
+};
+
+class EncryptionPipeline
+{
+    public:
+        EncryptionPipeline(const uint8_t* encryptionKey, size_t keyLength, const uint8_t* macKey, size_t macKeyLength, PipelineOptions = {});
+
+        // Encrypts the regular file in with AES-CTR from the 16 byte iv and writes the ciphertext to out, starting at outOffset.
+        // The tag is HMAC-SHA1(macKey, iv | ciphertext). Throws invalid_argument on bad options and runtime_error on I/O errors.
+        PipelineResult encrypt(int in, int out, const uint8_t* iv, uint64_t outOffset = 0) const;
+
+    private:
+        AESEngine engine;
+        HMACSHA1 mac;
+        PipelineOptions options;
+};
+
+#endif
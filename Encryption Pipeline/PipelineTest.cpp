@@ -0,0 +1,158 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This program tests EncryptionPipeline against the one-shot primitives. It writes a pseudo random file of a few
+ *                  MiB and an odd tail to /tmp, encrypts it with a range of chunk sizes, queue depths and worker counts, and
+ *                  checks every output file against aesCtrCrypt over the whole plaintext and HMACSHA1::mac over iv | ciphertext.
+ *                  The small chunks and shallow queues make the stages wait on each other and the workers finish out of order,
+ *                  which is the part of the pipeline worth testing. Each run prints its stage report.
+ *
+ * Compilation:     cmake -S . -B build && cmake --build build --target crypto_pipeline_test        (from the repository root)
+ *
+ * Usage:           ./crypto_pipeline_test [--size=<bytes>]
+*/
+
+#include "EncryptionPipeline.h"
+#include "../Advanced Encryption Standard (AES)/AESModes.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <random>
+#include <unistd.h>
+
+using namespace std;
+
+static const uint8_t EncryptionKey[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+static const uint8_t MacKey[20] = {0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b};
+
+// an iv near the top of the low 64 bits, so the counters of later chunks carry into the high half
+static const uint8_t Iv[16] = {0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0x00};
+
+
+static bool writeFile(const string& path, const vector<uint8_t>& data)
+{
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    bool written = fd >= 0 && write(fd, data.data(), data.size()) == static_cast<ssize_t>( data.size() );
+    return close(fd) == 0 && written;
+}
+
+
+static vector<uint8_t> readFile(const string& path, size_t length)
+{
+    vector<uint8_t> data(length + 1);
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    ssize_t n = fd < 0 ? -1 : pread(fd, data.data(), data.size(), 0);
+    close(fd);
+    data.resize(n < 0 ? 0 : static_cast<size_t>( n ));
+    return data;
+}
+
+
+int main(int argc, char** argv)
+{
+    size_t size = (6 << 20) + 12345;
+
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        auto value = [&](const string& flag) { return arg.substr(flag.length()); };
+
+        try
+        {
+            if(arg.rfind("--size=", 0) == 0) size = stoul(value("--size="));
+            else
+            {
+                cerr << "unknown option " << arg << endl;
+                return 1;
+            }
+        }
+        catch(const exception&)
+        {
+            cerr << "bad value in " << arg << endl;
+            return 1;
+        }
+    }
+
+    vector<uint8_t> plaintext(size);
+    mt19937_64 random(1);
+    for(uint8_t& byte : plaintext)
+    {
+        byte = static_cast<uint8_t>( random() );
+    }
+
+    // the reference: one counter mode pass and one HMAC over iv | ciphertext
+    AESEngine engine(EncryptionKey, sizeof(EncryptionKey));
+    vector<uint8_t> expected(sizeof(Iv) + size);
+    memcpy(expected.data(), Iv, sizeof(Iv));
+    aesCtrCrypt(engine, Iv, plaintext.data(), expected.data() + sizeof(Iv), size, 1);
+    uint8_t expectedTag[HMACSHA1::DigestSize];
+    HMACSHA1(MacKey, sizeof(MacKey)).mac(expected.data(), expected.size(), expectedTag);
+
+    string inPath = "/tmp/crypto_pipeline_test." + to_string(getpid()) + ".in";
+    string outPath = "/tmp/crypto_pipeline_test." + to_string(getpid()) + ".out";
+    if(!writeFile(inPath, plaintext))
+    {
+        cerr << "cannot write " << inPath << endl;
+        return 1;
+    }
+
+    const PipelineOptions runs[] = {
+        {1 << 20, 4, 1, 1, 1},
+        {1 << 16, 4, 1, 4, 1},
+        {1 << 16, 1, 2, 4, 2},
+        {4096, 2, 3, 3, 3},
+        {size / 16 * 16 + 16, 4, 2, 2, 2}, // one chunk for the whole file
+    };
+
+    int verified = 0;
+    int total = 0;
+    for(const PipelineOptions& options : runs)
+    {
+        total++;
+        cout << "chunk " << options.chunkSize << ", depth " << options.queueDepth << ", readers " << options.readers
+             << ", encryptors " << options.encryptors << ", writers " << options.writers << endl;
+
+        try
+        {
+            int in = open(inPath.c_str(), O_RDONLY | O_CLOEXEC);
+            int out = open(outPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+            EncryptionPipeline pipeline(EncryptionKey, sizeof(EncryptionKey), MacKey, sizeof(MacKey), options);
+            PipelineResult result = pipeline.encrypt(in, out, Iv, sizeof(Iv));
+            bool ivWritten = pwrite(out, Iv, sizeof(Iv), 0) == static_cast<ssize_t>( sizeof(Iv) );
+            close(in);
+            close(out);
+
+            result.report(cout);
+            bool matches = ivWritten && result.bytes == size && readFile(outPath, expected.size()) == expected &&
+                           memcmp(result.tag, expectedTag, sizeof(expectedTag)) == 0;
+            cout << (matches ? "matches" : "DOES NOT MATCH") << endl << endl;
+            verified += matches ? 1 : 0;
+        }
+        catch(const exception& error)
+        {
+            cout << error.what() << endl << endl;
+        }
+    }
+
+    // bad options are rejected before anything runs
+    total++;
+    try
+    {
+        EncryptionPipeline(EncryptionKey, sizeof(EncryptionKey), MacKey, sizeof(MacKey), PipelineOptions{1000, 4, 1, 1, 1});
+        cout << "chunk size 1000: NOT rejected" << endl;
+    }
+    catch(const invalid_argument&)
+    {
+        cout << "chunk size 1000: rejected" << endl;
+        verified++;
+    }
+
+    unlink(inPath.c_str());
+    unlink(outPath.c_str());
+
+    cout << "verified: " << verified << " of " << total << " runs" << endl;
+    return verified == total ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This program encrypts one large file with EncryptionPipeline and prints the per stage report to standard
+ *                  error. The output file is iv (16) | ciphertext | tag (20), the tag being HMAC-SHA1 over iv | ciphertext, and
+ *                  the iv is fresh from /dev/urandom. The key file holds the encryption key followed by the MAC key, raw, 32, 48
+ *                  or 64 bytes in all.
+ *
+ * Compilation:     cmake -S . -B build && cmake --build build --target crypto_pipeline        (from the repository root)
+ *
+ * Usage:           ./crypto_pipeline --in=<path> --out=<path> --key-file=<path> [options]
+ *                      --chunk=<bytes>     chunk size, a multiple of 16 (default 1048576)
+ *                      --depth=<n>         chunks queued between two stages (default 4)
+ *                      --readers=<n>       read workers (default 1)
+ *                      --encryptors=<n>    encrypt workers (default 1)
+ *                      --writers=<n>       write workers (default 1)
+*/
+
+#include "EncryptionPipeline.h"
+#include "../Common/SecureMemory.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <unistd.h>
+
+using namespace std;
+
+int main(int argc, char** argv)
+{
+    string inPath;
+    string outPath;
+    string keyPath;
+    PipelineOptions options;
+
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        auto value = [&](const string& flag) { return arg.substr(flag.length()); };
+
+        try
+        {
+            if(arg.rfind("--in=", 0) == 0) inPath = value("--in=");
+            else if(arg.rfind("--out=", 0) == 0) outPath = value("--out=");
+            else if(arg.rfind("--key-file=", 0) == 0) keyPath = value("--key-file=");
+            else if(arg.rfind("--chunk=", 0) == 0) options.chunkSize = stoul(value("--chunk="));
+            else if(arg.rfind("--depth=", 0) == 0) options.queueDepth = stoul(value("--depth="));
+            else if(arg.rfind("--readers=", 0) == 0) options.readers = static_cast<unsigned>( stoul(value("--readers=")) );
+            else if(arg.rfind("--encryptors=", 0) == 0) options.encryptors = static_cast<unsigned>( stoul(value("--encryptors=")) );
+            else if(arg.rfind("--writers=", 0) == 0) options.writers = static_cast<unsigned>( stoul(value("--writers=")) );
+            else
+            {
+                cerr << "unknown option " << arg << endl;
+                return 1;
+            }
+        }
+        catch(const exception&)
+        {
+            cerr << "bad value in " << arg << endl;
+            return 1;
+        }
+    }
+
+    if(inPath.empty() || outPath.empty() || keyPath.empty())
+    {
+        cerr << "usage: crypto_pipeline --in=<path> --out=<path> --key-file=<path> [--chunk=<bytes>] [--depth=<n>] "
+             << "[--readers=<n>] [--encryptors=<n>] [--writers=<n>]" << endl;
+        return 1;
+    }
+
+    ifstream keyFile(keyPath, ios::binary);
+    if(!keyFile)
+    {
+        cerr << "cannot open " << keyPath << endl;
+        return 1;
+    }
+    vector<uint8_t> keys((istreambuf_iterator<char>(keyFile)), istreambuf_iterator<char>());
+    if(keys.size() != 32 && keys.size() != 48 && keys.size() != 64)
+    {
+        secureZero(keys.data(), keys.size());
+        cerr << "the key file must hold two keys of 16, 24 or 32 bytes" << endl;
+        return 1;
+    }
+
+    int in = open(inPath.c_str(), O_RDONLY | O_CLOEXEC);
+    int out = open(outPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if(in < 0 || out < 0)
+    {
+        secureZero(keys.data(), keys.size());
+        cerr << "cannot open " << (in < 0 ? inPath : outPath) << ": " << strerror(errno) << endl;
+        return 1;
+    }
+
+    int status = 0;
+    try
+    {
+        EncryptionPipeline pipeline(keys.data(), keys.size() / 2, keys.data() + keys.size() / 2, keys.size() / 2, options);
+        secureZero(keys.data(), keys.size());
+
+        uint8_t iv[16];
+        ifstream urandom("/dev/urandom", ios::binary);
+        if(!urandom.read(reinterpret_cast<char*>( iv ), sizeof(iv)))
+        {
+            throw runtime_error("cannot read /dev/urandom");
+        }
+
+        PipelineResult result = pipeline.encrypt(in, out, iv, sizeof(iv));
+        if(pwrite(out, iv, sizeof(iv), 0) != static_cast<ssize_t>( sizeof(iv) ) ||
+           pwrite(out, result.tag, sizeof(result.tag), static_cast<off_t>( sizeof(iv) + result.bytes )) != static_cast<ssize_t>( sizeof(result.tag) ))
+        {
+            throw runtime_error(string("cannot write ") + outPath + ": " + strerror(errno));
+        }
+        result.report(cerr);
+    }
+    catch(const exception& error)
+    {
+        secureZero(keys.data(), keys.size());
+        cerr << error.what() << endl;
+        status = 1;
+    }
+
+    close(in);
+    if(close(out) != 0 && status == 0)
+    {
+        cerr << "cannot write " << outPath << ": " << strerror(errno) << endl;
+        status = 1;
+    }
+    return status;
+}
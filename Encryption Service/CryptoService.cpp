@@ -0,0 +1,668 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the CryptoService method definitions.
+*/
+
+#include "CryptoService.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../Secure Hash Algorithm 1 (SHA1)/SHA1.h"
+#include "../Common/Parallel.h"
+#include "../Common/PerfCounters.h"
+
+
+// iovecs per sendmsg, below the IOV_MAX of 1024 Linux has
+static const size_t MaxIovecs = 1024;
+
+// the receive buffer of a connection starts at this size and doubles when a request does not fit
+static const size_t ReceiveBytes = 64 * 1024;
+
+
+static uint64_t nowNs()
+{
+    return static_cast<uint64_t>( chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count() );
+}
+
+
+static runtime_error socketError(const string& what, const string& path)
+{
+    return runtime_error(what + " " + path + ": " + strerror(errno));
+}
+
+
+struct CryptoService::Connection
+{
+    int fd;
+    vector<uint8_t> in; // received bytes, [0, received)
+    size_t received = 0;
+    size_t parsed = 0; // bytes taken by complete requests of the current wakeup
+    vector<uint8_t> backlog; // response bytes the socket could not take yet, from backlogOffset
+    size_t backlogOffset = 0;
+    bool ended = false; // the peer shut down its end; close once the backlog is sent
+    bool closing = false; // a bad request was answered; close once the backlog is sent
+    bool failed = false; // a read or write failed; close right away
+    uint32_t events = EPOLLIN; // what epoll watches for
+};
+
+
+struct CryptoService::Pending
+{
+    Connection* connection;
+    ServiceHeader header;
+    size_t offset; // of the body in connection->in
+    uint64_t arrival;
+};
+
+
+
+
+// -------------------------------------- SETUP --------------------------------------
+
+/* Function: Constructor
+ * Parameters: The socket path, the encryption and MAC keys and their common length, the options
+ * Return: a CryptoService listening on path
+ * Description: All sockets are non-blocking. The eventfd wake is in the epoll set next to the listener, so stop() only needs
+ *              a write to it. Failures of the system calls throw runtime_error with the reason.
+*/
+CryptoService::CryptoService(const string& path, const uint8_t* encryptionKey, const uint8_t* macKey, size_t keyLength, CryptoServiceOptions options)
+    : path(path), batch(encryptionKey, macKey, keyLength), options(options), listener(-1), epoll(-1), wake(-1), batchCount(0), requestCount(0)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if(path.empty() || path.size() >= sizeof(address.sun_path))
+    {
+        throw invalid_argument("CryptoService: socket path must be 1 to " + to_string(sizeof(address.sun_path) - 1) + " bytes");
+    }
+    if(this->options.maxBatch == 0)
+    {
+        throw invalid_argument("CryptoService: maxBatch must be at least 1");
+    }
+    memcpy(address.sun_path, path.c_str(), path.size());
+    this->authentic.reset(new bool[this->options.maxBatch]);
+
+    this->listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(this->listener < 0)
+    {
+        throw socketError("cannot create socket", path);
+    }
+
+    unlink(path.c_str());
+    if(bind(this->listener, reinterpret_cast<sockaddr*>( &address ), sizeof(address)) != 0 || listen(this->listener, SOMAXCONN) != 0)
+    {
+        runtime_error error = socketError("cannot listen on", path);
+        ::close(this->listener);
+        throw error;
+    }
+
+    this->epoll = epoll_create1(EPOLL_CLOEXEC);
+    this->wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event listen = {EPOLLIN, {}};
+    listen.data.fd = this->listener;
+    epoll_event wakeup = {EPOLLIN, {}};
+    wakeup.data.fd = this->wake;
+    if(this->epoll < 0 || this->wake < 0 || epoll_ctl(this->epoll, EPOLL_CTL_ADD, this->listener, &listen) != 0 ||
+       epoll_ctl(this->epoll, EPOLL_CTL_ADD, this->wake, &wakeup) != 0)
+    {
+        runtime_error error = socketError("cannot set up the event loop for", path);
+        for(int fd : {this->listener, this->epoll, this->wake})
+        {
+            if(fd >= 0)
+            {
+                ::close(fd);
+            }
+        }
+        unlink(path.c_str());
+        throw error;
+    }
+}
+
+
+CryptoService::~CryptoService()
+{
+    for(auto& connection : this->connections)
+    {
+        ::close(connection.first);
+    }
+    this->connections.clear();
+
+    for(int fd : {this->listener, this->epoll, this->wake})
+    {
+        if(fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+    if(this->listener >= 0)
+    {
+        unlink(this->path.c_str());
+    }
+    this->listener = this->epoll = this->wake = -1;
+}
+
+
+void CryptoService::stop()
+{
+    uint64_t one = 1;
+    ssize_t written = write(this->wake, &one, sizeof(one));
+    (void)written; // a full counter already means a stop is pending
+}
+
+
+
+
+// -------------------------------------- EVENT LOOP --------------------------------------
+
+/* Function: run
+ * Parameters: None
+ * Return: None
+ * Description: One iteration per epoll_wait: accept new connections, read all that the ready connections have sent and
+ *              flush backlogs that became writable, then answer every complete request of the wakeup in batches of up to
+ *              maxBatch. Last, the unparsed tail of each receive buffer moves to its front, finished connections close and
+ *              the others are watched for what they wait on.
+*/
+void CryptoService::run()
+{
+    epoll_event events[64];
+    vector<int> ready;
+    bool stopping = false;
+
+    while(!stopping)
+    {
+        int n = epoll_wait(this->epoll, events, 64, -1);
+        if(n < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            throw socketError("epoll_wait failed for", this->path);
+        }
+
+        ready.clear();
+        for(int e = 0; e < n; e++)
+        {
+            int fd = events[e].data.fd;
+            if(fd == this->listener)
+            {
+                accept();
+                continue;
+            }
+            if(fd == this->wake)
+            {
+                stopping = true;
+                continue;
+            }
+
+            auto found = this->connections.find(fd);
+            if(found == this->connections.end())
+            {
+                continue;
+            }
+            Connection& connection = *found->second;
+            if(events[e].events & EPOLLOUT)
+            {
+                flush(connection);
+            }
+            if(events[e].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+            {
+                receive(connection);
+            }
+            ready.push_back(fd);
+        }
+
+        // the receive buffers do not move from here until the batches are answered
+        uint64_t now = nowNs();
+        this->pending.clear();
+        for(int fd : ready)
+        {
+            parse(*this->connections[fd], now);
+        }
+        for(size_t first = 0; first < this->pending.size(); first += this->options.maxBatch)
+        {
+            answer(first, min(this->options.maxBatch, this->pending.size() - first));
+        }
+
+        for(int fd : ready)
+        {
+            Connection& connection = *this->connections[fd];
+            size_t rest = connection.received - connection.parsed;
+            if(rest > 0 && connection.parsed > 0)
+            {
+                memmove(connection.in.data(), connection.in.data() + connection.parsed, rest);
+            }
+            connection.received = rest;
+            connection.parsed = 0;
+
+            if(connection.closing)
+            {
+                connection.received = 0; // nothing after a bad request is answered
+            }
+
+            bool sent = connection.backlog.size() == connection.backlogOffset;
+            if(connection.failed || ((connection.ended || connection.closing) && sent))
+            {
+                close(fd);
+            }
+            else
+            {
+                watch(connection);
+            }
+        }
+    }
+}
+
+
+void CryptoService::accept()
+{
+    while(true)
+    {
+        int fd = accept4(this->listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(fd < 0)
+        {
+            return; // EAGAIN once the queue is empty; other errors concern only that connection
+        }
+
+        epoll_event event = {EPOLLIN, {}};
+        event.data.fd = fd;
+        if(epoll_ctl(this->epoll, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            ::close(fd);
+            continue;
+        }
+
+        unique_ptr<Connection> connection(new Connection);
+        connection->fd = fd;
+        connection->in.resize(ReceiveBytes);
+        this->connections[fd] = move(connection);
+    }
+}
+
+
+void CryptoService::receive(Connection& connection)
+{
+    while(!connection.ended && !connection.failed)
+    {
+        if(connection.received == connection.in.size())
+        {
+            connection.in.resize(2 * connection.in.size());
+        }
+
+        ssize_t n = read(connection.fd, connection.in.data() + connection.received, connection.in.size() - connection.received);
+        if(n > 0)
+        {
+            connection.received += static_cast<size_t>( n );
+        }
+        else if(n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else
+        {
+            connection.ended = n == 0;
+            connection.failed = n < 0 && errno != EAGAIN;
+            return;
+        }
+    }
+}
+
+
+/* Function: parse
+ * Parameters: A connection, the time its bytes arrived
+ * Return: None
+ * Description: Queues every complete request in the receive buffer. A request that is too long, has an unknown op or a body
+ *              too short for its op is queued as BadRequest, and nothing after it on that connection is read.
+*/
+void CryptoService::parse(Connection& connection, uint64_t now)
+{
+    while(!connection.closing && connection.received - connection.parsed >= sizeof(ServiceHeader))
+    {
+        ServiceHeader header;
+        memcpy(&header, connection.in.data() + connection.parsed, sizeof(header));
+
+        bool valid = header.length <= ServiceMaxBody &&
+                     ((header.op == ServiceEncrypt && header.length >= ServiceNonceSize) ||
+                      (header.op == ServiceDecrypt && header.length >= ServiceNonceSize + ServiceTagSize) ||
+                      header.op == ServiceHash ||
+                      (header.op == ServiceStats && header.length == 0));
+        if(!valid)
+        {
+            header.status = ServiceBadRequest;
+            connection.closing = true;
+            this->pending.push_back(Pending{&connection, header, 0, now});
+            connection.parsed = connection.received;
+            return;
+        }
+
+        if(connection.received - connection.parsed - sizeof(header) < header.length)
+        {
+            return;
+        }
+
+        header.status = ServiceOk;
+        this->pending.push_back(Pending{&connection, header, connection.parsed + sizeof(header), now});
+        connection.parsed += sizeof(header) + header.length;
+    }
+}
+
+
+
+
+// -------------------------------------- BATCHES --------------------------------------
+
+/* Function: answer
+ * Parameters: The first pending request of the batch and the number of requests
+ * Return: None
+ * Description: Collects the Encrypt and Decrypt requests into AESBatch records that point at their bodies in the receive
+ *              buffers, then seals all Encrypts with one call and opens all Decrypts with another, into two regions of the
+ *              arena. Hashes are spread over the pool. Each response body is then a pointer into the arena, the digests or the
+ *              stats text.
+*/
+void CryptoService::answer(size_t first, size_t count)
+{
+    PERF_BATCH_SCOPE("CryptoService::answer", count);
+
+    this->batchCount++;
+    this->requestCount += count;
+    this->headers.resize(count);
+    this->bodies.assign(count, nullptr);
+
+    // the records of the Encrypts, then those of the Decrypts
+    this->records.clear();
+    this->indices.clear();
+    size_t encrypts = 0;
+    for(int op : {ServiceEncrypt, ServiceDecrypt})
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            const Pending& request = this->pending[first + i];
+            if(request.header.op != op || request.header.status != ServiceOk)
+            {
+                continue;
+            }
+
+            const uint8_t* body = request.connection->in.data() + request.offset;
+            size_t length = request.header.length - ServiceNonceSize - (op == ServiceDecrypt ? ServiceTagSize : 0);
+            const uint8_t* tag = op == ServiceDecrypt ? body + ServiceNonceSize + length : nullptr;
+            this->records.push_back(AESRecord{body + ServiceNonceSize, length, nullptr, 0, body, tag});
+            this->indices.push_back(i);
+        }
+        if(op == ServiceEncrypt)
+        {
+            encrypts = this->records.size();
+        }
+    }
+    size_t decrypts = this->records.size() - encrypts;
+
+    size_t sealBytes = AESBatch::arenaSize(this->records.data(), encrypts);
+    size_t openBytes = 0;
+    for(size_t r = encrypts; r < this->records.size(); r++)
+    {
+        openBytes += this->records[r].length;
+    }
+    if(this->arena.size() < sealBytes + openBytes)
+    {
+        this->arena.resize(sealBytes + openBytes);
+    }
+    this->outputs.resize(this->records.size());
+
+    if(encrypts > 0)
+    {
+        this->batch.seal(this->records.data(), encrypts, this->arena.data(), sealBytes, this->outputs.data(), this->options.threads);
+    }
+    if(decrypts > 0)
+    {
+        this->batch.open(this->records.data() + encrypts, decrypts, this->arena.data() + sealBytes, openBytes, this->outputs.data() + encrypts,
+                         this->authentic.get(), this->options.threads);
+    }
+
+    for(size_t r = 0; r < this->records.size(); r++)
+    {
+        size_t i = this->indices[r];
+        ServiceHeader& header = this->headers[i];
+        header = this->pending[first + i].header;
+        this->bodies[i] = this->outputs[r].data;
+        if(r < encrypts)
+        {
+            header.length = static_cast<uint32_t>( this->outputs[r].length + ServiceTagSize ); // the tag follows the ciphertext
+        }
+        else if(this->authentic[r - encrypts])
+        {
+            header.length = static_cast<uint32_t>( this->outputs[r].length );
+        }
+        else
+        {
+            header.status = ServiceAuthenticationFailed;
+            header.length = 0;
+        }
+    }
+
+    // hashes, stats and rejected requests
+    this->indices.clear();
+    bool stats = false;
+    for(size_t i = 0; i < count; i++)
+    {
+        const Pending& request = this->pending[first + i];
+        if(request.header.status != ServiceOk)
+        {
+            this->headers[i] = request.header;
+            this->headers[i].length = 0;
+        }
+        else if(request.header.op == ServiceHash)
+        {
+            this->indices.push_back(i);
+        }
+        else if(request.header.op == ServiceStats)
+        {
+            stats = true;
+        }
+    }
+
+    this->digests.resize(ServiceDigestSize * this->indices.size());
+    parallelFor(this->indices.size(), this->options.threads, [&](size_t h)
+    {
+        const Pending& request = this->pending[first + this->indices[h]];
+        SHA1 sha1;
+        sha1.digest(request.connection->in.data() + request.offset, request.header.length, this->digests.data() + ServiceDigestSize * h);
+    });
+    for(size_t h = 0; h < this->indices.size(); h++)
+    {
+        size_t i = this->indices[h];
+        this->headers[i] = this->pending[first + i].header;
+        this->headers[i].length = static_cast<uint32_t>( ServiceDigestSize );
+        this->bodies[i] = this->digests.data() + ServiceDigestSize * h;
+    }
+
+    if(stats)
+    {
+        ostringstream text;
+        report(text);
+        this->statsText = text.str();
+        for(size_t i = 0; i < count; i++)
+        {
+            const Pending& request = this->pending[first + i];
+            if(request.header.op == ServiceStats && request.header.status == ServiceOk)
+            {
+                this->headers[i] = request.header;
+                this->headers[i].length = static_cast<uint32_t>( this->statsText.size() );
+                this->bodies[i] = reinterpret_cast<const uint8_t*>( this->statsText.data() );
+            }
+        }
+    }
+
+    respond(first, count);
+}
+
+
+/* Function: respond
+ * Parameters: The first pending request of the batch and the number of requests
+ * Return: None
+ * Description: The requests of a connection are consecutive in the batch, so each run of them becomes one gather write of
+ *              header, body, header, body, ... straight from the batch buffers
+*/
+void CryptoService::respond(size_t first, size_t count)
+{
+    size_t i = 0;
+    while(i < count)
+    {
+        Connection& connection = *this->pending[first + i].connection;
+        size_t end = i;
+        this->iovecs.clear();
+        while(end < count && this->pending[first + end].connection == &connection && this->iovecs.size() + 2 <= MaxIovecs)
+        {
+            ServiceHeader& header = this->headers[end];
+            this->iovecs.push_back(iovec{&header, sizeof(header)});
+            if(header.length > 0)
+            {
+                this->iovecs.push_back(iovec{const_cast<uint8_t*>( this->bodies[end] ), header.length});
+            }
+            end++;
+        }
+
+        send(connection, this->iovecs.data(), this->iovecs.size());
+
+        uint64_t now = nowNs();
+        for(; i < end; i++)
+        {
+            const Pending& request = this->pending[first + i];
+            if(request.header.op >= ServiceEncrypt && request.header.op <= ServiceStats)
+            {
+                this->histograms[request.header.op - 1].record(now - request.arrival);
+            }
+        }
+    }
+}
+
+
+/* Function: send
+ * Parameters: A connection, the iovecs, their count
+ * Return: None
+ * Description: Writes as much as the socket takes and copies the rest to the backlog. While a backlog is waiting, new
+ *              responses are appended to it so they stay in order.
+*/
+void CryptoService::send(Connection& connection, const iovec* iov, size_t count)
+{
+    size_t written = 0;
+    if(connection.failed)
+    {
+        return;
+    }
+    if(connection.backlog.size() == connection.backlogOffset)
+    {
+        msghdr message = {};
+        message.msg_iov = const_cast<iovec*>( iov );
+        message.msg_iovlen = count;
+        ssize_t n;
+        do
+        {
+            n = sendmsg(connection.fd, &message, MSG_NOSIGNAL | MSG_DONTWAIT);
+        }
+        while(n < 0 && errno == EINTR);
+
+        if(n < 0 && errno != EAGAIN)
+        {
+            connection.failed = true;
+            return;
+        }
+        written = n < 0 ? 0 : static_cast<size_t>( n );
+    }
+
+    for(size_t v = 0; v < count; v++)
+    {
+        if(written >= iov[v].iov_len)
+        {
+            written -= iov[v].iov_len;
+            continue;
+        }
+        const uint8_t* base = static_cast<const uint8_t*>( iov[v].iov_base );
+        connection.backlog.insert(connection.backlog.end(), base + written, base + iov[v].iov_len);
+        written = 0;
+    }
+}
+
+
+void CryptoService::flush(Connection& connection)
+{
+    while(connection.backlogOffset < connection.backlog.size())
+    {
+        ssize_t n = ::send(connection.fd, connection.backlog.data() + connection.backlogOffset, connection.backlog.size() - connection.backlogOffset,
+                           MSG_NOSIGNAL | MSG_DONTWAIT);
+        if(n < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            connection.failed = errno != EAGAIN;
+            return;
+        }
+        connection.backlogOffset += static_cast<size_t>( n );
+    }
+
+    connection.backlog.clear();
+    connection.backlogOffset = 0;
+}
+
+
+// Reads while the peer may still send, and waits for the socket to be writable while a backlog is waiting
+void CryptoService::watch(Connection& connection)
+{
+    bool backlog = connection.backlogOffset < connection.backlog.size();
+    uint32_t events = (connection.ended ? 0u : static_cast<uint32_t>( EPOLLIN )) | (backlog ? static_cast<uint32_t>( EPOLLOUT ) : 0u);
+    if(events != connection.events)
+    {
+        epoll_event event = {events, {}};
+        event.data.fd = connection.fd;
+        epoll_ctl(this->epoll, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.events = events;
+    }
+}
+
+
+void CryptoService::close(int fd)
+{
+    epoll_ctl(this->epoll, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    this->connections.erase(fd);
+}
+
+
+
+
+// -------------------------------------- STATISTICS --------------------------------------
+
+const LatencyHistogram& CryptoService::latency(ServiceOp op) const
+{
+    if(op < ServiceEncrypt || op > ServiceStats)
+    {
+        throw invalid_argument("CryptoService: unknown op " + to_string(op));
+    }
+    return this->histograms[op - 1];
+}
+
+
+void CryptoService::report(ostream& out) const
+{
+    double perBatch = this->batchCount == 0 ? 0.0 : static_cast<double>( this->requestCount ) / static_cast<double>( this->batchCount );
+    out << "requests: " << this->requestCount << " in " << this->batchCount << " batches (" << perBatch << " per batch)" << endl;
+
+    LatencyHistogram::printHeader(out);
+    const char* names[4] = {"encrypt", "decrypt", "hash", "stats"};
+    for(int op = 0; op < 4; op++)
+    {
+        this->histograms[op].print(out, names[op]);
+    }
+}
@@ -0,0 +1,106 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains CryptoService, the encryption sidecar: a single threaded epoll event loop that serves the
+ *                  requests of ServiceProtocol.h on a UNIX domain stream socket.
+ *
+ *                  Each wakeup of the loop first reads everything the ready connections have sent, then answers all the complete
+ *                  requests of all connections together. The Encrypt requests of one wakeup are one AESBatch::seal call and the
+ *                  Decrypt requests one AESBatch::open call, so many small concurrent requests reach the multi-block AES-NI and
+ *                  VAES kernels and the interleaved CMAC as one batch instead of one short call each.
+ *
+ *                  Request bodies are not copied: the batch records point into the receive buffers. The batch writes its
+ *                  output into one arena, and each connection's responses go out with a single writev whose iovecs alternate
+ *                  between the response headers and their bodies in the arena. Only when the socket can not take everything is
+ *                  the unsent remainder copied, into the connection's backlog, which is flushed when epoll reports the socket
+ *                  writable again.
+ *
+ *                  The time from the read that completed a request to the write of its response is recorded per operation in
+ *                  a LatencyHistogram.
+*/
+
+#ifndef CRYPTO_SERVICE_H
+#define CRYPTO_SERVICE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sys/uio.h>
+
+#include "ServiceProtocol.h"
+#include "../Advanced Encryption Standard (AES)/AESBatch.h"
+#include "../Common/LatencyHistogram.h"
+
+using namespace std;
+
+struct CryptoServiceOptions
+{
+    size_t maxBatch = 1024; // requests answered per batch; the rest of a wakeup's requests wait for the next batch
+    unsigned threads = 1; // threads for AESBatch and the hashes of a batch (0 = one per core)
+};
+
+class CryptoService
+{
+    public:
+        // Binds and listens on path (an existing socket file there is replaced), with the AESBatch keys
+        CryptoService(const string& path, const uint8_t* encryptionKey, const uint8_t* macKey, size_t keyLength, CryptoServiceOptions = {});
+        ~CryptoService(); // closes every socket and removes the socket file
+
+        CryptoService(const CryptoService&) = delete;
+        CryptoService& operator=(const CryptoService&) = delete;
+
+        void run(); // serves until stop() is called
+        void stop(); // safe from other threads and from signal handlers
+
+        const LatencyHistogram& latency(ServiceOp) const;
+        uint64_t batches() const { return this->batchCount; }
+        uint64_t requests() const { return this->requestCount; }
+        void report(ostream&) const; // batch counts and the latency histograms
+
+    private:
+        struct Connection;
+        struct Pending;
+
+        string path;
+        AESBatch batch;
+        CryptoServiceOptions options;
+        int listener;
+        int epoll;
+        int wake;
+        unordered_map<int, unique_ptr<Connection>> connections;
+
+        LatencyHistogram histograms[4];
+        uint64_t batchCount;
+        uint64_t requestCount;
+
+        // scratch reused by every batch, so a batch allocates only when it is larger than every one before it
+        vector<Pending> pending;
+        vector<AESRecord> records;
+        vector<AESRecordOutput> outputs;
+        vector<uint8_t> arena;
+        unique_ptr<bool[]> authentic; // maxBatch flags
+        vector<uint8_t> digests;
+        vector<ServiceHeader> headers;
+        vector<const uint8_t*> bodies;
+        vector<size_t> indices;
+        vector<iovec> iovecs;
+        string statsText;
+
+        void accept();
+        void receive(Connection&);
+        void parse(Connection&, uint64_t now);
+        void answer(size_t first, size_t count);
+        void respond(size_t first, size_t count);
+        void send(Connection&, const iovec*, size_t);
+        void flush(Connection&);
+        void watch(Connection&);
+        void close(int fd);
+};
+
+#endif
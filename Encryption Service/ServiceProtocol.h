@@ -0,0 +1,59 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the wire format of the encryption service. Every request and every response is one
+ *                  16 byte ServiceHeader followed by header.length bytes of body. The socket is local, so the header fields are in
+ *                  host byte order. A connection may send any number of requests without waiting; responses carry the id of their
+ *                  request and come back in request order.
+ *
+ *                  op        request body                                  response body (status Ok)
+ *                  Encrypt   nonce (12) | plaintext                        ciphertext | tag (16)
+ *                  Decrypt   nonce (12) | ciphertext | tag (16)            plaintext
+ *                  Hash      message                                       SHA1 digest (20)
+ *                  Stats     empty                                         text: batch counts and latency histograms
+ *
+ *                  Encrypt and Decrypt are the AESBatch record format: counter mode under the encryption key, AES-CMAC over
+ *                  nonce | length | ciphertext under the MAC key. A Decrypt whose tag does not match is answered with status
+ *                  AuthenticationFailed and an empty body; a malformed request with BadRequest, after which the connection closes.
+*/
+
+#ifndef SERVICE_PROTOCOL_H
+#define SERVICE_PROTOCOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+enum ServiceOp : uint8_t
+{
+    ServiceEncrypt = 1,
+    ServiceDecrypt = 2,
+    ServiceHash = 3,
+    ServiceStats = 4
+};
+
+enum ServiceStatus : uint8_t
+{
+    ServiceOk = 0,
+    ServiceAuthenticationFailed = 1,
+    ServiceBadRequest = 2
+};
+
+struct ServiceHeader
+{
+    uint32_t length; // body bytes after the header
+    uint8_t op; // ServiceOp; a response repeats the op of its request
+    uint8_t status; // ServiceStatus in a response, 0 in a request
+    uint16_t reserved;
+    uint64_t id; // chosen by the client and echoed in the response
+};
+
+static_assert(sizeof(ServiceHeader) == 16, "the header is 16 bytes on the wire");
+
+static const size_t ServiceNonceSize = 12;
+static const size_t ServiceTagSize = 16;
+static const size_t ServiceDigestSize = 20;
+static const size_t ServiceMaxBody = 1 << 20; // larger requests are rejected with BadRequest
+
+#endif
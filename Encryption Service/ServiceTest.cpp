@@ -0,0 +1,319 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This program tests CryptoService entirely on localhost. It runs the service on a socket in /tmp on one thread
+ *                  and a number of clients on others. Each client keeps a window of requests in flight on its own connection:
+ *                  Encrypts, Decrypts (one in eight with a forged tag) and Hashes of random sizes. It checks every response
+ *                  against the same operation done in process with AESBatch and SHA1, and records the round trip times. A last
+ *                  connection sends a malformed request, which must be rejected and the connection closed.
+ *
+ * Compilation:     cmake -S . -B build && cmake --build build --target crypto_service_test        (from the repository root)
+ *
+ * Usage:           ./crypto_service_test [options]
+ *                      --clients=<n>       concurrent connections (default 8)
+ *                      --requests=<n>      requests per connection (default 2000)
+ *                      --window=<n>        requests in flight per connection (default 32)
+*/
+
+#include "CryptoService.h"
+#include "../Secure Hash Algorithm 1 (SHA1)/SHA1.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const uint8_t EncryptionKey[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+static const uint8_t MacKey[16] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+
+
+struct Expected
+{
+    uint64_t id;
+    uint8_t op;
+    uint8_t status;
+    vector<uint8_t> body;
+    chrono::steady_clock::time_point sent;
+};
+
+
+static int connectTo(const string& path)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path.c_str(), path.size());
+    if(fd < 0 || connect(fd, reinterpret_cast<sockaddr*>( &address ), sizeof(address)) != 0)
+    {
+        throw runtime_error("cannot connect to " + path + ": " + strerror(errno));
+    }
+    return fd;
+}
+
+
+static bool writeAll(int fd, const void* data, size_t length)
+{
+    const uint8_t* p = static_cast<const uint8_t*>( data );
+    while(length > 0)
+    {
+        ssize_t n = write(fd, p, length);
+        if(n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(n <= 0)
+        {
+            return false;
+        }
+        p += n;
+        length -= static_cast<size_t>( n );
+    }
+    return true;
+}
+
+
+static bool readAll(int fd, void* data, size_t length)
+{
+    uint8_t* p = static_cast<uint8_t*>( data );
+    while(length > 0)
+    {
+        ssize_t n = read(fd, p, length);
+        if(n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(n <= 0)
+        {
+            return false;
+        }
+        p += n;
+        length -= static_cast<size_t>( n );
+    }
+    return true;
+}
+
+
+/* Function: runClient
+ * Parameters: The socket path, the client number, the number of requests, the window, the histogram, the count of good responses
+ * Return: None
+ * Description: Builds each request together with the response it must get, keeps up to window requests unanswered, and
+ *              compares every response with the oldest expected one, since responses come back in request order
+*/
+static void runClient(const string& path, int client, size_t requests, size_t window, LatencyHistogram& latency, atomic<size_t>& verified)
+{
+    AESBatch local(EncryptionKey, MacKey, 16);
+    mt19937_64 random(static_cast<uint64_t>( client ) + 1);
+    int fd = connectTo(path);
+
+    deque<Expected> inFlight;
+    size_t sent = 0;
+    size_t answered = 0;
+    vector<uint8_t> request;
+    vector<uint8_t> body;
+
+    while(answered < requests)
+    {
+        while(sent < requests && inFlight.size() < window)
+        {
+            Expected expected;
+            expected.id = (static_cast<uint64_t>( client ) << 32) | sent;
+            expected.status = ServiceOk;
+
+            size_t length = random() % 1025;
+            vector<uint8_t> message(length);
+            for(uint8_t& b : message)
+            {
+                b = static_cast<uint8_t>( random() );
+            }
+            uint8_t nonce[ServiceNonceSize];
+            for(uint8_t& b : nonce)
+            {
+                b = static_cast<uint8_t>( random() );
+            }
+
+            // the sealed message, as both the expected Encrypt response and the body of a Decrypt
+            vector<uint8_t> sealed(length + ServiceTagSize);
+            AESRecord record = {message.data(), length, nullptr, 0, nonce, nullptr};
+            AESRecordOutput output;
+            local.seal(&record, 1, sealed.data(), sealed.size(), &output);
+
+            int kind = static_cast<int>( random() % 10 );
+            if(kind < 4)
+            {
+                expected.op = ServiceEncrypt;
+                body.assign(nonce, nonce + ServiceNonceSize);
+                body.insert(body.end(), message.begin(), message.end());
+                expected.body = sealed;
+            }
+            else if(kind < 7)
+            {
+                expected.op = ServiceDecrypt;
+                body.assign(nonce, nonce + ServiceNonceSize);
+                body.insert(body.end(), sealed.begin(), sealed.end());
+                if(random() % 8 == 0)
+                {
+                    body.back() ^= 0x01;
+                    expected.status = ServiceAuthenticationFailed;
+                }
+                else
+                {
+                    expected.body = message;
+                }
+            }
+            else
+            {
+                expected.op = ServiceHash;
+                body = message;
+                expected.body.resize(ServiceDigestSize);
+                SHA1 sha1;
+                sha1.digest(message.data(), message.size(), expected.body.data());
+            }
+
+            ServiceHeader header = {static_cast<uint32_t>( body.size() ), expected.op, 0, 0, expected.id};
+            request.resize(sizeof(header) + body.size());
+            memcpy(request.data(), &header, sizeof(header));
+            memcpy(request.data() + sizeof(header), body.data(), body.size());
+
+            expected.sent = chrono::steady_clock::now();
+            if(!writeAll(fd, request.data(), request.size()))
+            {
+                throw runtime_error("client " + to_string(client) + ": write failed");
+            }
+            inFlight.push_back(move(expected));
+            sent++;
+        }
+
+        ServiceHeader header;
+        if(!readAll(fd, &header, sizeof(header)))
+        {
+            throw runtime_error("client " + to_string(client) + ": connection closed early");
+        }
+        vector<uint8_t> response(header.length);
+        if(!readAll(fd, response.data(), response.size()))
+        {
+            throw runtime_error("client " + to_string(client) + ": connection closed early");
+        }
+
+        Expected& expected = inFlight.front();
+        latency.record(static_cast<uint64_t>( chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - expected.sent).count() ));
+        if(header.id == expected.id && header.op == expected.op && header.status == expected.status && response == expected.body)
+        {
+            verified++;
+        }
+        inFlight.pop_front();
+        answered++;
+    }
+
+    close(fd);
+}
+
+
+// a request with an unknown op must be answered with BadRequest, after which the service closes the connection
+static bool rejectsBadRequest(const string& path)
+{
+    int fd = connectTo(path);
+    ServiceHeader header = {0, 99, 0, 0, 7};
+    ServiceHeader response = {};
+    uint8_t extra;
+    bool rejected = writeAll(fd, &header, sizeof(header)) && readAll(fd, &response, sizeof(response)) &&
+                    response.status == ServiceBadRequest && response.id == 7 && read(fd, &extra, 1) == 0;
+    close(fd);
+    return rejected;
+}
+
+
+int main(int argc, char** argv)
+{
+    size_t clients = 8;
+    size_t requests = 2000;
+    size_t window = 32;
+
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        auto value = [&](const string& flag) { return arg.substr(flag.length()); };
+
+        try
+        {
+            if(arg.rfind("--clients=", 0) == 0) clients = stoul(value("--clients="));
+            else if(arg.rfind("--requests=", 0) == 0) requests = stoul(value("--requests="));
+            else if(arg.rfind("--window=", 0) == 0) window = max<size_t>(stoul(value("--window=")), 1);
+            else
+            {
+                cerr << "unknown option " << arg << endl;
+                return 1;
+            }
+        }
+        catch(const exception&)
+        {
+            cerr << "bad value in " << arg << endl;
+            return 1;
+        }
+    }
+
+    string path = "/tmp/crypto_service_test." + to_string(getpid()) + ".sock";
+    CryptoService service(path, EncryptionKey, MacKey, 16);
+    thread server([&]() { service.run(); });
+
+    vector<LatencyHistogram> latencies(clients);
+    atomic<size_t> verified(0);
+    atomic<bool> failed(false);
+    auto start = chrono::steady_clock::now();
+
+    vector<thread> threads;
+    for(size_t c = 0; c < clients; c++)
+    {
+        threads.emplace_back([&, c]()
+        {
+            try
+            {
+                runClient(path, static_cast<int>( c ), requests, window, latencies[c], verified);
+            }
+            catch(const exception& error)
+            {
+                cerr << error.what() << endl;
+                failed = true;
+            }
+        });
+    }
+    for(thread& t : threads)
+    {
+        t.join();
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    bool rejected = rejectsBadRequest(path);
+
+    service.stop();
+    server.join();
+
+    LatencyHistogram roundTrip;
+    for(const LatencyHistogram& latency : latencies)
+    {
+        roundTrip.merge(latency);
+    }
+
+    size_t total = clients * requests;
+    cout << "clients: " << clients << ", window: " << window << ", " << static_cast<double>( total ) / seconds << " requests/s" << endl;
+    cout << endl << "service:" << endl;
+    service.report(cout);
+    cout << endl << "client round trip:" << endl;
+    LatencyHistogram::printHeader(cout);
+    roundTrip.print(cout, "all");
+    cout << endl;
+    cout << "bad request: " << (rejected ? "rejected" : "NOT rejected") << endl;
+    cout << "verified: " << verified << " of " << total << " responses" << endl;
+
+    return failed || !rejected || verified != total ? 1 : 0;
+}
@@ -0,0 +1,114 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This program runs CryptoService, the encryption sidecar, on a UNIX domain socket until it receives SIGINT or
+ *                  SIGTERM, then prints the batch counts and latency histograms to standard error. The key file holds the
+ *                  encryption key followed by the MAC key, raw, 32, 48 or 64 bytes in all; keys are never taken on the command
+ *                  line, where other users could read them.
+ *
+ * Compilation:     cmake -S . -B build && cmake --build build --target crypto_serviced        (from the repository root)
+ *
+ * Usage:           ./crypto_serviced --socket=<path> --key-file=<path> [options]
+ *                      --batch=<n>     requests answered per batch (default 1024)
+ *                      -j <n>          threads per batch (default 1, 0 = one per core)
+ *                      --lock-keys     keep the key schedules in mlocked pages, out of swap and core dumps
+*/
+
+#include "CryptoService.h"
+#include "../Common/SecureMemory.h"
+
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+using namespace std;
+
+static CryptoService* running = nullptr;
+
+static void handleSignal(int)
+{
+    if(running != nullptr)
+    {
+        running->stop();
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    string socketPath;
+    string keyPath;
+    CryptoServiceOptions options;
+
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        auto value = [&](const string& flag) { return arg.substr(flag.length()); };
+
+        try
+        {
+            if(arg.rfind("--socket=", 0) == 0) socketPath = value("--socket=");
+            else if(arg.rfind("--key-file=", 0) == 0) keyPath = value("--key-file=");
+            else if(arg.rfind("--batch=", 0) == 0) options.maxBatch = stoul(value("--batch="));
+            else if(arg == "-j" && i + 1 < argc) options.threads = static_cast<unsigned>( stoul(argv[++i]) );
+            else if(arg == "--lock-keys") setKeyMemoryLocking(true);
+            else
+            {
+                cerr << "unknown option " << arg << endl;
+                return 1;
+            }
+        }
+        catch(const exception&)
+        {
+            cerr << "bad value in " << arg << endl;
+            return 1;
+        }
+    }
+
+    if(socketPath.empty() || keyPath.empty())
+    {
+        cerr << "usage: crypto_serviced --socket=<path> --key-file=<path> [--batch=<n>] [-j <n>] [--lock-keys]" << endl;
+        return 1;
+    }
+
+    ifstream keyFile(keyPath, ios::binary);
+    if(!keyFile)
+    {
+        cerr << "cannot open " << keyPath << endl;
+        return 1;
+    }
+    vector<uint8_t> keys((istreambuf_iterator<char>(keyFile)), istreambuf_iterator<char>());
+    if(keys.size() != 32 && keys.size() != 48 && keys.size() != 64)
+    {
+        secureZero(keys.data(), keys.size());
+        cerr << "the key file must hold two keys of 16, 24 or 32 bytes" << endl;
+        return 1;
+    }
+
+    try
+    {
+        CryptoService service(socketPath, keys.data(), keys.data() + keys.size() / 2, keys.size() / 2, options);
+        secureZero(keys.data(), keys.size());
+
+        running = &service;
+        signal(SIGINT, handleSignal);
+        signal(SIGTERM, handleSignal);
+        cerr << "serving on " << socketPath << endl;
+
+        service.run();
+
+        running = nullptr;
+        service.report(cerr);
+    }
+    catch(const exception& error)
+    {
+        secureZero(keys.data(), keys.size());
+        cerr << error.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,214 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This program is the C++ port of HashAttack.py. It measures how many attempts the brute force pre-image and
+ *                  collision attacks take against SHA1 truncated to its low n bits, with random 40 letter strings as the
+ *                  candidates. Each attack is repeated for a number of rounds, and the rounds run in parallel on the shared
+ *                  thread pool, each with its own random generator seeded from --seed and its position, so a run is repeatable
+ *                  whatever the thread count.
+ *
+ *                  The attempt counts mean what they mean in the Python version:
+ *                    pre-image   extra candidates drawn after the first one until one matches the target (expected about 2^n)
+ *                    collision   distinct truncated hashes seen before one repeats (expected about sqrt(pi/2 * 2^n))
+ *
+ * Compilation:     cmake -S . -B build && cmake --build build --target hash_attack        (from the repository root)
+ *
+ * Usage:           ./hash_attack [options]
+ *                      --attack=<preimage|collision|both>  attacks to run (default both)
+ *                      --bits=<n,n,...>                    truncation sizes, 1 to 32 (default 8,10,12,14,16,18,20,22)
+ *                      --rounds=<n>                        rounds per attack and size (default 50)
+ *                      --seed=<n>                          seed of the candidate generators (default: random)
+ *                      -j <n>                              run at most n rounds at a time (default: one per core)
+ *                      --verbose                           print the attempts of every round
+*/
+
+#include "../Secure Hash Algorithm 1 (SHA1)/SHA1.h"
+#include "../Common/Parallel.h"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+static const char Letters[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+static const size_t CandidateLength = 40;
+
+
+// Trunc_SHA1: a random candidate string and the low bits of its SHA1 digest
+class Candidates
+{
+    public:
+        Candidates(uint64_t seed, int bits) : generator(seed), letter(0, sizeof(Letters) - 2),
+                                              mask(bits == 32 ? 0xFFFFFFFFu : (1u << bits) - 1)
+        {
+        }
+
+        uint32_t next()
+        {
+            uint8_t text[CandidateLength];
+            for(size_t i = 0; i < CandidateLength; i++)
+            {
+                text[i] = static_cast<uint8_t>( Letters[letter(generator)] );
+            }
+
+            uint8_t digest[20];
+            sha.digest(text, CandidateLength, digest);
+
+            uint32_t low = static_cast<uint32_t>( digest[16] ) << 24 | static_cast<uint32_t>( digest[17] ) << 16 |
+                           static_cast<uint32_t>( digest[18] ) << 8 | static_cast<uint32_t>( digest[19] );
+            return low & mask;
+        }
+
+    private:
+        mt19937_64 generator;
+        uniform_int_distribution<int> letter;
+        uint32_t mask;
+        SHA1 sha;
+};
+
+
+static uint64_t preimageAttack(Candidates& candidates)
+{
+    uint32_t target = candidates.next();
+    uint64_t attempts = 0;
+    while(candidates.next() != target)
+    {
+        attempts++;
+    }
+    return attempts;
+}
+
+
+// the Python version searches a list of the hashes seen; a bitmap over all 2^bits values answers the same question at once
+static uint64_t collisionAttack(Candidates& candidates, int bits)
+{
+    vector<uint64_t> seen(((static_cast<uint64_t>( 1 ) << bits) + 63) / 64, 0);
+    uint64_t attempts = 0;
+
+    uint32_t hash = candidates.next();
+    while(!(seen[hash / 64] >> (hash % 64) & 1))
+    {
+        attempts++;
+        seen[hash / 64] |= static_cast<uint64_t>( 1 ) << (hash % 64);
+        hash = candidates.next();
+    }
+    return attempts;
+}
+
+
+
+
+int main(int argc, char** argv)
+{
+    bool preimage = true;
+    bool collision = true;
+    vector<int> bitSizes = {8, 10, 12, 14, 16, 18, 20, 22};
+    size_t rounds = 50;
+    uint64_t seed = random_device()();
+    unsigned threads = 0;
+    bool verbose = false;
+
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        auto value = [&](const string& flag) { return arg.substr(flag.length()); };
+
+        try
+        {
+            if(arg == "--attack=preimage") collision = false;
+            else if(arg == "--attack=collision") preimage = false;
+            else if(arg == "--attack=both") preimage = collision = true;
+            else if(arg.rfind("--bits=", 0) == 0)
+            {
+                bitSizes.clear();
+                stringstream list(value("--bits="));
+                string size;
+                while(getline(list, size, ','))
+                {
+                    bitSizes.push_back(stoi(size));
+                    if(bitSizes.back() < 1 || bitSizes.back() > 32)
+                    {
+                        throw out_of_range(size);
+                    }
+                }
+            }
+            else if(arg.rfind("--rounds=", 0) == 0) rounds = stoul(value("--rounds="));
+            else if(arg.rfind("--seed=", 0) == 0) seed = stoull(value("--seed="));
+            else if(arg == "-j" && i + 1 < argc) threads = static_cast<unsigned>( stoul(argv[++i]) );
+            else if(arg == "--verbose") verbose = true;
+            else
+            {
+                cerr << "unknown option " << arg << endl;
+                return 1;
+            }
+        }
+        catch(const exception&)
+        {
+            cerr << "bad value in " << arg << endl;
+            return 1;
+        }
+    }
+
+    cout << left << setw(12) << "attack" << right << setw(6) << "bits" << setw(8) << "rounds" << setw(14) << "mean"
+         << setw(14) << "expected" << setw(12) << "min" << setw(12) << "max" << setw(12) << "seconds" << endl;
+
+    for(int attack = 0; attack < 2; attack++)
+    {
+        if((attack == 0 && !preimage) || (attack == 1 && !collision))
+        {
+            continue;
+        }
+
+        for(int bits : bitSizes)
+        {
+            vector<uint64_t> attempts(rounds);
+            auto start = chrono::steady_clock::now();
+
+            parallelFor(rounds, threads, [&](size_t round)
+            {
+                // a distinct, repeatable stream for every attack, size and round
+                seed_seq sequence{static_cast<uint32_t>( seed ), static_cast<uint32_t>( seed >> 32 ), static_cast<uint32_t>( attack ),
+                                  static_cast<uint32_t>( bits ), static_cast<uint32_t>( round )};
+                uint64_t roundSeed;
+                sequence.generate(reinterpret_cast<uint32_t*>( &roundSeed ), reinterpret_cast<uint32_t*>( &roundSeed ) + 2);
+
+                Candidates candidates(roundSeed, bits);
+                attempts[round] = attack == 0 ? preimageAttack(candidates) : collisionAttack(candidates, bits);
+            });
+
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+            uint64_t total = 0;
+            uint64_t least = UINT64_MAX;
+            uint64_t most = 0;
+            for(uint64_t a : attempts)
+            {
+                total += a;
+                least = min(least, a);
+                most = max(most, a);
+                if(verbose)
+                {
+                    cout << a << endl;
+                }
+            }
+
+            double space = ldexp(1.0, bits);
+            double expected = attack == 0 ? space : sqrt(acos(-1.0) / 2 * space);
+            cout << left << setw(12) << (attack == 0 ? "preimage" : "collision") << right << setw(6) << bits << setw(8) << rounds
+                 << fixed << setprecision(1) << setw(14) << (rounds ? static_cast<double>( total ) / rounds : 0.0)
+                 << setw(14) << expected << setw(12) << (rounds ? least : 0) << setw(12) << most
+                 << setprecision(3) << setw(12) << seconds << endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,328 @@
+#include "HMACSHA1.h"
+#include "SHA1Kernels.h"
+#include "../Common/CpuFeatures.h"
+#include "../Common/Parallel.h"
+#include "../Common/PerfCounters.h"
+#include "../Common/SecureMemory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+
+HMACSHA1::HMACSHA1(const uint8_t* key, size_t keyLength)
+{
+    uint8_t block[SHA1::BlockSize] = {};
+    SHA1 sha1;
+
+    // keys longer than a block are hashed first
+    if(keyLength > SHA1::BlockSize)
+    {
+        sha1.digest(key, keyLength, block);
+    }
+    else
+    {
+        memcpy(block, key, keyLength);
+    }
+
+    uint8_t pad[SHA1::BlockSize];
+
+    for(size_t i = 0; i < SHA1::BlockSize; i++)
+    {
+        pad[i] = block[i] ^ 0x36;
+    }
+    sha1.reset();
+    sha1.processBlocks(pad, 1);
+    this->inner[0] = sha1.H0;
+    this->inner[1] = sha1.H1;
+    this->inner[2] = sha1.H2;
+    this->inner[3] = sha1.H3;
+    this->inner[4] = sha1.H4;
+
+    for(size_t i = 0; i < SHA1::BlockSize; i++)
+    {
+        pad[i] = block[i] ^ 0x5c;
+    }
+    sha1.reset();
+    sha1.processBlocks(pad, 1);
+    this->outer[0] = sha1.H0;
+    this->outer[1] = sha1.H1;
+    this->outer[2] = sha1.H2;
+    this->outer[3] = sha1.H3;
+    this->outer[4] = sha1.H4;
+
+    // only the midstates outlive the constructor; the hasher's buffer may still hold the tail of a long key
+    secureZero(block, sizeof(block));
+    secureZero(pad, sizeof(pad));
+    secureZero(&sha1, sizeof(sha1));
+}
+
+
+
+
+// H(K ^ opad || H(K ^ ipad || message)), both started from the cached midstates
+void HMACSHA1::mac(const uint8_t* message, size_t length, uint8_t* out) const
+{
+    uint8_t digest[SHA1::DigestSize];
+    SHA1 sha1;
+
+    sha1.restore(this->inner, SHA1::BlockSize);
+    sha1.update(message, length);
+    sha1.finalize(digest);
+
+    sha1.restore(this->outer, SHA1::BlockSize);
+    sha1.update(digest, sizeof(digest));
+    sha1.finalize(out);
+
+    // the inner digest and the hasher are derived from the inner midstate, as in iterate()
+    secureZero(digest, sizeof(digest));
+    secureZero(&sha1, sizeof(sha1));
+}
+
+
+
+
+bool HMACSHA1::verify(const uint8_t* message, size_t length, const uint8_t* tag) const
+{
+    uint8_t expected[SHA1::DigestSize];
+    mac(message, length, expected);
+    bool valid = sha1DigestsEqual(expected, tag);
+    secureZero(expected, sizeof(expected));
+    return valid;
+}
+
+
+
+
+/* Function: verifyMany
+ * Parameters: The messages, their lengths and their tags, the pair count, the bitmask, the thread count
+ * Return: None
+ * Description: Each group of 64 pairs hashes its messages from the inner midstate and then their inner digests from the outer
+ *              midstate, both with sha1DigestMany, and folds the constant time comparisons into its bitmask word without a branch.
+ *              The expected tags are wiped afterwards: the tag of a message an attacker chose is a forgery.
+*/
+void HMACSHA1::verifyMany(const uint8_t* const* messages, const size_t* lengths, const uint8_t* const* tags, size_t count,
+                          uint64_t* valid, unsigned threads) const
+{
+    PERF_BATCH_SCOPE("HMACSHA1::verifyMany", count);
+
+    const size_t Group = 64;
+    parallelFor((count + Group - 1) / Group, threads, [&](size_t g)
+    {
+        size_t first = g * Group;
+        size_t used = min(Group, count - first);
+
+        uint8_t innerDigests[Group * SHA1::DigestSize];
+        uint8_t expected[Group * SHA1::DigestSize];
+        const uint8_t* pointers[Group];
+        size_t digestLengths[Group];
+
+        sha1DigestMany(this->inner, SHA1::BlockSize, messages + first, lengths + first, used, innerDigests);
+        for(size_t i = 0; i < used; i++)
+        {
+            pointers[i] = innerDigests + SHA1::DigestSize * i;
+            digestLengths[i] = SHA1::DigestSize;
+        }
+        sha1DigestMany(this->outer, SHA1::BlockSize, pointers, digestLengths, used, expected);
+
+        uint64_t mask = 0;
+        for(size_t i = 0; i < used; i++)
+        {
+            mask |= static_cast<uint64_t>( sha1DigestsEqual(expected + SHA1::DigestSize * i, tags[first + i]) ) << i;
+        }
+        valid[g] = mask;
+
+        secureZero(expected, sizeof(expected));
+    });
+}
+
+
+
+
+/* Function: iterate
+ * Parameters: The HMAC midstates, U (U_1 on entry), T (U_1 on entry), the number of further iterations
+ * Return: None
+ * Description: The scalar PBKDF2 loop: U_(j+1) = HMAC(P, U_j) and T ^= U_(j+1). The 20 byte U always fills the same padded block,
+ *              so each iteration is one compression from the inner midstate and one from the outer.
+*/
+static void iterate(const uint32_t* inner, const uint32_t* outer, uint32_t* U, uint32_t* T, uint32_t iterations)
+{
+    // U, a '1' bit, zeros, and the length of the key block plus U in bits
+    uint8_t block[SHA1::BlockSize] = {};
+    block[20] = 0x80;
+    block[62] = static_cast<uint8_t>( ((64 + 20) * 8) >> 8 );
+    block[63] = static_cast<uint8_t>( (64 + 20) * 8 );
+
+    SHA1 sha1;
+
+    auto compress = [&](const uint32_t* midstate)
+    {
+        for(int i = 0; i < 5; i++)
+        {
+            block[4 * i] = static_cast<uint8_t>( U[i] >> 24 );
+            block[4 * i + 1] = static_cast<uint8_t>( U[i] >> 16 );
+            block[4 * i + 2] = static_cast<uint8_t>( U[i] >> 8 );
+            block[4 * i + 3] = static_cast<uint8_t>( U[i] );
+        }
+
+        sha1.restore(midstate, SHA1::BlockSize);
+        sha1.processBlocks(block, 1);
+
+        U[0] = sha1.H0;
+        U[1] = sha1.H1;
+        U[2] = sha1.H2;
+        U[3] = sha1.H3;
+        U[4] = sha1.H4;
+    };
+
+    for(uint32_t n = 0; n < iterations; n++)
+    {
+        compress(inner);
+        compress(outer);
+
+        for(int i = 0; i < 5; i++)
+        {
+            T[i] ^= U[i];
+        }
+    }
+
+    secureZero(block, sizeof(block));
+    secureZero(&sha1, sizeof(sha1));
+}
+
+
+
+
+void pbkdf2HmacSha1Batch(const uint8_t* const* passwords, const size_t* passwordLengths, size_t count, const uint8_t* salt,
+                         size_t saltLength, uint32_t iterations, uint8_t* out, size_t outLength, unsigned threads)
+{
+    if(iterations == 0 || outLength == 0)
+    {
+        throw invalid_argument("PBKDF2 needs at least one iteration and one byte of output");
+    }
+
+    PERF_BATCH_SCOPE("pbkdf2HmacSha1Batch", count);
+
+    // one chain per (password, output block): T_i = U_1 ^ ... ^ U_c with U_1 = HMAC(P, S || INT(i))
+    size_t blocks = (outLength + SHA1::DigestSize - 1) / SHA1::DigestSize;
+    size_t chains = count * blocks;
+
+    struct Chain
+    {
+        uint32_t inner[5];
+        uint32_t outer[5];
+        uint32_t U[5];
+        uint32_t T[5];
+    };
+    vector<Chain> chain(chains);
+
+    parallelFor(count, threads, [&](size_t p)
+    {
+        HMACSHA1 hmac(passwords[p], passwordLengths[p]);
+
+        vector<uint8_t> message(salt, salt + saltLength);
+        message.resize(saltLength + 4);
+
+        for(size_t b = 0; b < blocks; b++)
+        {
+            uint32_t index = static_cast<uint32_t>( b + 1 );
+            message[saltLength] = static_cast<uint8_t>( index >> 24 );
+            message[saltLength + 1] = static_cast<uint8_t>( index >> 16 );
+            message[saltLength + 2] = static_cast<uint8_t>( index >> 8 );
+            message[saltLength + 3] = static_cast<uint8_t>( index );
+
+            uint8_t U1[SHA1::DigestSize];
+            hmac.mac(message.data(), message.size(), U1);
+
+            Chain& c = chain[p * blocks + b];
+            for(int i = 0; i < 5; i++)
+            {
+                c.inner[i] = hmac.innerState()[i];
+                c.outer[i] = hmac.outerState()[i];
+                c.U[i] = (uint32_t(U1[4 * i]) << 24) | (uint32_t(U1[4 * i + 1]) << 16) | (uint32_t(U1[4 * i + 2]) << 8) | U1[4 * i + 3];
+                c.T[i] = c.U[i];
+            }
+            secureZero(U1, sizeof(U1));
+        }
+    });
+
+    // the remaining iterations, eight chains per AVX2 group; a lone chain is not worth a group
+    const size_t Lanes = 8;
+    bool lanes = cpuFeatures().avx2;
+    size_t groups = (chains + Lanes - 1) / Lanes;
+
+    parallelFor(groups, threads, [&](size_t g)
+    {
+        size_t first = g * Lanes;
+        size_t used = min(Lanes, chains - first);
+
+        if(lanes && used > 1)
+        {
+            // transpose into x[8 * word + lane]; unused lanes repeat the last chain
+            uint32_t inner[5 * Lanes], outer[5 * Lanes], U[5 * Lanes], T[5 * Lanes];
+            for(size_t l = 0; l < Lanes; l++)
+            {
+                const Chain& c = chain[first + min(l, used - 1)];
+                for(int i = 0; i < 5; i++)
+                {
+                    inner[Lanes * i + l] = c.inner[i];
+                    outer[Lanes * i + l] = c.outer[i];
+                    U[Lanes * i + l] = c.U[i];
+                    T[Lanes * i + l] = c.T[i];
+                }
+            }
+
+            bool done = sha1Avx2Pbkdf2(inner, outer, U, T, iterations - 1) == Lanes;
+            if(done)
+            {
+                for(size_t l = 0; l < used; l++)
+                {
+                    for(int i = 0; i < 5; i++)
+                    {
+                        chain[first + l].T[i] = T[Lanes * i + l];
+                    }
+                }
+            }
+
+            secureZero(inner, sizeof(inner));
+            secureZero(outer, sizeof(outer));
+            secureZero(U, sizeof(U));
+            secureZero(T, sizeof(T));
+            if(done)
+            {
+                return;
+            }
+        }
+
+        for(size_t l = 0; l < used; l++)
+        {
+            Chain& c = chain[first + l];
+            iterate(c.inner, c.outer, c.U, c.T, iterations - 1);
+        }
+    });
+
+    // DK = T_1 || T_2 || ... truncated to outLength
+    for(size_t p = 0; p < count; p++)
+    {
+        uint8_t* key = out + p * outLength;
+        for(size_t n = 0; n < outLength; n++)
+        {
+            const Chain& c = chain[p * blocks + n / SHA1::DigestSize];
+            size_t byte = n % SHA1::DigestSize;
+            key[n] = static_cast<uint8_t>( c.T[byte / 4] >> (24 - 8 * (byte % 4)) );
+        }
+    }
+
+    // the midstates stand in for the passwords and T is the derived key
+    secureZero(chain.data(), chain.size() * sizeof(Chain));
+}
+
+
+
+
+void pbkdf2HmacSha1(const uint8_t* password, size_t passwordLength, const uint8_t* salt, size_t saltLength, uint32_t iterations,
+                    uint8_t* out, size_t outLength, unsigned threads)
+{
+    pbkdf2HmacSha1Batch(&password, &passwordLength, 1, salt, saltLength, iterations, out, outLength, threads);
+}
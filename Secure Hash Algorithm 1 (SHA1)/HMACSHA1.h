@@ -0,0 +1,66 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file declares HMAC-SHA1 (RFC 2104) and PBKDF2-HMAC-SHA1 (RFC 8018 section 5.2).
+ *
+ *                  The key only ever enters HMAC through two blocks, K ^ ipad and K ^ opad, so both are compressed once when
+ *                  the key is set and the resulting hash values (midstates) are kept. Every MAC then starts from them, and a
+ *                  PBKDF2 iteration, which MACs a 20 byte value, costs exactly two compressions.
+ *
+ *                  PBKDF2 runs its independent chains (the output blocks of one password, or many candidate passwords) side by
+ *                  side in AVX2 lanes, eight at a time, and spreads groups of lanes across threads.
+*/
+
+#ifndef HMAC_SHA1_H
+#define HMAC_SHA1_H
+
+#include "SHA1.h"
+#include "../Common/SecureMemory.h"
+
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+class HMACSHA1
+{
+    public:
+        static const size_t DigestSize = SHA1::DigestSize;
+
+        HMACSHA1(const uint8_t* key, size_t keyLength);
+        ~HMACSHA1() { secureZero(inner, sizeof(inner)); secureZero(outer, sizeof(outer)); } // the midstates are as good as the key
+
+        void mac(const uint8_t* message, size_t length, uint8_t* out) const; // writes the 20 byte tag
+
+        // whether tag is the 20 byte tag of the message, compared in constant time
+        bool verify(const uint8_t* message, size_t length, const uint8_t* tag) const;
+
+        // verifies count (message, tag) pairs; bit i % 64 of valid[i / 64] is set when tags[i] is right. The messages go
+        // through sha1DigestMany in groups of 64, one group per bitmask word, spread over threads (0 = one per core).
+        void verifyMany(const uint8_t* const* messages, const size_t* lengths, const uint8_t* const* tags, size_t count,
+                        uint64_t* valid, unsigned threads = 0) const;
+
+        // the hash values after the K ^ ipad and K ^ opad blocks
+        const uint32_t* innerState() const { return inner; }
+        const uint32_t* outerState() const { return outer; }
+
+    private:
+        uint32_t inner[5];
+        uint32_t outer[5];
+
+};
+
+
+// DK = PBKDF2-HMAC-SHA1(password, salt, iterations, outLength); throws invalid_argument if iterations or outLength is 0
+void pbkdf2HmacSha1(const uint8_t* password, size_t passwordLength, const uint8_t* salt, size_t saltLength, uint32_t iterations,
+                    uint8_t* out, size_t outLength, unsigned threads = 1);
+
+// one derived key per candidate password, all with the same salt and iteration count; key i is written to out + i * outLength.
+// threads = 0 uses one per core.
+void pbkdf2HmacSha1Batch(const uint8_t* const* passwords, const size_t* passwordLengths, size_t count, const uint8_t* salt,
+                         size_t saltLength, uint32_t iterations, uint8_t* out, size_t outLength, unsigned threads = 0);
+
+
+#endif
@@ -1,31 +1,27 @@
 #include "SHA1.h"
+#include "SHA1Kernels.h"
+#include "../Common/CpuFeatures.h"
+#include "../Common/HexCodec.h"
+#include "../Common/PerfCounters.h"
 
-string SHA1::pad_message(string message)
-{
-    uint64_t originalLength = message.length() * 8;
+#include <algorithm>
+#include <cstring>
 
-    // append a single '1' bit
-    string paddedMessage = message + static_cast<char>(0x80);
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
-    size_t paddingLength = (448 - ((originalLength + 8) % 512) + 512) % 512;
 
-    // append the 0s
-    for(int i = 0; i < paddingLength; i+=8)
-    {
-        paddedMessage += static_cast<char>(0x00);
-    }
+SHA1::SHA1()
+{
+    reset();
+}
 
-    // append the bytes of the 64 bit original length 
-    paddedMessage += static_cast<char>((originalLength >> 56) & 0xFF);
-    paddedMessage += static_cast<char>((originalLength >> 48) & 0xFF);
-    paddedMessage += static_cast<char>((originalLength >> 40) & 0xFF);
-    paddedMessage += static_cast<char>((originalLength >> 32) & 0xFF);
-    paddedMessage += static_cast<char>((originalLength >> 24) & 0xFF);
-    paddedMessage += static_cast<char>((originalLength >> 16) & 0xFF);
-    paddedMessage += static_cast<char>((originalLength >> 8) & 0xFF);
-    paddedMessage += static_cast<char>(originalLength & 0xFF);
 
-    return paddedMessage;
+// the padding is shared with the other Merkle-Damgard hashes
+string SHA1::pad_message(string message)
+{
+    return padMessage(message);
 }
 
 
@@ -80,11 +76,7 @@ void SHA1::processBlocks(string& paddedMessage)
     this->H3 = 0x10325476;
     this->H4 = 0xC3D2E1F0;
 
-    for(int i = 0; i < paddedMessage.length(); i+=64)
-    {
-        string block = paddedMessage.substr(i, 64);
-        processBlock(block);
-    }
+    processBlocks(reinterpret_cast<const uint8_t*>(paddedMessage.data()), paddedMessage.length() / 64);
 }
 
 
@@ -93,17 +85,60 @@ void SHA1::processBlocks(string& paddedMessage)
 // process the block
 void SHA1::processBlock(string& block) // this is coming in at 64 bytes (512 bits)
 {
+    processBlocks(reinterpret_cast<const uint8_t*>(block.data()), 1);
+}
+
+
+
+
+// process count consecutive blocks; the SHA-NI kernel keeps the hash value in registers across all of them
+void SHA1::processBlocks(const uint8_t* blocks, size_t count)
+{
+    const CpuFeatures& cpu = cpuFeatures();
+
+    if(cpu.sha && cpu.sse41)
+    {
+        PERF_BATCH_SCOPE("SHA1::processBlocks(SHA-NI)", count);
+
+        uint32_t H[5] = { this->H0, this->H1, this->H2, this->H3, this->H4 };
+        size_t done = sha1ShaniCompress(H, blocks, count);
+
+        this->H0 = H[0];
+        this->H1 = H[1];
+        this->H2 = H[2];
+        this->H3 = H[3];
+        this->H4 = H[4];
+
+        blocks += 64 * done;
+        count -= done;
+    }
+
+    for(size_t i = 0; i < count; i++)
+    {
+        processBlock(blocks + 64 * i);
+    }
+}
+
+
+
+
+// process a 64 byte (512 bit) block read straight from a caller-owned buffer
+CRYPTO_MULTIVERSION
+void SHA1::processBlock(const uint8_t* block)
+{
+    PERF_SCOPE("SHA1::processBlock");
+
     // prepare the message schedule
-    vector<uint32_t> W(80); // of size 80
+    uint32_t W[80];
 
     // populate first 16 words 
     for(int t = 0; t < 16; t++)
     {
         // 0 <= t <= 15
-        W[t] = (static_cast<uint8_t>(block[t * 4]) << 24) |
-                 (static_cast<uint8_t>(block[t * 4 + 1]) << 16) |
-                 (static_cast<uint8_t>(block[t * 4 + 2]) << 8) |
-                 static_cast<uint8_t>(block[t * 4 + 3]);
+        W[t] = (static_cast<uint32_t>(block[t * 4]) << 24) |
+                 (static_cast<uint32_t>(block[t * 4 + 1]) << 16) |
+                 (static_cast<uint32_t>(block[t * 4 + 2]) << 8) |
+                 static_cast<uint32_t>(block[t * 4 + 3]);
     }
 
     // expand the word schedule to 80
@@ -168,14 +203,18 @@ void SHA1::processBlock(string& block) // this is coming in at 64 bytes (512 bit
 
 string SHA1::getHash()
 {
-    ostringstream oss;
-    oss << hex << setfill('0') << setw(8) << this->H0
-               << setw(8) << this->H1
-               << setw(8) << this->H2
-               << setw(8) << this->H3
-               << setw(8) << this->H4;
+    const uint32_t H[5] = { this->H0, this->H1, this->H2, this->H3, this->H4 };
+
+    uint8_t digest[DigestSize];
+    for(int i = 0; i < 5; i++)
+    {
+        digest[4 * i] = static_cast<uint8_t>( H[i] >> 24 );
+        digest[4 * i + 1] = static_cast<uint8_t>( H[i] >> 16 );
+        digest[4 * i + 2] = static_cast<uint8_t>( H[i] >> 8 );
+        digest[4 * i + 3] = static_cast<uint8_t>( H[i] );
+    }
 
-    return oss.str(); 
+    return hexEncode(digest, DigestSize);
 }
 
 
@@ -186,4 +225,293 @@ string SHA1::digest(string message)
     string paddedMessage = pad_message(message);
     processBlocks(paddedMessage);
     return getHash();
-}
\ No newline at end of file
+}
+
+
+
+
+// start a new message
+void SHA1::reset()
+{
+    this->H0 = 0x67452301;
+    this->H1 = 0xEFCDAB89;
+    this->H2 = 0x98BADCFE;
+    this->H3 = 0x10325476;
+    this->H4 = 0xC3D2E1F0;
+
+    resetStream();
+}
+
+
+
+
+// resume a message from a saved hash value
+void SHA1::restore(const uint32_t* H, uint64_t length)
+{
+    this->H0 = H[0];
+    this->H1 = H[1];
+    this->H2 = H[2];
+    this->H3 = H[3];
+    this->H4 = H[4];
+
+    resumeStream(length);
+}
+
+
+
+
+// pad the final block as pad_message does and write the big-endian digest H0 || H1 || H2 || H3 || H4
+void SHA1::finalize(uint8_t* digest)
+{
+    finishStream();
+
+    const uint32_t H[5] = { this->H0, this->H1, this->H2, this->H3, this->H4 };
+    for(int i = 0; i < 5; i++)
+    {
+        digest[4 * i] = static_cast<uint8_t>( H[i] >> 24 );
+        digest[4 * i + 1] = static_cast<uint8_t>( H[i] >> 16 );
+        digest[4 * i + 2] = static_cast<uint8_t>( H[i] >> 8 );
+        digest[4 * i + 3] = static_cast<uint8_t>( H[i] );
+    }
+}
+
+
+
+
+// compression of count consecutive blocks into a bare hash value, through the streaming object's dispatch
+static void compressBlocks(uint32_t* H, const uint8_t* blocks, size_t count)
+{
+    SHA1 sha1;
+    sha1.restore(H, 0);
+    sha1.processBlocks(blocks, count);
+    H[0] = sha1.H0;
+    H[1] = sha1.H1;
+    H[2] = sha1.H2;
+    H[3] = sha1.H3;
+    H[4] = sha1.H4;
+}
+
+
+static void storeDigest(const uint32_t* H, uint8_t* digest)
+{
+    for(int i = 0; i < 5; i++)
+    {
+        digest[4 * i] = static_cast<uint8_t>( H[i] >> 24 );
+        digest[4 * i + 1] = static_cast<uint8_t>( H[i] >> 16 );
+        digest[4 * i + 2] = static_cast<uint8_t>( H[i] >> 8 );
+        digest[4 * i + 3] = static_cast<uint8_t>( H[i] );
+    }
+}
+
+
+/* Function: digestLanes
+ * Parameters: The starting hash value, the bytes it already covers, the messages and their lengths, the message count, the output
+ * Return: None
+ * Description: The lane scheduler of sha256DigestMany with eight SHA1 lanes. Each lane walks its message's whole blocks in place
+ *              and then one or two padded tail blocks built here; every kernel call runs as many blocks as the shortest run left
+ *              in any lane, a lane that finishes is refilled with the next message straight away, and lanes without a message
+ *              shadow an active one. The last message in flight is finished on its own.
+*/
+static void digestLanes(const uint32_t* H, uint64_t prefix, const uint8_t* const* messages, const size_t* lengths, size_t count,
+                        uint8_t* digests)
+{
+    const size_t Lanes = 8;
+    const size_t B = SHA1::BlockSize;
+
+    struct Lane
+    {
+        bool active;
+        size_t message;
+        size_t fullBlocks; // whole blocks read in place from the message
+        size_t totalBlocks; // fullBlocks plus one or two padded tail blocks
+        size_t done; // blocks compressed so far
+        uint8_t tail[2 * SHA1::BlockSize];
+
+        const uint8_t* position(const uint8_t* data) const
+        {
+            return done < fullBlocks ? data + SHA1::BlockSize * done : tail + SHA1::BlockSize * (done - fullBlocks);
+        }
+
+        size_t run() const // blocks left before the next switch between message and tail
+        {
+            return done < fullBlocks ? fullBlocks - done : totalBlocks - done;
+        }
+    };
+
+    Lane lanes[Lanes];
+    uint32_t state[5 * Lanes];
+    size_t next = 0;
+
+    auto assign = [&](size_t l)
+    {
+        Lane& lane = lanes[l];
+        lane.active = next < count;
+        if(!lane.active)
+        {
+            return;
+        }
+
+        lane.message = next++;
+        size_t length = lengths[lane.message];
+        size_t remainder = length % B;
+
+        lane.fullBlocks = length / B;
+        lane.done = 0;
+
+        // a '1' bit, zeros, then the length in bits of the prefix and the message
+        size_t tailBlocks = remainder + 1 + 8 > B ? 2 : 1;
+        lane.totalBlocks = lane.fullBlocks + tailBlocks;
+        memset(lane.tail, 0, sizeof(lane.tail));
+        if(remainder > 0) // an empty message may come with a null pointer
+        {
+            memcpy(lane.tail, messages[lane.message] + B * lane.fullBlocks, remainder);
+        }
+        lane.tail[remainder] = 0x80;
+
+        uint8_t* end = lane.tail + B * tailBlocks;
+        uint64_t bits = (prefix + length) << 3;
+        for(int i = 0; i < 8; i++)
+        {
+            end[-1 - i] = static_cast<uint8_t>( bits >> (8 * i) );
+        }
+
+        for(int w = 0; w < 5; w++)
+        {
+            state[Lanes * w + l] = H[w];
+        }
+    };
+
+    auto laneState = [&](size_t l, uint32_t* out)
+    {
+        for(int w = 0; w < 5; w++)
+        {
+            out[w] = state[Lanes * w + l];
+        }
+    };
+
+    for(size_t l = 0; l < Lanes; l++)
+    {
+        assign(l);
+    }
+
+    while(true)
+    {
+        size_t active = 0;
+        size_t first = 0;
+        size_t run = SIZE_MAX;
+        for(size_t l = Lanes; l-- > 0; )
+        {
+            if(lanes[l].active)
+            {
+                active++;
+                first = l;
+                run = min(run, lanes[l].run());
+            }
+        }
+
+        if(active == 0)
+        {
+            return;
+        }
+
+        if(active == 1)
+        {
+            // no messages left to refill the other lanes; finish the last one with the single message code
+            Lane& lane = lanes[first];
+            uint32_t last[5];
+            laneState(first, last);
+            const uint8_t* data = messages[lane.message];
+            if(lane.done < lane.fullBlocks)
+            {
+                compressBlocks(last, data + B * lane.done, lane.fullBlocks - lane.done);
+                lane.done = lane.fullBlocks;
+            }
+            compressBlocks(last, lane.tail + B * (lane.done - lane.fullBlocks), lane.totalBlocks - lane.done);
+            storeDigest(last, digests + SHA1::DigestSize * lane.message);
+            return;
+        }
+
+        const uint8_t* pointers[Lanes];
+        for(size_t l = 0; l < Lanes; l++)
+        {
+            size_t source = lanes[l].active ? l : first;
+            pointers[l] = lanes[source].position(messages[lanes[source].message]);
+        }
+
+        sha1Avx2MultiBuffer(state, pointers, run);
+
+        for(size_t l = 0; l < Lanes; l++)
+        {
+            if(!lanes[l].active)
+            {
+                continue;
+            }
+
+            lanes[l].done += run;
+            if(lanes[l].done == lanes[l].totalBlocks)
+            {
+                uint32_t finished[5];
+                laneState(l, finished);
+                storeDigest(finished, digests + SHA1::DigestSize * lanes[l].message);
+                assign(l);
+            }
+        }
+    }
+}
+
+
+
+
+void sha1DigestMany(const uint32_t* H, uint64_t prefix, const uint8_t* const* messages, const size_t* lengths, size_t count,
+                    uint8_t* digests)
+{
+    PERF_BATCH_SCOPE("sha1DigestMany", count);
+
+    // unlike SHA-256, SHA1 has cheap enough rounds that eight AVX2 lanes outrun SHA-NI on one message at a time (1.6x on
+    // 16 KiB messages, 2x on 16 bytes), so the multi-buffer kernel is used whenever there is more than one message
+    if(cpuFeatures().avx2 && count > 1)
+    {
+        digestLanes(H, prefix, messages, lengths, count, digests);
+        return;
+    }
+
+    SHA1 sha1;
+    for(size_t i = 0; i < count; i++)
+    {
+        sha1.restore(H, prefix);
+        sha1.update(messages[i], lengths[i]);
+        sha1.finalize(digests + SHA1::DigestSize * i);
+    }
+}
+
+
+void SHA1::digestMany(const uint8_t* const* messages, const size_t* lengths, size_t count, uint8_t* digests)
+{
+    const uint32_t IV[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    sha1DigestMany(IV, 0, messages, lengths, count, digests);
+}
+
+
+
+
+// every byte of both digests is read and folded into one vector whatever they hold, so the time taken says nothing about where
+// they first differ
+bool sha1DigestsEqual(const uint8_t* a, const uint8_t* b)
+{
+#if defined(__SSE2__)
+    uint32_t lastA, lastB;
+    memcpy(&lastA, a + 16, 4);
+    memcpy(&lastB, b + 16, 4);
+
+    __m128i difference = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+    difference = _mm_or_si128(difference, _mm_cvtsi32_si128(static_cast<int>( lastA ^ lastB )));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(difference, _mm_setzero_si128())) == 0xFFFF;
+#else
+    volatile uint8_t difference = 0;
+    for(size_t i = 0; i < SHA1::DigestSize; i++)
+    {
+        difference = difference | (a[i] ^ b[i]);
+    }
+    return difference == 0;
+#endif
+}
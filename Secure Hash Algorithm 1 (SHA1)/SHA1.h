@@ -2,16 +2,24 @@
 #define SHA1_H
 
 #include <cstdint>
+#include <cstddef>
 #include <string>
 #include <vector>
 #include <sstream>
 #include <iomanip>
 
+#include "../Common/MerkleDamgard.h"
+
 using namespace std;
 
-class SHA1
+// 512 bit message blocks with a 64 bit length field; update() and the one-shot digest() come from MerkleDamgard
+class SHA1 : public MerkleDamgard<SHA1, 64, 8>
 {
     public:
+        static const size_t DigestSize = 20; // 160 bit message digest
+
+        SHA1();
+
         // K[t] is the constance value to be used for the iteration t of the hash computation
         const uint32_t K[4] = 
         {
@@ -29,6 +37,8 @@ class SHA1
         
         void processBlocks(string&);
         void processBlock(string&);
+        void processBlock(const uint8_t*);
+        void processBlocks(const uint8_t*, size_t); // count consecutive 64 byte blocks; uses SHA-NI when available
 
         uint32_t Ch(uint32_t, uint32_t, uint32_t);
         uint32_t Maj(uint32_t, uint32_t, uint32_t);
@@ -37,7 +47,28 @@ class SHA1
         string getHash();
         string digest(string);
 
+        // Incremental interface on raw bytes: reset(), update() any number of times, then finalize()
+        void reset();
+        void finalize(uint8_t*); // writes the 20 byte digest
+        using MerkleDamgard::digest; // one-shot: reset, update, finalize
+
+        // Continue from a saved hash value H[0..4] covering the first length bytes of the message, a whole number of
+        // blocks (for example an HMAC midstate after the padded key block)
+        void restore(const uint32_t* H, uint64_t length);
+
+        // hash count messages at once; digest i is written to digests + 20 * i
+        static void digestMany(const uint8_t* const* messages, const size_t* lengths, size_t count, uint8_t* digests);
+
 };
 
 
+// digestMany from a saved hash value H[0..4] covering prefix bytes, a whole number of blocks: eight messages at a time in AVX2
+// lanes, or one after the other without AVX2
+void sha1DigestMany(const uint32_t* H, uint64_t prefix, const uint8_t* const* messages, const size_t* lengths, size_t count,
+                    uint8_t* digests);
+
+// compares two 20 byte digests in constant time
+bool sha1DigestsEqual(const uint8_t* a, const uint8_t* b);
+
+
 #endif
\ No newline at end of file
@@ -0,0 +1,290 @@
+#include "SHA1File.h"
+#include "../Common/Parallel.h"
+#include "../Common/PerfCounters.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+static const size_t MapWindow = 4 << 20; // bytes hashed between madvise calls on a mapping
+static const size_t ReadBuffer = 1 << 20; // size of each of the two read buffers
+static const size_t DirectAlignment = 4096; // O_DIRECT buffer, offset and length alignment
+
+
+static runtime_error ioError(const string& what, const string& path)
+{
+    return runtime_error(what + " " + path + ": " + strerror(errno));
+}
+
+
+// closes the descriptor on every exit path
+struct FileDescriptor
+{
+    int fd;
+
+    explicit FileDescriptor(int fd) : fd(fd) {}
+    ~FileDescriptor()
+    {
+        if(fd > 2)
+        {
+            close(fd);
+        }
+    }
+};
+
+
+/* Function: hashMapped
+ * Parameters: The open file, its size, the hasher
+ * Return: None
+ * Description: Maps the file and hashes it a window at a time. The kernel is told to read ahead the next window while the
+ *              current one is hashed, and windows already hashed are released so the resident set stays at a few windows
+ *              regardless of file size.
+*/
+static void hashMapped(int fd, const string& path, uint64_t size, SHA1& sha1)
+{
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(mapping == MAP_FAILED)
+    {
+        throw ioError("cannot map", path);
+    }
+
+    const uint8_t* data = static_cast<const uint8_t*>( mapping );
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    for(uint64_t offset = 0; offset < size; offset += MapWindow)
+    {
+        size_t length = static_cast<size_t>( min<uint64_t>(MapWindow, size - offset) );
+
+        uint64_t next = offset + MapWindow;
+        if(next < size)
+        {
+            madvise(const_cast<uint8_t*>( data ) + next, static_cast<size_t>( min<uint64_t>(MapWindow, size - next) ), MADV_WILLNEED);
+        }
+
+        sha1.update(data + offset, length);
+
+        if(offset >= MapWindow)
+        {
+            madvise(const_cast<uint8_t*>( data ) + offset - MapWindow, MapWindow, MADV_DONTNEED);
+        }
+    }
+
+    munmap(mapping, size);
+}
+
+
+/* Function: hashBuffered
+ * Parameters: The open file, whether it was opened with O_DIRECT, the hasher
+ * Return: The number of bytes hashed
+ * Description: Two aligned buffers alternate between a reader thread and the hashing thread. The reader fills buffer i while
+ *              buffer i ^ 1 is hashed, so the disk and the compression function run at the same time. A buffer is handed
+ *              over by setting its length (or -1 for end of file) under the mutex.
+*/
+static uint64_t hashBuffered(int fd, const string& path, bool direct, SHA1& sha1)
+{
+    struct Slot
+    {
+        uint8_t* data;
+        ssize_t length; // bytes ready to hash, 0 while empty, -1 at end of file
+    };
+
+    unique_ptr<uint8_t, void(*)(void*)> memory(static_cast<uint8_t*>( aligned_alloc(DirectAlignment, 2 * ReadBuffer) ), free);
+    if(!memory)
+    {
+        throw bad_alloc();
+    }
+
+    Slot slots[2] = {{memory.get(), 0}, {memory.get() + ReadBuffer, 0}};
+    mutex lock;
+    condition_variable filled, drained;
+    int readErrno = 0;
+
+    thread reader([&]()
+    {
+        uint64_t offset = 0;
+        for(int i = 0; ; i ^= 1)
+        {
+            {
+                unique_lock<mutex> guard(lock);
+                drained.wait(guard, [&]() { return slots[i].length == 0; });
+            }
+
+            // fill the whole buffer unless the file ends; pipes and O_DIRECT can both return short reads
+            size_t have = 0;
+            int error = 0;
+            while(have < ReadBuffer)
+            {
+                ssize_t n = direct ? pread(fd, slots[i].data + have, ReadBuffer - have, offset + have)
+                                   : read(fd, slots[i].data + have, ReadBuffer - have);
+                if(n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if(n < 0)
+                {
+                    error = errno;
+                    break;
+                }
+                if(n == 0)
+                {
+                    break;
+                }
+                have += static_cast<size_t>( n );
+
+                // an O_DIRECT read that stops short of an aligned length has reached the end of the file
+                if(direct && have % DirectAlignment != 0)
+                {
+                    break;
+                }
+            }
+            offset += have;
+
+            unique_lock<mutex> guard(lock);
+            readErrno = error;
+            if(have > 0)
+            {
+                slots[i].length = static_cast<ssize_t>( have );
+                filled.notify_one();
+                if(have == ReadBuffer && error == 0)
+                {
+                    continue;
+                }
+                // a final partial buffer: the end marker goes into the other slot once it is free
+                i ^= 1;
+                drained.wait(guard, [&]() { return slots[i].length == 0; });
+            }
+            slots[i].length = -1;
+            filled.notify_one();
+            return;
+        }
+    });
+
+    uint64_t bytes = 0;
+    for(int i = 0; ; i ^= 1)
+    {
+        ssize_t length;
+        {
+            unique_lock<mutex> guard(lock);
+            filled.wait(guard, [&]() { return slots[i].length != 0; });
+            length = slots[i].length;
+        }
+        if(length < 0)
+        {
+            break;
+        }
+
+        sha1.update(slots[i].data, static_cast<size_t>( length ));
+        bytes += static_cast<uint64_t>( length );
+
+        lock_guard<mutex> guard(lock);
+        slots[i].length = 0;
+        drained.notify_one();
+    }
+
+    reader.join();
+    if(readErrno != 0)
+    {
+        errno = readErrno;
+        throw ioError("cannot read", path);
+    }
+    return bytes;
+}
+
+
+uint64_t sha1File(const string& path, uint8_t* digest, SHA1FileMode mode)
+{
+    PERF_SCOPE("sha1File");
+
+    bool standardInput = path == "-";
+    int flags = O_RDONLY | O_CLOEXEC;
+    bool direct = false;
+
+#ifdef O_DIRECT
+    if(mode == SHA1FileMode::Direct && !standardInput)
+    {
+        flags |= O_DIRECT;
+        direct = true;
+    }
+#endif
+
+    int fd = standardInput ? STDIN_FILENO : open(path.c_str(), flags);
+    if(fd < 0 && direct)
+    {
+        // file systems such as tmpfs refuse O_DIRECT
+        fd = open(path.c_str(), flags & ~O_DIRECT);
+        direct = false;
+    }
+    if(fd < 0)
+    {
+        throw ioError("cannot open", path);
+    }
+    FileDescriptor file(fd);
+
+    struct stat info;
+    if(fstat(fd, &info) != 0)
+    {
+        throw ioError("cannot stat", path);
+    }
+
+    bool regular = S_ISREG(info.st_mode);
+    if(mode == SHA1FileMode::Mapped && !regular)
+    {
+        throw runtime_error("cannot map " + path + ": not a regular file");
+    }
+
+    SHA1 sha1;
+    uint64_t bytes;
+
+    if(mode == SHA1FileMode::Mapped || (mode == SHA1FileMode::Auto && regular && info.st_size > 0))
+    {
+        bytes = static_cast<uint64_t>( info.st_size );
+        if(bytes > 0)
+        {
+            hashMapped(fd, path, bytes, sha1);
+        }
+    }
+    else
+    {
+        bytes = hashBuffered(fd, path, direct, sha1);
+    }
+
+    sha1.finalize(digest);
+    return bytes;
+}
+
+
+vector<SHA1FileResult> sha1Files(const vector<string>& paths, SHA1FileMode mode, unsigned threads)
+{
+    vector<SHA1FileResult> results(paths.size());
+
+    // one file per work item, so one large file does not hold up the rest
+    parallelFor(paths.size(), threads, [&](size_t i)
+    {
+        SHA1FileResult& result = results[i];
+        result.path = paths[i];
+        result.bytes = 0;
+        memset(result.digest, 0, sizeof(result.digest));
+        try
+        {
+            result.bytes = sha1File(paths[i], result.digest, mode);
+        }
+        catch(const exception& e)
+        {
+            result.error = e.what();
+        }
+    });
+
+    return results;
+}
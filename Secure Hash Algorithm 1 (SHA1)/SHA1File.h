@@ -0,0 +1,46 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file declares file hashing on top of the SHA1 incremental interface. The file is never loaded whole:
+ *                  it is either memory mapped and fed to SHA1::update a window at a time, or read with two alternating buffers
+ *                  so that a reader thread fills one buffer while the other is being hashed. Several files can be hashed
+ *                  concurrently, one file per thread.
+*/
+
+#ifndef SHA1_FILE_H
+#define SHA1_FILE_H
+
+#include "SHA1.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+enum class SHA1FileMode
+{
+    Auto,       // mmap for regular files, double-buffered reads for pipes and devices
+    Mapped,     // mmap the whole file
+    Buffered,   // double-buffered pread through the page cache
+    Direct      // double-buffered pread with O_DIRECT, bypassing the page cache (falls back to Buffered where unsupported)
+};
+
+struct SHA1FileResult
+{
+    string path;
+    uint8_t digest[SHA1::DigestSize];
+    uint64_t bytes;     // bytes hashed
+    string error;       // empty on success
+};
+
+// Hashes one file ("-" is standard input). Returns the number of bytes hashed; throws runtime_error on I/O errors.
+uint64_t sha1File(const string& path, uint8_t* digest, SHA1FileMode mode = SHA1FileMode::Auto);
+
+// Hashes every file in paths, up to threads at a time (0 = one per core). Errors are reported per file, not thrown.
+vector<SHA1FileResult> sha1Files(const vector<string>& paths, SHA1FileMode mode = SHA1FileMode::Auto, unsigned threads = 0);
+
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef SHA1_KERNELS_H
+#define SHA1_KERNELS_H
+
+#include <cstdint>
+#include <cstddef>
+
+// SHA-NI compression of count consecutive 64 byte blocks into H[0..4]. SHA1_shani.cpp is compiled with -msha -msse4.1; without
+// those flags it is a stub that returns 0 and the caller falls back to SHA1::processBlock.
+size_t sha1ShaniCompress(uint32_t* H, const uint8_t* blocks, size_t count);
+
+// AVX2 SHA1 of 8 independent messages at once (SHA1_avx2.cpp, -mavx2): count consecutive 64 byte blocks from each lanes[l],
+// with the hash values transposed as state[8 * word + lane]. Returns count; the stub returns 0.
+size_t sha1Avx2MultiBuffer(uint32_t* state, const uint8_t* const* lanes, size_t count);
+
+// AVX2 PBKDF2-HMAC-SHA1 iterations in 8 independent lanes (SHA1_avx2.cpp, -mavx2). Every array holds five words per lane,
+// transposed as x[8 * word + lane]: the inner and outer HMAC midstates, and U and T, which on entry hold U_1 and on return
+// U_(iterations + 1) and T = U_1 ^ ... ^ U_(iterations + 1). Returns the number of lanes processed; the stub returns 0.
+size_t sha1Avx2Pbkdf2(const uint32_t* inner, const uint32_t* outer, uint32_t* U, uint32_t* T, uint32_t iterations);
+
+#endif
@@ -0,0 +1,198 @@
+#include "SHA1Tree.h"
+#include "../Common/HexCodec.h"
+#include "../Common/Parallel.h"
+#include "../Common/PerfCounters.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+static const uint8_t LeafPrefix = 0x00;
+static const uint8_t NodePrefix = 0x01;
+
+
+SHA1Tree::SHA1Tree(size_t leafSize, size_t fanOut)
+{
+    if(leafSize == 0 || fanOut < 2)
+    {
+        throw invalid_argument("SHA1Tree needs a leaf size above 0 and a fan-out of at least 2");
+    }
+
+    this->leafBytes = leafSize;
+    this->fan = fanOut;
+    this->objectLength = 0;
+}
+
+
+// sizes every level for an object of length bytes; existing digests below the new sizes are kept
+void SHA1Tree::resize(size_t length)
+{
+    this->objectLength = length;
+
+    size_t nodes = max<size_t>(1, (length + this->leafBytes - 1) / this->leafBytes); // an empty object is one empty leaf
+    size_t height = 0;
+
+    while(true)
+    {
+        if(this->levels.size() <= height)
+        {
+            this->levels.emplace_back();
+        }
+        this->levels[height].resize(nodes * SHA1::DigestSize);
+        height++;
+
+        if(nodes == 1)
+        {
+            break;
+        }
+        nodes = (nodes + this->fan - 1) / this->fan;
+    }
+
+    this->levels.resize(height);
+}
+
+
+void SHA1Tree::hashLeaves(const uint8_t* data, const vector<size_t>& leaves, unsigned threads)
+{
+    PERF_BATCH_SCOPE("SHA1Tree::hashLeaves", leaves.size());
+
+    parallelFor(leaves.size(), threads, [&](size_t i)
+    {
+        size_t leaf = leaves[i];
+        size_t offset = leaf * this->leafBytes;
+        size_t length = min(this->leafBytes, this->objectLength - offset);
+
+        SHA1 sha1;
+        sha1.update(&LeafPrefix, 1);
+        sha1.update(data + offset, length);
+        sha1.finalize(&this->levels[0][leaf * SHA1::DigestSize]);
+    });
+}
+
+
+// hashes the given nodes of level from their children in level - 1
+void SHA1Tree::hashParents(size_t level, const vector<size_t>& nodes, unsigned threads)
+{
+    const vector<uint8_t>& children = this->levels[level - 1];
+    size_t childCount = children.size() / SHA1::DigestSize;
+
+    // interior nodes are small, so only spread wide levels across threads
+    if(nodes.size() < 64)
+    {
+        threads = 1;
+    }
+
+    parallelFor(nodes.size(), threads, [&](size_t i)
+    {
+        size_t node = nodes[i];
+        size_t first = node * this->fan;
+        size_t count = min(this->fan, childCount - first);
+
+        SHA1 sha1;
+        sha1.update(&NodePrefix, 1);
+        sha1.update(&children[first * SHA1::DigestSize], count * SHA1::DigestSize);
+        sha1.finalize(&this->levels[level][node * SHA1::DigestSize]);
+    });
+}
+
+
+void SHA1Tree::build(const uint8_t* data, size_t length, unsigned threads)
+{
+    PERF_SCOPE("SHA1Tree::build");
+
+    this->levels.clear();
+    resize(length);
+
+    for(size_t level = 0; level < this->levels.size(); level++)
+    {
+        vector<size_t> nodes(this->levels[level].size() / SHA1::DigestSize);
+        for(size_t i = 0; i < nodes.size(); i++)
+        {
+            nodes[i] = i;
+        }
+
+        if(level == 0)
+        {
+            hashLeaves(data, nodes, threads);
+        }
+        else
+        {
+            hashParents(level, nodes, threads);
+        }
+    }
+}
+
+
+void SHA1Tree::update(const uint8_t* data, size_t length, size_t offset, size_t changed, unsigned threads)
+{
+    PERF_SCOPE("SHA1Tree::update");
+
+    if(this->levels.empty())
+    {
+        build(data, length, threads);
+        return;
+    }
+
+    size_t end = offset + changed;
+    if(length != this->objectLength)
+    {
+        // everything from the first change or the old end onwards is dirty, and the right edge of every level changes
+        offset = min(offset, this->objectLength);
+        end = max(length, offset + 1);
+    }
+    else if(changed == 0)
+    {
+        return;
+    }
+    resize(length);
+
+    size_t leaves = this->levels[0].size() / SHA1::DigestSize;
+    size_t firstLeaf = min(offset / this->leafBytes, leaves - 1);
+    size_t lastLeaf = min((end - 1) / this->leafBytes, leaves - 1);
+
+    vector<size_t> dirty;
+    for(size_t leaf = firstLeaf; leaf <= lastLeaf; leaf++)
+    {
+        dirty.push_back(leaf);
+    }
+    hashLeaves(data, dirty, threads);
+
+    // walk up: the parents of the dirty nodes are dirty; dirty is sorted, so duplicates are adjacent
+    for(size_t level = 1; level < this->levels.size(); level++)
+    {
+        for(size_t& node : dirty)
+        {
+            node /= this->fan;
+        }
+        dirty.erase(unique(dirty.begin(), dirty.end()), dirty.end());
+        hashParents(level, dirty, threads);
+    }
+}
+
+
+void SHA1Tree::rootDigest(uint8_t* root) const
+{
+    if(this->levels.empty())
+    {
+        throw logic_error("SHA1Tree has not been built");
+    }
+
+    copy(this->levels.back().begin(), this->levels.back().end(), root);
+}
+
+
+string SHA1Tree::getHash() const
+{
+    uint8_t root[SHA1::DigestSize];
+    rootDigest(root);
+
+    return hexEncode(root, sizeof(root));
+}
+
+
+void SHA1Tree::digest(const uint8_t* data, size_t length, uint8_t* root, size_t leafSize, size_t fanOut, unsigned threads)
+{
+    SHA1Tree tree(leafSize, fanOut);
+    tree.build(data, length, threads);
+    tree.rootDigest(root);
+}
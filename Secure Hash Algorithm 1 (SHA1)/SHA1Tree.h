@@ -0,0 +1,63 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file declares a chunked (Merkle tree) digest over SHA1. A single SHA1 chain is serial; here the object
+ *                  is cut into fixed-size leaves that are hashed in parallel, and each interior node hashes the digests of up
+ *                  to fanOut children, level by level, up to a single root. The tree is kept, so when the object is modified
+ *                  in place only the changed leaves and their ancestors are hashed again.
+ *
+ *                  Leaves are hashed as SHA1(0x00 || leaf) and interior nodes as SHA1(0x01 || child digests), so a leaf can
+ *                  never be passed off as an interior node. A tree with one leaf has that leaf's hash as its root. The root is
+ *                  therefore not the plain SHA1 of the object; it depends on the leaf size and fan-out as well as the data.
+*/
+
+#ifndef SHA1_TREE_H
+#define SHA1_TREE_H
+
+#include "SHA1.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class SHA1Tree
+{
+    public:
+        SHA1Tree(size_t leafSize = 1 << 20, size_t fanOut = 2); // throws invalid_argument for leafSize 0 or fanOut < 2
+
+        // hashes the whole object, using up to threads threads (0 = one per core)
+        void build(const uint8_t* data, size_t length, unsigned threads = 0);
+
+        // the object (now length bytes) was modified in place in [offset, offset + changed); hashes only the affected
+        // leaves and their ancestors. A change in length re-hashes the leaves from the old or new end, whichever is first.
+        void update(const uint8_t* data, size_t length, size_t offset, size_t changed, unsigned threads = 0);
+
+        void rootDigest(uint8_t*) const; // writes the 20 byte root
+        string getHash() const; // the root in hex
+
+        size_t leafSize() const { return leafBytes; }
+        size_t fanOut() const { return fan; }
+        size_t leafCount() const { return levels.empty() ? 0 : levels[0].size() / SHA1::DigestSize; }
+        size_t height() const { return levels.size(); } // number of levels including the leaves and the root
+
+        // one-shot root of data
+        static void digest(const uint8_t* data, size_t length, uint8_t* root, size_t leafSize = 1 << 20, size_t fanOut = 2, unsigned threads = 0);
+
+    private:
+        size_t leafBytes;
+        size_t fan;
+        size_t objectLength;
+        vector<vector<uint8_t>> levels; // levels[0] holds the leaf digests, levels.back() the root; 20 bytes per node
+
+        void hashLeaves(const uint8_t* data, const vector<size_t>& leaves, unsigned threads);
+        void hashParents(size_t level, const vector<size_t>& nodes, unsigned threads);
+        void resize(size_t length);
+
+};
+
+
+#endif
@@ -0,0 +1,209 @@
+#include "SHA1Kernels.h"
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+
+template<int N>
+static inline __m256i ROTL(__m256i x)
+{
+    return _mm256_or_si256(_mm256_slli_epi32(x, N), _mm256_srli_epi32(x, 32 - N));
+}
+
+
+/* Function: compress
+ * Parameters: The hash values of 8 lanes, the 16 message words of each lane's block
+ * Return: None
+ * Description: SHA1 compression of one block in every lane, with the same rounds as SHA1::processBlock
+*/
+static inline void compress(__m256i* H, const __m256i* M)
+{
+    const __m256i K[4] =
+    {
+        _mm256_set1_epi32(0x5A827999),
+        _mm256_set1_epi32(0x6ED9EBA1),
+        _mm256_set1_epi32(static_cast<int>( 0x8F1BBCDC )),
+        _mm256_set1_epi32(static_cast<int>( 0xCA62C1D6 ))
+    };
+
+    __m256i W[16];
+    for(int t = 0; t < 16; t++)
+    {
+        W[t] = M[t];
+    }
+
+    __m256i a = H[0], b = H[1], c = H[2], d = H[3], e = H[4];
+
+    // fully unrolled, so the round function choice and the ring indices are resolved at compile time and W lives in registers
+    #pragma GCC unroll 80
+    for(int t = 0; t < 80; t++)
+    {
+        if(t >= 16)
+        {
+            W[t % 16] = ROTL<1>(_mm256_xor_si256(_mm256_xor_si256(W[(t - 3) % 16], W[(t - 8) % 16]),
+                                                 _mm256_xor_si256(W[(t - 14) % 16], W[t % 16])));
+        }
+
+        __m256i f;
+        if(t < 20)
+        {
+            f = _mm256_xor_si256(_mm256_and_si256(b, c), _mm256_andnot_si256(b, d)); // Ch
+        }
+        else if(t < 40 || t >= 60)
+        {
+            f = _mm256_xor_si256(_mm256_xor_si256(b, c), d); // Parity
+        }
+        else
+        {
+            f = _mm256_or_si256(_mm256_and_si256(b, c), _mm256_and_si256(d, _mm256_or_si256(b, c))); // Maj
+        }
+
+        __m256i T = _mm256_add_epi32(_mm256_add_epi32(ROTL<5>(a), f), _mm256_add_epi32(_mm256_add_epi32(e, K[t / 20]), W[t % 16]));
+        e = d;
+        d = c;
+        c = ROTL<30>(b);
+        b = a;
+        a = T;
+    }
+
+    H[0] = _mm256_add_epi32(H[0], a);
+    H[1] = _mm256_add_epi32(H[1], b);
+    H[2] = _mm256_add_epi32(H[2], c);
+    H[3] = _mm256_add_epi32(H[3], d);
+    H[4] = _mm256_add_epi32(H[4], e);
+}
+
+
+// the 16 big-endian message words of the 64 byte block at lanes[l] + offset, word t of every lane in M[t]: an 8x8 transpose of
+// each half block
+static inline void transpose(const uint8_t* const* lanes, size_t offset, __m256i* M)
+{
+    const __m256i byteSwap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                              3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+    for(int half = 0; half < 2; half++)
+    {
+        __m256i r[8];
+        for(int l = 0; l < 8; l++)
+        {
+            r[l] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes[l] + offset + 32 * half));
+        }
+
+        __m256i t[8];
+        for(int p = 0; p < 4; p++)
+        {
+            t[2 * p] = _mm256_unpacklo_epi32(r[2 * p], r[2 * p + 1]);
+            t[2 * p + 1] = _mm256_unpackhi_epi32(r[2 * p], r[2 * p + 1]);
+        }
+
+        __m256i u[8];
+        for(int q = 0; q < 2; q++)
+        {
+            u[4 * q] = _mm256_unpacklo_epi64(t[4 * q], t[4 * q + 2]);
+            u[4 * q + 1] = _mm256_unpackhi_epi64(t[4 * q], t[4 * q + 2]);
+            u[4 * q + 2] = _mm256_unpacklo_epi64(t[4 * q + 1], t[4 * q + 3]);
+            u[4 * q + 3] = _mm256_unpackhi_epi64(t[4 * q + 1], t[4 * q + 3]);
+        }
+
+        for(int i = 0; i < 4; i++)
+        {
+            M[8 * half + i] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u[i], u[4 + i], 0x20), byteSwap);
+            M[8 * half + 4 + i] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u[i], u[4 + i], 0x31), byteSwap);
+        }
+    }
+}
+
+
+size_t sha1Avx2MultiBuffer(uint32_t* state, const uint8_t* const* lanes, size_t count)
+{
+    __m256i H[5];
+    for(int i = 0; i < 5; i++)
+    {
+        H[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + 8 * i));
+    }
+
+    for(size_t n = 0; n < count; n++)
+    {
+        __m256i M[16];
+        transpose(lanes, 64 * n, M);
+        compress(H, M);
+    }
+
+    for(int i = 0; i < 5; i++)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + 8 * i), H[i]);
+    }
+
+    return count;
+}
+
+
+size_t sha1Avx2Pbkdf2(const uint32_t* inner, const uint32_t* outer, uint32_t* U, uint32_t* T, uint32_t iterations)
+{
+    __m256i innerState[5], outerState[5], u[5], t[5];
+    for(int i = 0; i < 5; i++)
+    {
+        innerState[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inner + 8 * i));
+        outerState[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(outer + 8 * i));
+        u[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(U + 8 * i));
+        t[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(T + 8 * i));
+    }
+
+    // every block hashed here is a 20 byte digest after a 64 byte key block: the digest, a '1' bit, zeros, 672 bits of length
+    __m256i M[16];
+    M[5] = _mm256_set1_epi32(static_cast<int>( 0x80000000 ));
+    for(int i = 6; i < 15; i++)
+    {
+        M[i] = _mm256_setzero_si256();
+    }
+    M[15] = _mm256_set1_epi32((64 + 20) * 8);
+
+    for(uint32_t n = 0; n < iterations; n++)
+    {
+        __m256i h[5];
+
+        // inner hash: H(K ^ ipad || U)
+        for(int i = 0; i < 5; i++)
+        {
+            M[i] = u[i];
+            h[i] = innerState[i];
+        }
+        compress(h, M);
+
+        // outer hash: H(K ^ opad || inner)
+        for(int i = 0; i < 5; i++)
+        {
+            M[i] = h[i];
+            u[i] = outerState[i];
+        }
+        compress(u, M);
+
+        for(int i = 0; i < 5; i++)
+        {
+            t[i] = _mm256_xor_si256(t[i], u[i]);
+        }
+    }
+
+    for(int i = 0; i < 5; i++)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(U + 8 * i), u[i]);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(T + 8 * i), t[i]);
+    }
+
+    return 8;
+}
+
+#else
+
+size_t sha1Avx2MultiBuffer(uint32_t*, const uint8_t* const*, size_t)
+{
+    return 0;
+}
+
+size_t sha1Avx2Pbkdf2(const uint32_t*, const uint32_t*, uint32_t*, uint32_t*, uint32_t)
+{
+    return 0;
+}
+
+#endif
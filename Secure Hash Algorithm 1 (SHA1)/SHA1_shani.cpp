@@ -0,0 +1,87 @@
+#include "SHA1Kernels.h"
+
+#if defined(__SHA__) && defined(__SSE4_1__)
+
+#include <immintrin.h>
+
+
+// four rounds with the round function and constant selected by F (0 = Ch, 1 = Parity, 2 = Maj, 3 = Parity)
+template<int F>
+static inline void fourRounds(__m128i& ABCD, __m128i& previous, __m128i E)
+{
+    previous = ABCD;
+    ABCD = _mm_sha1rnds4_epu32(ABCD, E, F);
+}
+
+
+size_t sha1ShaniCompress(uint32_t* H, const uint8_t* blocks, size_t count)
+{
+    // the message words are big-endian; ABCD is held with A in the most significant lane and E in the top lane of its own register
+    const __m128i byteSwap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    __m128i ABCD = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(H)), 0x1B);
+    __m128i E0 = _mm_set_epi32(static_cast<int>( H[4] ), 0, 0, 0);
+
+    for(size_t n = 0; n < count; n++)
+    {
+        const uint8_t* block = blocks + 64 * n;
+        __m128i ABCD_SAVE = ABCD;
+        __m128i E0_SAVE = E0;
+
+        // W holds the last four groups of four message schedule words
+        __m128i W[4];
+        for(int i = 0; i < 4; i++)
+        {
+            W[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i)), byteSwap);
+        }
+
+        __m128i previous;
+        fourRounds<0>(ABCD, previous, _mm_add_epi32(E0, W[0]));
+
+        // group g covers rounds 4g .. 4g+3; from g = 4 on, W[g] = SHA1MSG2(SHA1MSG1(W[g-4], W[g-3]) ^ W[g-2], W[g-1])
+        auto group = [&](int g) -> __m128i
+        {
+            if(g >= 4)
+            {
+                W[g % 4] = _mm_sha1msg2_epu32(_mm_xor_si128(_mm_sha1msg1_epu32(W[g % 4], W[(g + 1) % 4]), W[(g + 2) % 4]),
+                                              W[(g + 3) % 4]);
+            }
+            return _mm_sha1nexte_epu32(previous, W[g % 4]);
+        };
+
+        for(int g = 1; g < 5; g++)
+        {
+            fourRounds<0>(ABCD, previous, group(g));
+        }
+        for(int g = 5; g < 10; g++)
+        {
+            fourRounds<1>(ABCD, previous, group(g));
+        }
+        for(int g = 10; g < 15; g++)
+        {
+            fourRounds<2>(ABCD, previous, group(g));
+        }
+        for(int g = 15; g < 20; g++)
+        {
+            fourRounds<3>(ABCD, previous, group(g));
+        }
+
+        // add the compressed chunk to the current hash value
+        E0 = _mm_sha1nexte_epu32(previous, E0_SAVE);
+        ABCD = _mm_add_epi32(ABCD, ABCD_SAVE);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(H), _mm_shuffle_epi32(ABCD, 0x1B));
+    H[4] = static_cast<uint32_t>( _mm_extract_epi32(E0, 3) );
+
+    return count;
+}
+
+#else
+
+size_t sha1ShaniCompress(uint32_t*, const uint8_t*, size_t)
+{
+    return 0;
+}
+
+#endif
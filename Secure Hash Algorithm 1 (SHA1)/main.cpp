@@ -1,6 +1,10 @@
 #include <iostream>
 #include "SHA1.h"
+#include "HMACSHA1.h"
+#include "../Common/HexCodec.h"
+#include "../Common/PerfCounters.h"
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -16,6 +20,68 @@ int main()
     cout << sha1.digest("SHA-1 is no longer considered a secure hashing algorithm.") << endl;
     cout << sha1.digest("SHA-2 or SHA-3 should be used in place of SHA-1.") << endl;
     cout << sha1.digest("Never roll your own crypto!") << endl;
+
+    // RFC 2202 test case 2 and RFC 6070 test case 3
+    uint8_t tag[HMACSHA1::DigestSize];
+    const string message = "what do ya want for nothing?";
+    HMACSHA1(reinterpret_cast<const uint8_t*>("Jefe"), 4).mac(reinterpret_cast<const uint8_t*>(message.data()), message.length(), tag);
+    cout << endl << "HMAC-SHA1:    " << hexEncode(tag, sizeof(tag)) << endl;
+
+    uint8_t key[20];
+    pbkdf2HmacSha1(reinterpret_cast<const uint8_t*>("password"), 8, reinterpret_cast<const uint8_t*>("salt"), 4, 4096, key, sizeof(key));
+    cout << "PBKDF2-SHA1:  " << hexEncode(key, sizeof(key)) << endl;
+
+    // 100 messages of 0 to 297 bytes through the multi-buffer path, checked against one at a time, and a batch verify with
+    // three forged tags: one byte off at the front, at the back and in the second bitmask word
+    vector<vector<uint8_t>> messages(100);
+    vector<const uint8_t*> pointers;
+    vector<size_t> lengths;
+    for(size_t i = 0; i < messages.size(); i++)
+    {
+        for(size_t n = 0; n < 3 * i; n++)
+        {
+            messages[i].push_back(static_cast<uint8_t>( i * 31 + n * 7 ));
+        }
+        pointers.push_back(messages[i].data());
+        lengths.push_back(messages[i].size());
+    }
+
+    vector<uint8_t> digests(messages.size() * SHA1::DigestSize);
+    SHA1::digestMany(pointers.data(), lengths.data(), messages.size(), digests.data());
+    size_t matching = 0;
+    for(size_t i = 0; i < messages.size(); i++)
+    {
+        uint8_t one[SHA1::DigestSize];
+        sha1.digest(messages[i].data(), messages[i].size(), one);
+        matching += sha1DigestsEqual(one, digests.data() + SHA1::DigestSize * i) ? 1 : 0;
+    }
+    cout << "digestMany:   " << matching << " of " << messages.size() << " match" << endl;
+
+    HMACSHA1 hmac(reinterpret_cast<const uint8_t*>("Jefe"), 4);
+    vector<uint8_t> tags(messages.size() * HMACSHA1::DigestSize);
+    vector<const uint8_t*> tagPointers;
+    for(size_t i = 0; i < messages.size(); i++)
+    {
+        hmac.mac(pointers[i], lengths[i], tags.data() + HMACSHA1::DigestSize * i);
+        tagPointers.push_back(tags.data() + HMACSHA1::DigestSize * i);
+    }
+    tags[HMACSHA1::DigestSize * 5] ^= 0x01;
+    tags[HMACSHA1::DigestSize * 63 + 19] ^= 0x80;
+    tags[HMACSHA1::DigestSize * 64 + 10] ^= 0x10;
+
+    uint64_t valid[2];
+    hmac.verifyMany(pointers.data(), lengths.data(), tagPointers.data(), messages.size(), valid);
+    cout << "HMAC verify:  rejected";
+    for(size_t i = 0; i < messages.size(); i++)
+    {
+        if(!(valid[i / 64] >> (i % 64) & 1))
+        {
+            cout << " " << i;
+        }
+    }
+    cout << (hmac.verify(pointers[0], lengths[0], tagPointers[0]) && !hmac.verify(pointers[5], lengths[5], tagPointers[5]) ? ", single ok" : ", single FAILED") << endl;
+
+    PERF_REPORT(cout); // only when built with -DCRYPTO_PERF_COUNTERS
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,95 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This program prints the SHA1 digest of each file in the same format as coreutils sha1sum. Files are hashed
+ *                  concurrently, one per thread, without ever being read into memory whole (see SHA1File.h).
+ *
+ * Usage:           ./sha1sum [options] [file...]      (no file or "-" reads standard input)
+ *                      --mmap          map the files (default for regular files)
+ *                      --read          double-buffered reads through the page cache
+ *                      --direct        double-buffered O_DIRECT reads
+ *                      -j <n>          hash at most n files at a time (default: one per core)
+ *                      --stats         print the total size, time and throughput to standard error
+*/
+
+#include "SHA1File.h"
+#include "../Common/HexCodec.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+int main(int argc, char** argv)
+{
+    SHA1FileMode mode = SHA1FileMode::Auto;
+    unsigned threads = 0;
+    bool stats = false;
+    vector<string> paths;
+
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if(arg == "--mmap")
+        {
+            mode = SHA1FileMode::Mapped;
+        }
+        else if(arg == "--read")
+        {
+            mode = SHA1FileMode::Buffered;
+        }
+        else if(arg == "--direct")
+        {
+            mode = SHA1FileMode::Direct;
+        }
+        else if(arg == "-j" && i + 1 < argc)
+        {
+            threads = static_cast<unsigned>( stoul(argv[++i]) );
+        }
+        else if(arg == "--stats")
+        {
+            stats = true;
+        }
+        else if(arg.size() > 1 && arg[0] == '-')
+        {
+            cerr << "usage: " << argv[0] << " [--mmap | --read | --direct] [-j <n>] [--stats] [file...]" << endl;
+            return 1;
+        }
+        else
+        {
+            paths.push_back(arg);
+        }
+    }
+    if(paths.empty())
+    {
+        paths.push_back("-");
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<SHA1FileResult> results = sha1Files(paths, mode, threads);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    int status = 0;
+    uint64_t total = 0;
+    for(const SHA1FileResult& result : results)
+    {
+        if(!result.error.empty())
+        {
+            cerr << argv[0] << ": " << result.error << endl;
+            status = 1;
+            continue;
+        }
+        cout << hexEncode(result.digest, sizeof(result.digest)) << "  " << result.path << "\n";
+        total += result.bytes;
+    }
+    cout.flush();
+
+    if(stats)
+    {
+        cerr << results.size() << " files, " << total << " bytes in " << seconds << " s: " << (total / 1e9) / seconds << " GB/s" << endl;
+    }
+
+    return status;
+}
@@ -0,0 +1,314 @@
+#include "SHA2.h"
+#include "SHA2Kernels.h"
+#include "SHA2Rounds.h"
+#include "../Common/CpuFeatures.h"
+#include "../Common/PerfCounters.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+// portable compression of count consecutive blocks
+template<typename Traits>
+CRYPTO_MULTIVERSION
+static void compressPortable(typename Traits::Word* H, const uint8_t* blocks, size_t count)
+{
+    typename Traits::Word WK[Traits::Rounds];
+
+    for(size_t n = 0; n < count; n++)
+    {
+        sha2Schedule<Traits>(blocks + Traits::BlockBytes * n, WK);
+        sha2Rounds<Traits>(H, WK);
+    }
+}
+
+
+
+
+void sha256Compress(uint32_t* H, const uint8_t* blocks, size_t count)
+{
+    const CpuFeatures& cpu = cpuFeatures();
+
+    if(cpu.sha && cpu.sse41)
+    {
+        PERF_BATCH_SCOPE("sha256Compress(SHA-NI)", count);
+
+        size_t done = sha256ShaniCompress(H, blocks, count);
+        blocks += 64 * done;
+        count -= done;
+    }
+    else if(cpu.avx2)
+    {
+        PERF_BATCH_SCOPE("sha256Compress(AVX2)", count);
+
+        size_t done = sha256Avx2Compress(H, blocks, count);
+        blocks += 64 * done;
+        count -= done;
+    }
+
+    if(count > 0)
+    {
+        PERF_BATCH_SCOPE("sha256Compress", count);
+        compressPortable<SHA256Traits>(H, blocks, count);
+    }
+}
+
+
+
+
+void sha512Compress(uint64_t* H, const uint8_t* blocks, size_t count)
+{
+    if(cpuFeatures().avx2)
+    {
+        PERF_BATCH_SCOPE("sha512Compress(AVX2)", count);
+
+        size_t done = sha512Avx2Compress(H, blocks, count);
+        blocks += 128 * done;
+        count -= done;
+    }
+
+    if(count > 0)
+    {
+        PERF_BATCH_SCOPE("sha512Compress", count);
+        compressPortable<SHA512Traits>(H, blocks, count);
+    }
+}
+
+
+
+
+/* Function: digestMany
+ * Parameters: The initial hash value, the digest length, the messages and their lengths, the message count, the output, the
+ *             multi-buffer kernel and the single message compression function
+ * Return: None
+ * Description: Keeps Lanes messages in flight, one per kernel lane. Each lane walks its message's whole blocks in place and then
+ *              one or two padded tail blocks built here. Every kernel call runs as many blocks as the shortest remaining run in
+ *              any lane; a lane that finishes is refilled with the next message straight away, and lanes left without a message
+ *              shadow an active lane so the kernel always has valid input. The last message still in flight is finished on its
+ *              own, since the kernel would waste every other lane on it.
+*/
+template<typename Traits, size_t Lanes, size_t LengthBytes>
+static void digestMany(const typename Traits::Word* iv, size_t digestBytes, const uint8_t* const* messages, const size_t* lengths,
+                       size_t count, uint8_t* digests,
+                       size_t (*kernel)(typename Traits::Word*, const uint8_t* const*, size_t),
+                       void (*compress)(typename Traits::Word*, const uint8_t*, size_t))
+{
+    typedef typename Traits::Word Word;
+    const size_t B = Traits::BlockBytes;
+
+    struct Lane
+    {
+        bool active;
+        size_t message;
+        size_t fullBlocks; // whole blocks read in place from the message
+        size_t totalBlocks; // fullBlocks plus one or two padded tail blocks
+        size_t done; // blocks compressed so far
+        uint8_t tail[2 * B];
+
+        const uint8_t* position(const uint8_t* data) const
+        {
+            return done < fullBlocks ? data + B * done : tail + B * (done - fullBlocks);
+        }
+
+        size_t run() const // blocks left before the next switch between message and tail
+        {
+            return done < fullBlocks ? fullBlocks - done : totalBlocks - done;
+        }
+    };
+
+    Lane lanes[Lanes];
+    Word state[8 * Lanes];
+    size_t next = 0;
+
+    auto assign = [&](size_t l)
+    {
+        Lane& lane = lanes[l];
+        lane.active = next < count;
+        if(!lane.active)
+        {
+            return;
+        }
+
+        lane.message = next++;
+        size_t length = lengths[lane.message];
+        size_t remainder = length % B;
+
+        lane.fullBlocks = length / B;
+        lane.done = 0;
+
+        // the padding of MerkleDamgard::finishStream: a '1' bit, zeros, then the length in bits
+        size_t tailBlocks = remainder + 1 + LengthBytes > B ? 2 : 1;
+        lane.totalBlocks = lane.fullBlocks + tailBlocks;
+        memset(lane.tail, 0, sizeof(lane.tail));
+        memcpy(lane.tail, messages[lane.message] + B * lane.fullBlocks, remainder);
+        lane.tail[remainder] = 0x80;
+
+        uint8_t* end = lane.tail + B * tailBlocks;
+        uint64_t bits = static_cast<uint64_t>( length ) << 3;
+        for(int i = 0; i < 8; i++)
+        {
+            end[-1 - i] = static_cast<uint8_t>( bits >> (8 * i) );
+        }
+        if(LengthBytes > 8)
+        {
+            end[-9] = static_cast<uint8_t>( static_cast<uint64_t>( length ) >> 61 );
+        }
+
+        for(int w = 0; w < 8; w++)
+        {
+            state[Lanes * w + l] = iv[w];
+        }
+    };
+
+    auto finish = [&](size_t l)
+    {
+        Word H[8];
+        for(int w = 0; w < 8; w++)
+        {
+            H[w] = state[Lanes * w + l];
+        }
+        storeBigEndian(H, digestBytes, digests + digestBytes * lanes[l].message);
+    };
+
+    for(size_t l = 0; l < Lanes; l++)
+    {
+        assign(l);
+    }
+
+    while(true)
+    {
+        size_t active = 0;
+        size_t first = 0;
+        size_t run = SIZE_MAX;
+        for(size_t l = Lanes; l-- > 0; )
+        {
+            if(lanes[l].active)
+            {
+                active++;
+                first = l;
+                run = min(run, lanes[l].run());
+            }
+        }
+
+        if(active == 0)
+        {
+            return;
+        }
+
+        if(active == 1)
+        {
+            // no messages left to refill the other lanes; finish the last one with the single message code
+            Lane& lane = lanes[first];
+            Word H[8];
+            for(int w = 0; w < 8; w++)
+            {
+                H[w] = state[Lanes * w + first];
+            }
+            const uint8_t* data = messages[lane.message];
+            if(lane.done < lane.fullBlocks)
+            {
+                compress(H, data + B * lane.done, lane.fullBlocks - lane.done);
+                lane.done = lane.fullBlocks;
+            }
+            compress(H, lane.tail + B * (lane.done - lane.fullBlocks), lane.totalBlocks - lane.done);
+            storeBigEndian(H, digestBytes, digests + digestBytes * lane.message);
+            return;
+        }
+
+        const uint8_t* pointers[Lanes];
+        for(size_t l = 0; l < Lanes; l++)
+        {
+            size_t source = lanes[l].active ? l : first;
+            pointers[l] = lanes[source].position(messages[lanes[source].message]);
+        }
+
+        kernel(state, pointers, run);
+
+        for(size_t l = 0; l < Lanes; l++)
+        {
+            if(!lanes[l].active)
+            {
+                continue;
+            }
+
+            lanes[l].done += run;
+            if(lanes[l].done == lanes[l].totalBlocks)
+            {
+                finish(l);
+                assign(l);
+            }
+        }
+    }
+}
+
+
+// one message at a time through the streaming interface's compression function
+template<typename Word, size_t BlockBytes, size_t LengthBytes>
+static void digestEach(const Word* iv, size_t digestBytes, const uint8_t* const* messages, const size_t* lengths, size_t count,
+                       uint8_t* digests, void (*compress)(Word*, const uint8_t*, size_t))
+{
+    for(size_t i = 0; i < count; i++)
+    {
+        Word H[8];
+        copy(iv, iv + 8, H);
+
+        size_t length = lengths[i];
+        compress(H, messages[i], length / BlockBytes);
+
+        size_t remainder = length % BlockBytes;
+        uint8_t tail[2 * BlockBytes] = {};
+        memcpy(tail, messages[i] + length - remainder, remainder);
+        tail[remainder] = 0x80;
+
+        size_t tailBlocks = remainder + 1 + LengthBytes > BlockBytes ? 2 : 1;
+        uint8_t* end = tail + BlockBytes * tailBlocks;
+        uint64_t bits = static_cast<uint64_t>( length ) << 3;
+        for(int b = 0; b < 8; b++)
+        {
+            end[-1 - b] = static_cast<uint8_t>( bits >> (8 * b) );
+        }
+        if(LengthBytes > 8)
+        {
+            end[-9] = static_cast<uint8_t>( static_cast<uint64_t>( length ) >> 61 );
+        }
+
+        compress(H, tail, tailBlocks);
+        storeBigEndian(H, digestBytes, digests + digestBytes * i);
+    }
+}
+
+
+
+
+void sha256DigestMany(const uint32_t* iv, size_t digestBytes, const uint8_t* const* messages, const size_t* lengths, size_t count, uint8_t* digests)
+{
+    PERF_BATCH_SCOPE("sha256DigestMany", count);
+
+    // SHA-NI on one message beats eight AVX2 lanes, so the multi-buffer kernel is only used without it
+    const CpuFeatures& cpu = cpuFeatures();
+    if(cpu.avx2 && !(cpu.sha && cpu.sse41) && count > 1)
+    {
+        digestMany<SHA256Traits, 8, 8>(iv, digestBytes, messages, lengths, count, digests, sha256Avx2MultiBuffer, sha256Compress);
+    }
+    else
+    {
+        digestEach<uint32_t, 64, 8>(iv, digestBytes, messages, lengths, count, digests, sha256Compress);
+    }
+}
+
+
+
+
+void sha512DigestMany(const uint64_t* iv, size_t digestBytes, const uint8_t* const* messages, const size_t* lengths, size_t count, uint8_t* digests)
+{
+    PERF_BATCH_SCOPE("sha512DigestMany", count);
+
+    if(cpuFeatures().avx2 && count > 1)
+    {
+        digestMany<SHA512Traits, 4, 16>(iv, digestBytes, messages, lengths, count, digests, sha512Avx2MultiBuffer, sha512Compress);
+    }
+    else
+    {
+        digestEach<uint64_t, 128, 16>(iv, digestBytes, messages, lengths, count, digests, sha512Compress);
+    }
+}
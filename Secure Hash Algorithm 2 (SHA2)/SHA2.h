@@ -0,0 +1,153 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file declares SHA-224, SHA-256, SHA-384 and SHA-512 (FIPS 180-4) on the same Merkle-Damgard streaming
+ *                  framework as SHA1. SHA-224/256 share a 32-bit compression function and SHA-384/512 a 64-bit one; the
+ *                  variants differ only in their initial hash value and how much of the final value is output, so each
+ *                  family is one template over the digest size.
+ *
+ *                  The compression functions pick the fastest backend at runtime: SHA-NI for SHA-256, an AVX2 kernel that
+ *                  computes the message schedules of several blocks at once in vector lanes, or the portable code.
+ *                  digestMany() hashes many independent messages together, one message per AVX2 lane.
+*/
+
+#ifndef SHA2_H
+#define SHA2_H
+
+#include "SHA2Tables.h"
+#include "../Common/HexCodec.h"
+#include "../Common/MerkleDamgard.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+// compress count consecutive blocks into H
+void sha256Compress(uint32_t* H, const uint8_t* blocks, size_t count);
+void sha512Compress(uint64_t* H, const uint8_t* blocks, size_t count);
+
+// hash count messages; digest i (digestBytes long) is written to digests + i * digestBytes
+void sha256DigestMany(const uint32_t* iv, size_t digestBytes, const uint8_t* const* messages, const size_t* lengths, size_t count, uint8_t* digests);
+void sha512DigestMany(const uint64_t* iv, size_t digestBytes, const uint8_t* const* messages, const size_t* lengths, size_t count, uint8_t* digests);
+
+// writes the first bytes of the hash value in big-endian order
+template<typename Word>
+inline void storeBigEndian(const Word* H, size_t bytes, uint8_t* out)
+{
+    for(size_t i = 0; i < bytes; i++)
+    {
+        out[i] = static_cast<uint8_t>( H[i / sizeof(Word)] >> (8 * (sizeof(Word) - 1 - i % sizeof(Word))) );
+    }
+}
+
+
+// SHA-224 and SHA-256: 512 bit blocks, 64 bit length field, eight 32-bit words of state
+template<int DigestBits>
+class SHA2_256 : public MerkleDamgard<SHA2_256<DigestBits>, 64, 8>
+{
+    static_assert(DigestBits == 224 || DigestBits == 256, "SHA2_256 supports 224 and 256 bit digests");
+
+    public:
+        static constexpr size_t DigestSize = DigestBits / 8;
+
+        SHA2_256() { reset(); }
+
+        void reset()
+        {
+            const uint32_t* iv = DigestBits == 224 ? SHA2Tables::IV224 : SHA2Tables::IV256;
+            for(int i = 0; i < 8; i++)
+            {
+                this->H[i] = iv[i];
+            }
+            this->resetStream();
+        }
+
+        void processBlocks(const uint8_t* blocks, size_t count) { sha256Compress(this->H, blocks, count); }
+
+        void finalize(uint8_t* digest)
+        {
+            this->finishStream();
+            storeBigEndian(this->H, DigestSize, digest);
+        }
+
+        using MerkleDamgard<SHA2_256<DigestBits>, 64, 8>::digest;
+
+        // the digest of a string in hex, as SHA1::digest(string)
+        string digest(string message)
+        {
+            uint8_t out[DigestSize];
+            digest(reinterpret_cast<const uint8_t*>( message.data() ), message.length(), out);
+            return hexEncode(out, DigestSize);
+        }
+
+        static void digestMany(const uint8_t* const* messages, const size_t* lengths, size_t count, uint8_t* digests)
+        {
+            sha256DigestMany(DigestBits == 224 ? SHA2Tables::IV224 : SHA2Tables::IV256, DigestSize, messages, lengths, count, digests);
+        }
+
+    private:
+        uint32_t H[8];
+
+};
+
+
+// SHA-384 and SHA-512: 1024 bit blocks, 128 bit length field, eight 64-bit words of state
+template<int DigestBits>
+class SHA2_512 : public MerkleDamgard<SHA2_512<DigestBits>, 128, 16>
+{
+    static_assert(DigestBits == 384 || DigestBits == 512, "SHA2_512 supports 384 and 512 bit digests");
+
+    public:
+        static constexpr size_t DigestSize = DigestBits / 8;
+
+        SHA2_512() { reset(); }
+
+        void reset()
+        {
+            const uint64_t* iv = DigestBits == 384 ? SHA2Tables::IV384 : SHA2Tables::IV512;
+            for(int i = 0; i < 8; i++)
+            {
+                this->H[i] = iv[i];
+            }
+            this->resetStream();
+        }
+
+        void processBlocks(const uint8_t* blocks, size_t count) { sha512Compress(this->H, blocks, count); }
+
+        void finalize(uint8_t* digest)
+        {
+            this->finishStream();
+            storeBigEndian(this->H, DigestSize, digest);
+        }
+
+        using MerkleDamgard<SHA2_512<DigestBits>, 128, 16>::digest;
+
+        string digest(string message)
+        {
+            uint8_t out[DigestSize];
+            digest(reinterpret_cast<const uint8_t*>( message.data() ), message.length(), out);
+            return hexEncode(out, DigestSize);
+        }
+
+        static void digestMany(const uint8_t* const* messages, const size_t* lengths, size_t count, uint8_t* digests)
+        {
+            sha512DigestMany(DigestBits == 384 ? SHA2Tables::IV384 : SHA2Tables::IV512, DigestSize, messages, lengths, count, digests);
+        }
+
+    private:
+        uint64_t H[8];
+
+};
+
+
+using SHA224 = SHA2_256<224>;
+using SHA256 = SHA2_256<256>;
+using SHA384 = SHA2_512<384>;
+using SHA512 = SHA2_512<512>;
+
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef SHA2_KERNELS_H
+#define SHA2_KERNELS_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Each kernel returns the number of blocks it processed. A kernel built without its compiler flags is a stub that returns 0,
+// and the caller falls back to the portable code.
+
+// SHA-NI compression of count consecutive 64 byte blocks into H[0..7] (SHA2_shani.cpp, -msha -msse4.1)
+size_t sha256ShaniCompress(uint32_t* H, const uint8_t* blocks, size_t count);
+
+// AVX2 compression of count consecutive blocks (SHA2_avx2.cpp, -mavx2). The message schedules of 8 (SHA-256) or 4 (SHA-512)
+// blocks are computed at once, one block per vector lane, and the rounds then run in scalar registers.
+size_t sha256Avx2Compress(uint32_t* H, const uint8_t* blocks, size_t count);
+size_t sha512Avx2Compress(uint64_t* H, const uint8_t* blocks, size_t count);
+
+// AVX2 multi-buffer compression of independent messages, one per lane: 8 lanes for SHA-256, 4 for SHA-512. The hash values
+// are held transposed, state[lanes * word + lane], and lane l compresses count consecutive blocks starting at lanes[l].
+size_t sha256Avx2MultiBuffer(uint32_t* state, const uint8_t* const* lanes, size_t count);
+size_t sha512Avx2MultiBuffer(uint64_t* state, const uint8_t* const* lanes, size_t count);
+
+#endif
@@ -0,0 +1,131 @@
+/*
+ * Author:          Robert Blaine Wilson
+ *
+ * Date:            10/16/2026
+ *
+ * Synopsis:        This file contains the scalar SHA-2 functions (FIPS 180-4 section 4.1.2 and 4.1.3), written once for both
+ *                  word sizes through a traits class. It is included by the portable code and by the AVX2 kernel, which are
+ *                  compiled with different flags, so every function here is static: each translation unit keeps its own copy.
+*/
+
+#ifndef SHA2_ROUNDS_H
+#define SHA2_ROUNDS_H
+
+#include "SHA2Tables.h"
+
+#include <cstdint>
+#include <cstddef>
+
+struct SHA256Traits
+{
+    typedef uint32_t Word;
+    static constexpr int Rounds = 64;
+    static constexpr size_t BlockBytes = 64;
+    static constexpr int S0[3] = {2, 13, 22}; // upper case sigma 0
+    static constexpr int S1[3] = {6, 11, 25}; // upper case sigma 1
+    static constexpr int s0[3] = {7, 18, 3}; // lower case sigma 0; the last is a shift
+    static constexpr int s1[3] = {17, 19, 10}; // lower case sigma 1
+    static constexpr const uint32_t* K = SHA2Tables::K256;
+};
+
+struct SHA512Traits
+{
+    typedef uint64_t Word;
+    static constexpr int Rounds = 80;
+    static constexpr size_t BlockBytes = 128;
+    static constexpr int S0[3] = {28, 34, 39};
+    static constexpr int S1[3] = {14, 18, 41};
+    static constexpr int s0[3] = {1, 8, 7};
+    static constexpr int s1[3] = {19, 61, 6};
+    static constexpr const uint64_t* K = SHA2Tables::K512;
+};
+
+
+template<typename Word>
+static inline Word ROTR(Word x, int n)
+{
+    return (x >> n) | (x << (8 * sizeof(Word) - n));
+}
+
+template<typename Word>
+static inline Word loadBigEndian(const uint8_t* p)
+{
+    Word w = 0;
+    for(size_t i = 0; i < sizeof(Word); i++)
+    {
+        w = (w << 8) | p[i];
+    }
+    return w;
+}
+
+
+/* Function: sha2Rounds
+ * Parameters: The hash value, the message schedule with the round constants already added (WK[t] = W[t] + K[t])
+ * Return: None
+ * Description: Runs every round of one block and adds the result into the hash value
+*/
+template<typename Traits>
+static inline void sha2Rounds(typename Traits::Word* H, const typename Traits::Word* WK)
+{
+    typedef typename Traits::Word Word;
+
+    Word a = H[0], b = H[1], c = H[2], d = H[3], e = H[4], f = H[5], g = H[6], h = H[7];
+
+    for(int t = 0; t < Traits::Rounds; t++)
+    {
+        Word S1 = ROTR(e, Traits::S1[0]) ^ ROTR(e, Traits::S1[1]) ^ ROTR(e, Traits::S1[2]);
+        Word Ch = (e & f) ^ (~e & g);
+        Word T1 = h + S1 + Ch + WK[t];
+        Word S0 = ROTR(a, Traits::S0[0]) ^ ROTR(a, Traits::S0[1]) ^ ROTR(a, Traits::S0[2]);
+        Word Maj = (a & b) ^ (a & c) ^ (b & c);
+        Word T2 = S0 + Maj;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + T1;
+        d = c;
+        c = b;
+        b = a;
+        a = T1 + T2;
+    }
+
+    H[0] += a;
+    H[1] += b;
+    H[2] += c;
+    H[3] += d;
+    H[4] += e;
+    H[5] += f;
+    H[6] += g;
+    H[7] += h;
+}
+
+
+// prepare the message schedule of one block and add the round constants
+template<typename Traits>
+static inline void sha2Schedule(const uint8_t* block, typename Traits::Word* WK)
+{
+    typedef typename Traits::Word Word;
+    Word W[Traits::Rounds];
+
+    for(int t = 0; t < 16; t++)
+    {
+        W[t] = loadBigEndian<Word>(block + sizeof(Word) * t);
+    }
+    for(int t = 16; t < Traits::Rounds; t++)
+    {
+        Word x = W[t - 15];
+        Word y = W[t - 2];
+        Word s0 = ROTR(x, Traits::s0[0]) ^ ROTR(x, Traits::s0[1]) ^ (x >> Traits::s0[2]);
+        Word s1 = ROTR(y, Traits::s1[0]) ^ ROTR(y, Traits::s1[1]) ^ (y >> Traits::s1[2]);
+        W[t] = s1 + W[t - 7] + s0 + W[t - 16];
+    }
+
+    for(int t = 0; t < Traits::Rounds; t++)
+    {
+        WK[t] = W[t] + Traits::K[t];
+    }
+}
+
+
+#endif
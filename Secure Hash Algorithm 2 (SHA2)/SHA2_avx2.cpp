@@ -0,0 +1,285 @@
+#include "SHA2Kernels.h"
+#include "SHA2Rounds.h"
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+
+// 32-bit lanes: eight SHA-256 blocks or messages per register
+struct Lanes32
+{
+    typedef uint32_t Word;
+    static constexpr size_t Count = 8;
+
+    static __m256i add(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+    static __m256i set1(Word w) { return _mm256_set1_epi32(static_cast<int>( w )); }
+    template<int N> static __m256i rotr(__m256i x) { return _mm256_or_si256(_mm256_srli_epi32(x, N), _mm256_slli_epi32(x, 32 - N)); }
+    template<int N> static __m256i shr(__m256i x) { return _mm256_srli_epi32(x, N); }
+
+    static __m256i byteSwap(__m256i x)
+    {
+        const __m256i mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                              3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        return _mm256_shuffle_epi8(x, mask);
+    }
+
+    // word i of lanes[l] + offset into lane l, as an 8x8 transpose of each half block
+    static void transpose(const uint8_t* const* lanes, size_t offset, __m256i* W)
+    {
+        for(int half = 0; half < 2; half++)
+        {
+            __m256i r[8];
+            for(size_t l = 0; l < Count; l++)
+            {
+                r[l] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes[l] + offset + 32 * half));
+            }
+
+            __m256i t[8];
+            for(int p = 0; p < 4; p++)
+            {
+                t[2 * p] = _mm256_unpacklo_epi32(r[2 * p], r[2 * p + 1]);
+                t[2 * p + 1] = _mm256_unpackhi_epi32(r[2 * p], r[2 * p + 1]);
+            }
+
+            __m256i u[8];
+            for(int q = 0; q < 2; q++)
+            {
+                u[4 * q] = _mm256_unpacklo_epi64(t[4 * q], t[4 * q + 2]);
+                u[4 * q + 1] = _mm256_unpackhi_epi64(t[4 * q], t[4 * q + 2]);
+                u[4 * q + 2] = _mm256_unpacklo_epi64(t[4 * q + 1], t[4 * q + 3]);
+                u[4 * q + 3] = _mm256_unpackhi_epi64(t[4 * q + 1], t[4 * q + 3]);
+            }
+
+            for(int i = 0; i < 4; i++)
+            {
+                W[8 * half + i] = byteSwap(_mm256_permute2x128_si256(u[i], u[4 + i], 0x20));
+                W[8 * half + 4 + i] = byteSwap(_mm256_permute2x128_si256(u[i], u[4 + i], 0x31));
+            }
+        }
+    }
+};
+
+
+// 64-bit lanes: four SHA-512 blocks or messages per register
+struct Lanes64
+{
+    typedef uint64_t Word;
+    static constexpr size_t Count = 4;
+
+    static __m256i add(__m256i a, __m256i b) { return _mm256_add_epi64(a, b); }
+    static __m256i set1(Word w) { return _mm256_set1_epi64x(static_cast<long long>( w )); }
+    template<int N> static __m256i rotr(__m256i x) { return _mm256_or_si256(_mm256_srli_epi64(x, N), _mm256_slli_epi64(x, 64 - N)); }
+    template<int N> static __m256i shr(__m256i x) { return _mm256_srli_epi64(x, N); }
+
+    static __m256i byteSwap(__m256i x)
+    {
+        const __m256i mask = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                              7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+        return _mm256_shuffle_epi8(x, mask);
+    }
+
+    // word i of lanes[l] + offset into lane l, as a 4x4 transpose of each quarter block
+    static void transpose(const uint8_t* const* lanes, size_t offset, __m256i* W)
+    {
+        for(int quarter = 0; quarter < 4; quarter++)
+        {
+            __m256i r[4];
+            for(size_t l = 0; l < Count; l++)
+            {
+                r[l] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes[l] + offset + 32 * quarter));
+            }
+
+            __m256i t0 = _mm256_unpacklo_epi64(r[0], r[1]);
+            __m256i t1 = _mm256_unpackhi_epi64(r[0], r[1]);
+            __m256i t2 = _mm256_unpacklo_epi64(r[2], r[3]);
+            __m256i t3 = _mm256_unpackhi_epi64(r[2], r[3]);
+
+            W[4 * quarter] = byteSwap(_mm256_permute2x128_si256(t0, t2, 0x20));
+            W[4 * quarter + 1] = byteSwap(_mm256_permute2x128_si256(t1, t3, 0x20));
+            W[4 * quarter + 2] = byteSwap(_mm256_permute2x128_si256(t0, t2, 0x31));
+            W[4 * quarter + 3] = byteSwap(_mm256_permute2x128_si256(t1, t3, 0x31));
+        }
+    }
+};
+
+
+template<typename Traits, typename V, const int* R>
+static inline __m256i bigSigma(__m256i x)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(V::template rotr<R[0]>(x), V::template rotr<R[1]>(x)), V::template rotr<R[2]>(x));
+}
+
+template<typename Traits, typename V, const int* R>
+static inline __m256i smallSigma(__m256i x)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(V::template rotr<R[0]>(x), V::template rotr<R[1]>(x)), V::template shr<R[2]>(x));
+}
+
+// W[t] for t >= 16, in the 16 word ring W
+template<typename Traits, typename V>
+static inline __m256i nextWord(__m256i* W, int t)
+{
+    __m256i s0 = smallSigma<Traits, V, Traits::s0>(W[(t - 15) % 16]);
+    __m256i s1 = smallSigma<Traits, V, Traits::s1>(W[(t - 2) % 16]);
+    W[t % 16] = V::add(V::add(s1, W[(t - 7) % 16]), V::add(s0, W[t % 16]));
+    return W[t % 16];
+}
+
+
+/* Function: compressLanes
+ * Parameters: The hash value, count consecutive blocks
+ * Return: The number of blocks processed (all of them)
+ * Description: The message schedule does not depend on the hash value, so the schedules of V::Count blocks are computed
+ *              together, one block per lane, and stored with the round constants added. The rounds, which are a serial chain,
+ *              then run in scalar registers for each block in turn.
+*/
+template<typename Traits, typename V>
+static size_t compressLanes(typename Traits::Word* H, const uint8_t* blocks, size_t count)
+{
+    typedef typename Traits::Word Word;
+    alignas(32) Word WK[Traits::Rounds][V::Count];
+    Word column[Traits::Rounds];
+
+    for(size_t n = 0; n < count; n += V::Count)
+    {
+        size_t group = count - n < V::Count ? count - n : V::Count;
+
+        // lanes past the last block repeat it
+        const uint8_t* lanes[V::Count];
+        for(size_t l = 0; l < V::Count; l++)
+        {
+            lanes[l] = blocks + Traits::BlockBytes * (n + (l < group ? l : group - 1));
+        }
+
+        __m256i W[16];
+        V::transpose(lanes, 0, W);
+
+        for(int t = 0; t < Traits::Rounds; t++)
+        {
+            __m256i w = t < 16 ? W[t] : nextWord<Traits, V>(W, t);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(WK[t]), V::add(w, V::set1(Traits::K[t])));
+        }
+
+        for(size_t l = 0; l < group; l++)
+        {
+            for(int t = 0; t < Traits::Rounds; t++)
+            {
+                column[t] = WK[t][l];
+            }
+            sha2Rounds<Traits>(H, column);
+        }
+    }
+
+    return count;
+}
+
+
+/* Function: multiBuffer
+ * Parameters: The transposed hash values of V::Count messages, a pointer into each message, the number of blocks
+ * Return: The number of blocks processed per lane (all of them)
+ * Description: Every round runs on all lanes at once, each lane being a different message
+*/
+template<typename Traits, typename V>
+static size_t multiBuffer(typename Traits::Word* state, const uint8_t* const* lanes, size_t count)
+{
+    __m256i s[8];
+    for(int i = 0; i < 8; i++)
+    {
+        s[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + V::Count * i));
+    }
+
+    for(size_t n = 0; n < count; n++)
+    {
+        __m256i W[16];
+        V::transpose(lanes, Traits::BlockBytes * n, W);
+
+        __m256i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+
+        for(int t = 0; t < Traits::Rounds; t++)
+        {
+            __m256i w = t < 16 ? W[t] : nextWord<Traits, V>(W, t);
+            __m256i WK = V::add(w, V::set1(Traits::K[t]));
+
+            __m256i Ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+            __m256i T1 = V::add(V::add(h, bigSigma<Traits, V, Traits::S1>(e)), V::add(Ch, WK));
+            __m256i Maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+            __m256i T2 = V::add(bigSigma<Traits, V, Traits::S0>(a), Maj);
+
+            h = g;
+            g = f;
+            f = e;
+            e = V::add(d, T1);
+            d = c;
+            c = b;
+            b = a;
+            a = V::add(T1, T2);
+        }
+
+        s[0] = V::add(s[0], a);
+        s[1] = V::add(s[1], b);
+        s[2] = V::add(s[2], c);
+        s[3] = V::add(s[3], d);
+        s[4] = V::add(s[4], e);
+        s[5] = V::add(s[5], f);
+        s[6] = V::add(s[6], g);
+        s[7] = V::add(s[7], h);
+    }
+
+    for(int i = 0; i < 8; i++)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + V::Count * i), s[i]);
+    }
+
+    return count;
+}
+
+
+
+
+size_t sha256Avx2Compress(uint32_t* H, const uint8_t* blocks, size_t count)
+{
+    return compressLanes<SHA256Traits, Lanes32>(H, blocks, count);
+}
+
+
+size_t sha512Avx2Compress(uint64_t* H, const uint8_t* blocks, size_t count)
+{
+    return compressLanes<SHA512Traits, Lanes64>(H, blocks, count);
+}
+
+
+size_t sha256Avx2MultiBuffer(uint32_t* state, const uint8_t* const* lanes, size_t count)
+{
+    return multiBuffer<SHA256Traits, Lanes32>(state, lanes, count);
+}
+
+
+size_t sha512Avx2MultiBuffer(uint64_t* state, const uint8_t* const* lanes, size_t count)
+{
+    return multiBuffer<SHA512Traits, Lanes64>(state, lanes, count);
+}
+
+#else
+
+size_t sha256Avx2Compress(uint32_t*, const uint8_t*, size_t)
+{
+    return 0;
+}
+
+size_t sha512Avx2Compress(uint64_t*, const uint8_t*, size_t)
+{
+    return 0;
+}
+
+size_t sha256Avx2MultiBuffer(uint32_t*, const uint8_t* const*, size_t)
+{
+    return 0;
+}
+
+size_t sha512Avx2MultiBuffer(uint64_t*, const uint8_t* const*, size_t)
+{
+    return 0;
+}
+
+#endif
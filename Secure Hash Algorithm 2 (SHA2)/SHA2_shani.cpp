@@ -0,0 +1,69 @@
+#include "SHA2Kernels.h"
+#include "SHA2Tables.h"
+
+#if defined(__SHA__) && defined(__SSE4_1__)
+
+#include <immintrin.h>
+
+
+size_t sha256ShaniCompress(uint32_t* H, const uint8_t* blocks, size_t count)
+{
+    // the message words are big-endian
+    const __m128i byteSwap = _mm_set_epi64x(0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL);
+
+    // SHA256RNDS2 wants the state split as ABEF and CDGH, with A and C in the top lanes
+    __m128i DCBA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(H));
+    __m128i HGFE = _mm_loadu_si128(reinterpret_cast<const __m128i*>(H + 4));
+    __m128i CDAB = _mm_shuffle_epi32(DCBA, 0xB1);
+    __m128i EFGH = _mm_shuffle_epi32(HGFE, 0x1B);
+    __m128i ABEF = _mm_alignr_epi8(CDAB, EFGH, 8);
+    __m128i CDGH = _mm_blend_epi16(EFGH, CDAB, 0xF0);
+
+    for(size_t n = 0; n < count; n++)
+    {
+        const uint8_t* block = blocks + 64 * n;
+        __m128i ABEF_SAVE = ABEF;
+        __m128i CDGH_SAVE = CDGH;
+
+        // W holds the last four groups of four message schedule words
+        __m128i W[4];
+
+        // group g covers rounds 4g .. 4g+3; from g = 4 on, W[g] = SHA256MSG2(SHA256MSG1(W[g-4], W[g-3]) + (W[g-2] W[g-1] >> 32), W[g-1])
+        for(int g = 0; g < 16; g++)
+        {
+            if(g < 4)
+            {
+                W[g] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * g)), byteSwap);
+            }
+            else
+            {
+                __m128i W7 = _mm_alignr_epi8(W[(g + 3) % 4], W[(g + 2) % 4], 4);
+                W[g % 4] = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(W[g % 4], W[(g + 1) % 4]), W7), W[(g + 3) % 4]);
+            }
+
+            __m128i WK = _mm_add_epi32(W[g % 4], _mm_loadu_si128(reinterpret_cast<const __m128i*>(SHA2Tables::K256 + 4 * g)));
+            CDGH = _mm_sha256rnds2_epu32(CDGH, ABEF, WK);
+            ABEF = _mm_sha256rnds2_epu32(ABEF, CDGH, _mm_shuffle_epi32(WK, 0x0E));
+        }
+
+        // add the compressed chunk to the current hash value
+        ABEF = _mm_add_epi32(ABEF, ABEF_SAVE);
+        CDGH = _mm_add_epi32(CDGH, CDGH_SAVE);
+    }
+
+    __m128i FEBA = _mm_shuffle_epi32(ABEF, 0x1B);
+    __m128i DCHG = _mm_shuffle_epi32(CDGH, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(H), _mm_blend_epi16(FEBA, DCHG, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(H + 4), _mm_alignr_epi8(DCHG, FEBA, 8));
+
+    return count;
+}
+
+#else
+
+size_t sha256ShaniCompress(uint32_t*, const uint8_t*, size_t)
+{
+    return 0;
+}
+
+#endif
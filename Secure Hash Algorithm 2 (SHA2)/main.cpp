@@ -0,0 +1,58 @@
+#include <iostream>
+#include "SHA2.h"
+#include "../Common/PerfCounters.h"
+#include <string>
+
+using namespace std;
+
+int main()
+{
+    SHA224 sha224;
+    SHA256 sha256;
+    SHA384 sha384;
+    SHA512 sha512;
+
+    cout << "----- SHA-2 -----" << endl << endl;
+
+    // FIPS 180-4 example messages
+    const string messages[] =
+    {
+        "abc",
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+        "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu"
+    };
+
+    for(const string& message : messages)
+    {
+        cout << "\"" << message << "\"" << endl;
+        cout << "SHA-224: " << sha224.digest(message) << endl;
+        cout << "SHA-256: " << sha256.digest(message) << endl;
+        cout << "SHA-384: " << sha384.digest(message) << endl;
+        cout << "SHA-512: " << sha512.digest(message) << endl << endl;
+    }
+
+    // the same messages again, hashed together through the multi-buffer interface
+    const uint8_t* data[3];
+    size_t lengths[3];
+    for(int i = 0; i < 3; i++)
+    {
+        data[i] = reinterpret_cast<const uint8_t*>( messages[i].data() );
+        lengths[i] = messages[i].length();
+    }
+
+    uint8_t digests256[3 * SHA256::DigestSize];
+    uint8_t digests512[3 * SHA512::DigestSize];
+    SHA256::digestMany(data, lengths, 3, digests256);
+    SHA512::digestMany(data, lengths, 3, digests512);
+
+    cout << "MULTI-BUFFER:" << endl;
+    for(int i = 0; i < 3; i++)
+    {
+        cout << "SHA-256: " << hexEncode(digests256 + i * SHA256::DigestSize, SHA256::DigestSize) << endl;
+        cout << "SHA-512: " << hexEncode(digests512 + i * SHA512::DigestSize, SHA512::DigestSize) << endl;
+    }
+
+    PERF_REPORT(cout); // only when built with -DCRYPTO_PERF_COUNTERS
+
+    return 0;
+}